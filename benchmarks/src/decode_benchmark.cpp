@@ -0,0 +1,97 @@
+/*
+	Compares JSON and ETF gateway payload decode times.
+
+	Usage: decode_benchmark <captured payloads> [iterations]
+
+	The capture file should have one raw gateway payload (JSON) per line. Each payload is also encoded to ETF,
+	with snowflake strings converted to 64-bit integers the same way Discord sends them over ETF, so both
+	decoders are timed on the same data.
+*/
+
+#include <discpp/gateway_codec.h>
+#include <discpp/utils.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Discord sends snowflakes as integers when using ETF, so do the same to the captured JSON payloads.
+void ConvertSnowflakes(rapidjson::Value& value) {
+	if (value.IsObject()) {
+		for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+			std::string name = it->name.GetString();
+			bool is_id = name == "id" || (name.size() > 3 && name.compare(name.size() - 3, 3, "_id") == 0);
+
+			if (is_id && it->value.IsString()) {
+				it->value.SetUint64(discpp::GetSnowflake(it->value));
+			} else {
+				ConvertSnowflakes(it->value);
+			}
+		}
+	} else if (value.IsArray()) {
+		for (auto& element : value.GetArray()) {
+			ConvertSnowflakes(element);
+		}
+	}
+}
+
+double TimeDecode(discpp::GatewayCodec& codec, const std::vector<std::string>& payloads, int iterations) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		for (const auto& payload : payloads) {
+			std::unique_ptr<rapidjson::Document> document = codec.Decode(payload);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, const char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <captured payloads> [iterations]" << std::endl;
+		return 1;
+	}
+
+	int iterations = argc > 2 ? std::atoi(argv[2]) : 100;
+
+	discpp::JsonCodec json_codec;
+	discpp::EtfCodec etf_codec;
+
+	std::vector<std::string> json_payloads;
+	std::vector<std::string> etf_payloads;
+	size_t json_bytes = 0, etf_bytes = 0;
+
+	std::ifstream capture(argv[1]);
+	std::string line;
+	while (std::getline(capture, line)) {
+		if (line.empty()) continue;
+
+		std::unique_ptr<rapidjson::Document> document = json_codec.Decode(line);
+		ConvertSnowflakes(*document);
+
+		json_payloads.push_back(line);
+		etf_payloads.push_back(etf_codec.Encode(*document));
+
+		json_bytes += json_payloads.back().size();
+		etf_bytes += etf_payloads.back().size();
+	}
+
+	if (json_payloads.empty()) {
+		std::cerr << "No payloads were found in " << argv[1] << std::endl;
+		return 1;
+	}
+
+	double json_time = TimeDecode(json_codec, json_payloads, iterations);
+	double etf_time = TimeDecode(etf_codec, etf_payloads, iterations);
+	double total = static_cast<double>(json_payloads.size()) * iterations;
+
+	std::cout << "Payloads: " << json_payloads.size() << ", iterations: " << iterations << std::endl
+		<< "JSON: " << json_bytes << " bytes, " << json_time << " ms total, " << (json_time * 1000.0 / total) << " us/payload" << std::endl
+		<< "ETF:  " << etf_bytes << " bytes, " << etf_time << " ms total, " << (etf_time * 1000.0 / total) << " us/payload" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,92 @@
+/*
+	Measures how fast a client can take events from a gateway, using a local mock gateway so no network is needed.
+
+	Usage: gateway_load_benchmark [guilds] [members per guild] [messages per shard] [messages per second] [shards]
+
+	A messages per second of 0 streams the messages as fast as the mock gateway can send them. The events per
+	second and the latency from the mock gateway sending a MESSAGE_CREATE to a listener receiving it are printed.
+*/
+
+#include "mock_gateway.h"
+
+#include <discpp/client.h>
+#include <discpp/client_config.h>
+#include <discpp/event_handler.h>
+#include <discpp/events/message_create_event.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+int main(int argc, const char* argv[]) {
+	discpp::MockGatewayOptions options;
+	options.guild_count = argc > 1 ? std::atoi(argv[1]) : 10;
+	options.members_per_guild = argc > 2 ? std::atoi(argv[2]) : 100;
+	options.message_count = argc > 3 ? std::atoi(argv[3]) : 100000;
+	options.messages_per_second = argc > 4 ? std::atoi(argv[4]) : 0;
+	int shard_count = argc > 5 ? std::atoi(argv[5]) : 1;
+
+	discpp::MockGateway gateway(options);
+	if (!gateway.Start()) {
+		std::cerr << "Failed to start the mock gateway on port " << options.port << std::endl;
+		return 1;
+	}
+
+	discpp::ClientConfig config({ "!" }, shard_count);
+	config.gateway_url = gateway.GetUrl();
+	config.identify_scheduler = std::make_shared<discpp::BucketIdentifyScheduler>(std::chrono::milliseconds(0));
+
+	discpp::Client client("mock-token", &config);
+
+	const size_t expected = static_cast<size_t>(options.message_count) * shard_count;
+	std::mutex mutex;
+	std::condition_variable done;
+	std::vector<int64_t> latencies;
+	latencies.reserve(expected);
+	std::chrono::steady_clock::time_point first_received, last_received;
+
+	discpp::EventHandler<discpp::MessageCreateEvent>::RegisterListener([&](const discpp::MessageCreateEvent& event) {
+		auto now = std::chrono::steady_clock::now();
+		int64_t sent_at = std::strtoll(event.message.content.c_str(), nullptr, 10);
+		int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() - sent_at;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (latencies.empty()) first_received = now;
+		last_received = now;
+		latencies.push_back(latency);
+
+		if (latencies.size() >= expected) done.notify_one();
+	});
+
+	std::thread client_thread([&client] { client.Run(); });
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait_for(lock, std::chrono::minutes(5), [&] { return latencies.size() >= expected; });
+	}
+
+	client.StopClient();
+	client_thread.join();
+	gateway.Stop();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (latencies.empty()) {
+		std::cerr << "No events were received" << std::endl;
+		return 1;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) {
+		return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))] / 1000.0;
+	};
+
+	double seconds = std::chrono::duration<double>(last_received - first_received).count();
+	std::cout << "Events: " << latencies.size() << "/" << expected << " (sent " << gateway.GetSentMessageCount() << ")" << std::endl
+		<< "Events/sec: " << (seconds > 0 ? latencies.size() / seconds : 0) << std::endl
+		<< "Latency p50: " << percentile(0.5) << " us, p99: " << percentile(0.99) << " us, max: " << latencies.back() / 1000.0 << " us" << std::endl;
+
+	return latencies.size() >= expected ? 0 : 1;
+}
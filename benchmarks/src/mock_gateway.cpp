@@ -0,0 +1,225 @@
+#include "mock_gateway.h"
+
+#include <rapidjson/document.h>
+
+namespace discpp {
+    // Guild ids only use the timestamp bits, so `(id >> 22) % shard_count` routes guild n to shard (n + 1) % shard_count.
+    static uint64_t GuildId(int guild_index) {
+        return static_cast<uint64_t>(guild_index + 1) << 22;
+    }
+
+    static uint64_t UserId(int member_index) {
+        return static_cast<uint64_t>(member_index + 1) << 32;
+    }
+
+    static std::string Quote(uint64_t id) {
+        return "\"" + std::to_string(id) + "\"";
+    }
+
+    static std::string BuildUser(uint64_t id, bool bot) {
+        return "{\"id\":" + Quote(id) + ",\"username\":\"user" + std::to_string(id) + "\",\"discriminator\":\"0001\",\"avatar\":null,\"bot\":" + (bot ? "true" : "false") + "}";
+    }
+
+    MockGateway::MockGateway(MockGatewayOptions options) : options(options), server(options.port, "127.0.0.1") {
+        server.setOnConnectionCallback([this](std::weak_ptr<ix::WebSocket> websocket, std::shared_ptr<ix::ConnectionState> connection_state) {
+            auto connection = std::make_shared<Connection>();
+            connection->websocket = websocket;
+
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                connections[connection_state->getId()] = connection;
+            }
+
+            auto ws = websocket.lock();
+            if (!ws) return;
+
+            ws->setOnMessageCallback([this, connection](const ix::WebSocketMessagePtr& msg) {
+                switch (msg->type) {
+                    case ix::WebSocketMessageType::Open:
+                        Send(*connection, "{\"op\":10,\"d\":{\"heartbeat_interval\":" + std::to_string(this->options.heartbeat_interval) + "},\"s\":null,\"t\":null}");
+                        break;
+                    case ix::WebSocketMessageType::Message:
+                        OnMessage(connection, msg->str);
+                        break;
+                    case ix::WebSocketMessageType::Close:
+                        connection->closed = true;
+                        break;
+                    default:
+                        break;
+                }
+            });
+        });
+    }
+
+    MockGateway::~MockGateway() {
+        Stop();
+    }
+
+    bool MockGateway::Start() {
+        auto result = server.listen();
+        if (!result.first) {
+            return false;
+        }
+
+        server.start();
+        return true;
+    }
+
+    void MockGateway::Stop() {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (auto& connection : connections) {
+            connection.second->closed = true;
+            if (connection.second->streamer.joinable()) connection.second->streamer.join();
+        }
+        connections.clear();
+
+        server.stop();
+    }
+
+    std::string MockGateway::GetUrl() const {
+        return "ws://127.0.0.1:" + std::to_string(options.port);
+    }
+
+    uint64_t MockGateway::GetSentMessageCount() const {
+        return sent_messages;
+    }
+
+    void MockGateway::OnMessage(const std::shared_ptr<Connection>& connection, const std::string& payload) {
+        rapidjson::Document document;
+        document.Parse(payload.data(), payload.size());
+        if (document.HasParseError() || !document.IsObject() || !document.HasMember("op")) return;
+
+        switch (document["op"].GetInt()) {
+            case 1: // HEARTBEAT
+                Send(*connection, "{\"op\":11,\"d\":null,\"s\":null,\"t\":null}");
+                break;
+            case 2: { // IDENTIFY
+                if (connection->streamer.joinable()) break;
+
+                const rapidjson::Value& d = document["d"];
+                if (d.HasMember("shard") && d["shard"].IsArray()) {
+                    connection->shard_id = d["shard"][0].GetInt();
+                    connection->shard_count = d["shard"][1].GetInt();
+                }
+
+                std::string guilds;
+                for (int i = 0; i < options.guild_count; i++) {
+                    if (static_cast<int>((GuildId(i) >> 22) % connection->shard_count) != connection->shard_id) continue;
+
+                    if (!guilds.empty()) guilds += ",";
+                    guilds += "{\"id\":" + Quote(GuildId(i)) + ",\"unavailable\":true}";
+                }
+
+                SendDispatch(*connection, "READY", "{\"v\":6,\"session_id\":\"mock-session-" + std::to_string(connection->shard_id) + "\",\"user\":" +
+                    BuildUser(1, true) + ",\"guilds\":[" + guilds + "],\"private_channels\":[],\"shard\":[" + std::to_string(connection->shard_id) +
+                    "," + std::to_string(connection->shard_count) + "]}");
+
+                connection->streamer = std::thread(&MockGateway::StreamEvents, this, connection, false);
+                break;
+            } case 6: // RESUME
+                if (connection->streamer.joinable()) break;
+
+                SendDispatch(*connection, "RESUMED", "{}");
+
+                connection->streamer = std::thread(&MockGateway::StreamEvents, this, connection, true);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void MockGateway::Send(Connection& connection, const std::string& payload) {
+        if (auto websocket = connection.websocket.lock()) {
+            websocket->send(payload);
+        }
+    }
+
+    void MockGateway::SendDispatch(Connection& connection, const char* event_name, const std::string& data) {
+        int sequence = ++connection.sequence;
+        Send(connection, "{\"op\":0,\"t\":\"" + std::string(event_name) + "\",\"s\":" + std::to_string(sequence) + ",\"d\":" + data + "}");
+    }
+
+    void MockGateway::StreamEvents(const std::shared_ptr<Connection>& connection, bool resumed) {
+        std::vector<int> guild_indexes;
+        for (int i = 0; i < options.guild_count; i++) {
+            if (static_cast<int>((GuildId(i) >> 22) % connection->shard_count) == connection->shard_id) {
+                guild_indexes.push_back(i);
+            }
+        }
+
+        if (guild_indexes.empty()) return;
+
+        if (!resumed) {
+            for (int guild_index : guild_indexes) {
+                if (connection->closed) return;
+                SendDispatch(*connection, "GUILD_CREATE", BuildGuild(guild_index));
+            }
+
+            // Give the client time to cache the guilds, events are dispatched asynchronously.
+            std::this_thread::sleep_for(options.warmup);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        int sent = 0;
+        while (connection->next_message < options.message_count && !connection->closed) {
+            if (options.messages_per_second > 0) {
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<int64_t>(sent * (1e9 / options.messages_per_second))));
+            }
+
+            int message = connection->next_message++;
+            uint64_t message_id = (static_cast<uint64_t>(1) << 50) + (static_cast<uint64_t>(connection->shard_id) << 32) + message;
+            SendDispatch(*connection, "MESSAGE_CREATE", BuildMessage(guild_indexes[message % guild_indexes.size()], message_id));
+
+            sent_messages++;
+            sent++;
+        }
+    }
+
+    std::string MockGateway::BuildGuild(int guild_index) const {
+        uint64_t guild_id = GuildId(guild_index);
+
+        std::string guild = "{\"id\":" + Quote(guild_id) + ",\"name\":\"Guild " + std::to_string(guild_index) + "\",\"icon\":null,\"splash\":null,"
+            "\"discovery_splash\":null,\"owner_id\":" + Quote(UserId(0)) + ",\"region\":\"us-east\",\"afk_channel_id\":null,\"afk_timeout\":300,"
+            "\"verification_level\":0,\"default_message_notifications\":0,\"explicit_content_filter\":0,\"features\":[],\"mfa_level\":0,"
+            "\"application_id\":null,\"system_channel_id\":null,\"system_channel_flags\":0,\"rules_channel_id\":null,"
+            "\"joined_at\":\"2020-07-01T12:00:00.000000+00:00\",\"large\":" + (options.members_per_guild > 250 ? "true" : "false") +
+            ",\"unavailable\":false,\"member_count\":" + std::to_string(options.members_per_guild) + ",\"voice_states\":[],\"emojis\":[],"
+            "\"premium_tier\":0,\"premium_subscription_count\":0,\"preferred_locale\":\"en-US\",\"description\":null,\"banner\":null,"
+            "\"vanity_url_code\":null,\"presences\":[],";
+
+        guild += "\"roles\":[{\"id\":" + Quote(guild_id) + ",\"name\":\"@everyone\",\"color\":0,\"hoist\":false,\"position\":0,"
+            "\"permissions\":104324673,\"managed\":false,\"mentionable\":false}],";
+
+        guild += "\"channels\":[";
+        for (int i = 0; i < options.channels_per_guild; i++) {
+            if (i != 0) guild += ",";
+            guild += "{\"id\":" + Quote(guild_id + 1 + i) + ",\"type\":0,\"name\":\"channel-" + std::to_string(i) + "\",\"position\":" +
+                std::to_string(i) + ",\"permission_overwrites\":[],\"topic\":null,\"nsfw\":false,\"last_message_id\":null,"
+                "\"rate_limit_per_user\":0,\"parent_id\":null}";
+        }
+        guild += "],";
+
+        guild += "\"members\":[";
+        for (int i = 0; i < options.members_per_guild; i++) {
+            if (i != 0) guild += ",";
+            guild += "{\"user\":" + BuildUser(UserId(i), false) + ",\"nick\":null,\"roles\":[],\"joined_at\":\"2020-07-01T12:00:00.000000+00:00\","
+                "\"premium_since\":null,\"deaf\":false,\"mute\":false}";
+        }
+        guild += "]}";
+
+        return guild;
+    }
+
+    std::string MockGateway::BuildMessage(int guild_index, uint64_t message_id) const {
+        uint64_t guild_id = GuildId(guild_index);
+        uint64_t channel_id = guild_id + 1 + (message_id % options.channels_per_guild);
+        uint64_t author_id = UserId(static_cast<int>(message_id % options.members_per_guild));
+        auto sent_at = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        return "{\"id\":" + Quote(message_id) + ",\"channel_id\":" + Quote(channel_id) + ",\"guild_id\":" + Quote(guild_id) +
+            ",\"author\":" + BuildUser(author_id, false) + ",\"member\":{\"roles\":[],\"joined_at\":\"2020-07-01T12:00:00.000000+00:00\","
+            "\"deaf\":false,\"mute\":false},\"content\":\"" + std::to_string(sent_at) + "\",\"timestamp\":\"2020-07-01T12:00:00.000000+00:00\","
+            "\"edited_timestamp\":null,\"tts\":false,\"mention_everyone\":false,\"mentions\":[],\"mention_roles\":[],\"attachments\":[],"
+            "\"embeds\":[],\"pinned\":false,\"type\":0}";
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef DISCPP_MOCK_GATEWAY_H
+#define DISCPP_MOCK_GATEWAY_H
+
+#include <ixwebsocket/IXWebSocketServer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace discpp {
+    struct MockGatewayOptions {
+        int port = 9001;
+        int guild_count = 10;
+        int channels_per_guild = 10;
+        int members_per_guild = 100;
+        int messages_per_second = 0; /**< Zero sends them as fast as possible. */
+        int message_count = 100000; /**< The amount of MESSAGE_CREATE events to send on each connection. */
+        std::chrono::milliseconds warmup = std::chrono::milliseconds(1000); /**< Pause between the last GUILD_CREATE and the first MESSAGE_CREATE. */
+        int heartbeat_interval = 41250;
+    };
+
+    /**
+     * @brief A local gateway that speaks just enough of Discord's protocol to run shards against it.
+     *
+     * HELLO is sent when a shard connects, heartbeats are acked and identifies get a READY followed by a
+     * GUILD_CREATE for every guild of the shard and then a stream of MESSAGE_CREATE events. Resumes get RESUMED
+     * followed by the message stream. Every message's content is the `steady_clock` time in nanoseconds it was sent at, so
+     * a listener in the same process can work out the dispatch latency. Only json without compression is spoken.
+     *
+     * Point a client at it with discpp::ClientConfig::gateway_url.
+     */
+    class MockGateway {
+    public:
+        explicit MockGateway(MockGatewayOptions options);
+        ~MockGateway();
+
+        /**
+         * @brief Starts listening on `127.0.0.1:port`.
+         *
+         * @return bool, false if the port couldn't be listened on.
+         */
+        bool Start();
+        void Stop();
+
+        std::string GetUrl() const;
+
+        uint64_t GetSentMessageCount() const;
+    private:
+        struct Connection {
+            std::weak_ptr<ix::WebSocket> websocket;
+            std::thread streamer;
+            std::atomic<bool> closed { false };
+            std::atomic<int> sequence { 0 }; /**< Dispatches are sent from both the server's thread and the streamer. */
+            int next_message = 0;
+            int shard_id = 0;
+            int shard_count = 1;
+        };
+
+        MockGatewayOptions options;
+        ix::WebSocketServer server;
+
+        std::mutex connections_mutex;
+        std::unordered_map<std::string, std::shared_ptr<Connection>> connections;
+
+        std::atomic<uint64_t> sent_messages { 0 };
+
+        void OnMessage(const std::shared_ptr<Connection>& connection, const std::string& payload);
+        void Send(Connection& connection, const std::string& payload);
+        void SendDispatch(Connection& connection, const char* event_name, const std::string& data);
+        void StreamEvents(const std::shared_ptr<Connection>& connection, bool resumed);
+
+        std::string BuildGuild(int guild_index) const;
+        std::string BuildMessage(int guild_index, uint64_t message_id) const;
+    };
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+	Replays a log written by discpp::GatewayRecorder through a client and prints how long dispatching it took.
+
+	Usage: replay_benchmark <log> [--paced]
+
+	Without --paced the frames are replayed as fast as possible, which measures decoding and dispatching. With it
+	they are replayed with the time between them when they were recorded, for reproducing what happened.
+*/
+
+#include <discpp/client.h>
+#include <discpp/client_config.h>
+#include <discpp/exceptions.h>
+
+#include <cstring>
+#include <iostream>
+
+int main(int argc, const char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <log> [--paced]" << std::endl;
+		return 1;
+	}
+
+	discpp::ReplayPacing pacing = argc > 2 && std::strcmp(argv[2], "--paced") == 0 ? discpp::ReplayPacing::ORIGINAL : discpp::ReplayPacing::AS_FAST_AS_POSSIBLE;
+
+	discpp::ClientConfig config({ "!" });
+	discpp::Client client("replay-token", &config);
+
+	uint64_t frames;
+	auto start = std::chrono::steady_clock::now();
+	try {
+		frames = client.Replay(argv[1], pacing);
+	} catch (const discpp::exceptions::RecordingException& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Frames: " << frames << std::endl
+		<< "Time: " << seconds << " s" << std::endl
+		<< "Frames/sec: " << (seconds > 0 ? frames / seconds : 0) << std::endl;
+
+	return 0;
+}
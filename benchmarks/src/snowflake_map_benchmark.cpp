@@ -0,0 +1,132 @@
+/*
+	Compares discpp::SnowflakeMap with the std::unordered_map the model and cache used before.
+
+	Usage: snowflake_map_benchmark [entries] [iterations]
+
+	The keys are made like Discord makes snowflakes: a millisecond timestamp in the high bits and a few worker,
+	process and increment bits below it. Every map is timed on inserting them, looking them up in random order,
+	looking up ids that aren't in the map, iterating, and copying, which the cache does every time it replaces
+	a guild. The old maps are timed with both the identity hash std::hash<Snowflake> used to be and the mixing
+	hash it uses now.
+*/
+
+#include <discpp/snowflake_map.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct IdentityHash {
+	size_t operator()(const discpp::Snowflake& snowflake) const {
+		return static_cast<size_t>(static_cast<uint64_t>(snowflake));
+	}
+};
+
+using Value = std::shared_ptr<int>;
+
+std::vector<discpp::Snowflake> MakeSnowflakes(size_t count, std::mt19937_64& random) {
+	uint64_t timestamp = 1420070400000ull; // Discord's epoch, the ids only need to look alike.
+	std::vector<discpp::Snowflake> snowflakes;
+	snowflakes.reserve(count);
+
+	for (size_t i = 0; i < count; i++) {
+		timestamp += random() % 50;
+		uint64_t worker = random() % 2;
+		uint64_t process = random() % 4;
+		uint64_t increment = random() % 8;
+
+		snowflakes.emplace_back(((timestamp - 1420070400000ull) << 22) | (worker << 17) | (process << 12) | increment);
+	}
+
+	return snowflakes;
+}
+
+template<typename F>
+double Time(int iterations, F&& function) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		function();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+template<typename Map>
+void Benchmark(const std::string& name, const std::vector<discpp::Snowflake>& keys, const std::vector<discpp::Snowflake>& lookups, const std::vector<discpp::Snowflake>& missing, int iterations) {
+	Value value = std::make_shared<int>(0);
+	uint64_t checksum = 0;
+
+	Map map;
+	double insert = Time(iterations, [&] {
+		Map inserted;
+		for (const discpp::Snowflake& key : keys) {
+			inserted.insert({ key, value });
+		}
+		map = std::move(inserted);
+	});
+
+	double hit = Time(iterations, [&] {
+		for (const discpp::Snowflake& key : lookups) {
+			checksum += map.find(key) != map.end();
+		}
+	});
+
+	double miss = Time(iterations, [&] {
+		for (const discpp::Snowflake& key : missing) {
+			checksum += map.find(key) != map.end();
+		}
+	});
+
+	double iterate = Time(iterations, [&] {
+		for (const auto& entry : map) {
+			checksum += static_cast<uint64_t>(entry.first);
+		}
+	});
+
+	double copy = Time(iterations, [&] {
+		Map copied(map);
+		checksum += copied.size();
+	});
+
+	std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(10) << insert << std::setw(10) << hit << std::setw(10) << miss
+		<< std::setw(10) << iterate << std::setw(10) << copy
+		<< "   (checksum " << checksum % 1000 << ")" << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+	std::mt19937_64 random(42);
+	std::vector<discpp::Snowflake> keys = MakeSnowflakes(count, random);
+
+	std::vector<discpp::Snowflake> lookups = keys;
+	std::shuffle(lookups.begin(), lookups.end(), random);
+
+	// Ids from after the last key, so none of them are in the maps.
+	std::vector<discpp::Snowflake> missing;
+	missing.reserve(count);
+	for (const discpp::Snowflake& key : keys) {
+		missing.emplace_back(static_cast<uint64_t>(key) + (static_cast<uint64_t>(keys.back()) - static_cast<uint64_t>(keys.front()) + 1));
+	}
+
+	std::cout << count << " entries, " << iterations << " iterations, milliseconds per pass" << std::endl;
+	std::cout << std::left << std::setw(36) << "map" << std::right << std::setw(10) << "insert" << std::setw(10) << "hit"
+		<< std::setw(10) << "miss" << std::setw(10) << "iterate" << std::setw(10) << "copy" << std::endl;
+
+	Benchmark<std::unordered_map<discpp::Snowflake, Value, IdentityHash>>("std::unordered_map (identity hash)", keys, lookups, missing, iterations);
+	Benchmark<std::unordered_map<discpp::Snowflake, Value>>("std::unordered_map (mixed hash)", keys, lookups, missing, iterations);
+	Benchmark<discpp::SnowflakeMap<Value>>("discpp::SnowflakeMap", keys, lookups, missing, iterations);
+
+	return 0;
+}
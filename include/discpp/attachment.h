@@ -25,7 +25,7 @@ namespace discpp {
          * @return discord::Attachment, this is a constructor.
          *
          .*/
-		Attachment(rapidjson::Document& json);
+		Attachment(const rapidjson::Value& json);
 
 		Snowflake id; /**< id for the current attachment. .*/
 		std::string filename; /**< filename for the current attachment. .*/
@@ -13,17 +13,89 @@
 #include "guild.h"
 #include "message.h"
 #include "channel.h"
+#include "concurrent_map.h"
+#include "snowflake_map.h"
+#include "message_cache.h"
+#include "cache_policy.h"
 
+#include <functional>
 #include <memory>
-#include <unordered_map>
 
 namespace discpp {
+    /**
+     * @brief The objects the client has received, shared by the event handlers and listeners.
+     *
+     * Every map can be used from any thread. Cached guilds, members and messages are shared with whoever got them
+     * from the cache, so they're never changed after being cached. Use UpdateGuild and MessageCache::Update,
+     * which replace the cached object with a changed copy. A guild's members are the exception, they're a
+     * discpp::GuildMembers map every copy of the guild shares, so a member is replaced in that map instead.
+     */
     class Cache {
     public:
-        std::unordered_map<Snowflake, std::shared_ptr<Member>> members; /**< List of members the current bot can access. */
-        std::unordered_map<Snowflake, std::shared_ptr<Guild>> guilds; /**< List of guilds the current bot can access. */
-        std::unordered_map<Snowflake, std::shared_ptr<Message>> messages; /**< List of messages the current bot can access. */
-        std::unordered_map<discpp::Snowflake, discpp::Channel> private_channels; /**< List of dm channels the current client can access. */
+        ConcurrentMap<Snowflake, std::shared_ptr<Member>, SnowflakeMap<std::shared_ptr<Member>>> members; /**< List of members the current bot can access. */
+        ConcurrentMap<Snowflake, std::shared_ptr<Guild>, SnowflakeMap<std::shared_ptr<Guild>>> guilds; /**< List of guilds the current bot can access. */
+        MessageCache messages; /**< The latest messages of every channel, see discpp::ClientConfig::message_cache_size. */
+        ConcurrentMap<Snowflake, discpp::Channel, SnowflakeMap<discpp::Channel>> private_channels; /**< List of dm channels the current client can access. */
+        ConcurrentMap<Snowflake, Snowflake, SnowflakeMap<Snowflake>> channel_guilds; /**< The guild id of every cached channel, zero for dm channels, so channels are found without looking through every guild. */
+        CachePolicies policies; /**< Which objects are cached, see discpp::ClientConfig::cache_policies. */
+
+        CacheExpiry member_expiry; /**< Members by guild id. */
+        CacheExpiry presence_expiry; /**< Presences by guild id and user id. */
+        CacheExpiry message_expiry; /**< Messages by channel id. */
+        CacheExpiry dm_channel_expiry; /**< DM channels, their owner id is always zero. */
+        CacheExpiry emoji_expiry; /**< Emojis by guild id. */
+        CacheExpiry voice_state_expiry; /**< Voice states by guild id and user id. */
+
+        /**
+         * @brief Sets which objects are cached.
+         *
+         * This should be done before anything is cached, objects that are already cached aren't removed.
+         *
+         * @param[in] policies The policies.
+         *
+         * @return void
+         */
+        void SetPolicies(const CachePolicies& policies);
+
+        /**
+         * @brief Remembers when the members, presences, emojis and voice states of a guild were cached, for the
+         * policies that expire them.
+         *
+         * @param[in] guild The guild that was cached.
+         *
+         * @return void
+         */
+        void TouchGuild(const discpp::Guild& guild);
+
+        /**
+         * @brief Removes the objects that have been cached longer than their policy allows.
+         *
+         * The client does this every second when a policy expires objects. The guilds they're removed from are
+         * replaced once, no matter how many of their objects expired.
+         *
+         * @return void
+         */
+        void ExpireEntries();
+
+        /**
+         * @brief Replaces a cached guild with a changed copy of it.
+         *
+         * Whoever already has the guild keeps the unchanged one. Changes to the same guild happen one at a time.
+         * The copy shares the guild's members, so this takes the same time no matter how many members are cached.
+         *
+         * ```cpp
+         *      cache.UpdateGuild(guild_id, [&](discpp::Guild& guild) {
+         *          guild.channels.insert({ channel.id, channel });
+         *      });
+         * ```
+         *
+         * @param[in] guild_id The id of the guild to change.
+         * @param[in] update Changes the copy, it shouldn't use the cache's guilds.
+         *
+         * @return std::shared_ptr<discpp::Guild>, the changed guild, nullptr if the guild isn't cached.
+         */
+        std::shared_ptr<discpp::Guild> UpdateGuild(const Snowflake& guild_id, const std::function<void(discpp::Guild&)>& update);
+
 
         /**
          * @brief Gets a discpp::Guild from a guild id.
@@ -39,6 +111,22 @@ namespace discpp {
          */
         std::shared_ptr<discpp::Guild> GetGuild(const Snowflake& guild_id, bool can_request = false);
 
+        /**
+         * @brief Finds a cached guild or DM channel.
+         *
+         * The channel's guild is looked up in `channel_guilds`, so this takes the same time no matter how many
+         * guilds are cached.
+         *
+         * ```cpp
+         *      std::optional<discpp::Channel> channel = cache.FindChannel(channel_id);
+         * ```
+         *
+         * @param[in] id The id of the channel.
+         *
+         * @return std::optional<discpp::Channel>, empty if the channel isn't cached.
+         */
+        std::optional<discpp::Channel> FindChannel(const discpp::Snowflake& id) const;
+
         /**
          * @brief Gets a channel from guild cache and private caches.
          *
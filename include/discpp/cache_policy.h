@@ -0,0 +1,215 @@
+#ifndef DISCPP_CACHE_POLICY_H
+#define DISCPP_CACHE_POLICY_H
+
+#include "snowflake.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace discpp {
+    class Member;
+    class Presence;
+    class Message;
+    class Channel;
+    class Emoji;
+    class VoiceState;
+
+    enum class CachePolicyType {
+        OFF, /**< Nothing is cached. */
+        UNBOUNDED, /**< Everything is cached. */
+        BOUNDED, /**< Up to `max_entries` are cached, once full new ones aren't. */
+        TTL /**< Everything is cached, and removed once it hasn't been received again for `ttl`. */
+    };
+
+    /**
+     * @brief Decides which objects of one kind are cached, see discpp::ClientConfig::cache_policies.
+     *
+     * Objects that belong to a guild, like members and emojis, are bounded per guild. Messages and DM channels are
+     * bounded across the whole client. A predicate can be added to any policy to only cache the objects it accepts.
+     *
+     * ```cpp
+     *      config->cache_policies.members = discpp::CachePolicy<discpp::Member>::Only([](const discpp::Member& member) {
+     *          return !member.roles.empty();
+     *      });
+     *      config->cache_policies.presences = discpp::CachePolicy<discpp::Presence>::Off();
+     *      config->cache_policies.voice_states = discpp::CachePolicy<discpp::VoiceState>::Expiring(std::chrono::minutes(10));
+     * ```
+     */
+    template<typename T>
+    class CachePolicy {
+    public:
+        using Predicate = std::function<bool(const T&)>;
+
+        CachePolicyType type = CachePolicyType::UNBOUNDED;
+        size_t max_entries = 0; /**< The amount of objects that can be cached when the policy is bounded. */
+        std::chrono::seconds ttl = std::chrono::seconds::zero(); /**< How long an object stays cached when the policy expires objects. */
+        Predicate predicate; /**< Only objects this accepts are cached, every object is if it's empty. */
+
+        static CachePolicy Off() {
+            CachePolicy policy;
+            policy.type = CachePolicyType::OFF;
+            return policy;
+        }
+
+        static CachePolicy Unbounded() {
+            return CachePolicy();
+        }
+
+        static CachePolicy Bounded(size_t max_entries) {
+            CachePolicy policy;
+            policy.type = CachePolicyType::BOUNDED;
+            policy.max_entries = max_entries;
+            return policy;
+        }
+
+        static CachePolicy Expiring(std::chrono::seconds ttl) {
+            CachePolicy policy;
+            policy.type = CachePolicyType::TTL;
+            policy.ttl = ttl;
+            return policy;
+        }
+
+        static CachePolicy Only(Predicate predicate) {
+            CachePolicy policy;
+            policy.predicate = std::move(predicate);
+            return policy;
+        }
+
+        /**
+         * @brief Adds a predicate to the policy.
+         *
+         * ```cpp
+         *      auto policy = discpp::CachePolicy<discpp::Emoji>::Bounded(50).Where([](const discpp::Emoji& emoji) { return emoji.animated; });
+         * ```
+         *
+         * @param[in] predicate Only objects this accepts are cached.
+         *
+         * @return discpp::CachePolicy, this policy.
+         */
+        CachePolicy& Where(Predicate predicate) {
+            this->predicate = std::move(predicate);
+            return *this;
+        }
+
+        /**
+         * @brief Check if an object should be cached.
+         *
+         * @param[in] value The object.
+         * @param[in] cached The amount of objects already cached where it would go.
+         *
+         * @return bool
+         */
+        bool Allows(const T& value, size_t cached = 0) const {
+            if (type == CachePolicyType::OFF) return false;
+            if (type == CachePolicyType::BOUNDED && cached >= max_entries) return false;
+
+            return !predicate || predicate(value);
+        }
+
+        /**
+         * @brief Check if cached objects have to be removed after a while.
+         *
+         * @return bool
+         */
+        bool Expires() const {
+            return type == CachePolicyType::TTL && ttl > std::chrono::seconds::zero();
+        }
+    };
+
+    /**
+     * @brief The policies of every kind of cached object, all of them cache everything by default.
+     *
+     * Messages are always bounded, by the policy's `max_entries` if it's bounded and by
+     * discpp::ClientConfig::message_cache_size otherwise. The member of the bot itself is always cached, since
+     * permission checks need it.
+     */
+    struct CachePolicies {
+        CachePolicy<Member> members;
+        CachePolicy<Presence> presences;
+        CachePolicy<Message> messages;
+        CachePolicy<Channel> dm_channels;
+        CachePolicy<Emoji> emojis;
+        CachePolicy<VoiceState> voice_states;
+
+        /**
+         * @brief Check if any of the policies expires objects.
+         *
+         * @return bool
+         */
+        bool AnyExpires() const {
+            return members.Expires() || presences.Expires() || messages.Expires() || dm_channels.Expires() || emojis.Expires() || voice_states.Expires();
+        }
+    };
+
+    /**
+     * @brief Remembers when objects were cached, so the ones that have been cached for too long can be removed.
+     *
+     * Objects are identified by their id and the id of what owns them, like the guild of a member or the channel of
+     * a message. Caching an object again restarts its time. Since every object lives equally long, they expire in
+     * the order they were cached, so finding the expired ones doesn't have to look at the others.
+     */
+    class CacheExpiry {
+    public:
+        using Entry = std::pair<Snowflake, Snowflake>; /**< The owner id and the id of an object. */
+
+        /**
+         * @brief Sets how long objects stay cached, zero doesn't remember any.
+         *
+         * @param[in] ttl How long objects stay cached.
+         *
+         * @return void
+         */
+        void SetTTL(std::chrono::seconds ttl);
+
+        /**
+         * @brief Remembers that an object was cached now.
+         *
+         * @param[in] owner_id The id of what owns the object.
+         * @param[in] id The id of the object.
+         *
+         * @return void
+         */
+        void Touch(const Snowflake& owner_id, const Snowflake& id);
+
+        /**
+         * @brief Forgets an object that was removed from the cache.
+         *
+         * @param[in] owner_id The id of what owns the object.
+         * @param[in] id The id of the object.
+         *
+         * @return void
+         */
+        void Forget(const Snowflake& owner_id, const Snowflake& id);
+
+        /**
+         * @brief Forgets the objects that have been cached for too long and returns them.
+         *
+         * @return std::vector<discpp::CacheExpiry::Entry>
+         */
+        std::vector<Entry> TakeExpired();
+    private:
+        struct EntryHash {
+            size_t operator()(const Entry& entry) const {
+                return static_cast<size_t>(static_cast<uint64_t>(entry.second) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(entry.first));
+            }
+        };
+
+        struct Record {
+            Entry entry;
+            std::chrono::steady_clock::time_point cached_at;
+        };
+
+        std::mutex mutex;
+        std::chrono::seconds ttl = std::chrono::seconds::zero();
+        std::deque<Record> records; /**< Oldest first, records of objects that were cached again or forgotten are skipped. */
+        std::unordered_map<Entry, std::chrono::steady_clock::time_point, EntryHash> cached_at; /**< The last time every remembered object was cached. */
+    };
+}
+
+#endif
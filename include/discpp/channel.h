@@ -5,6 +5,7 @@
 #include "permission.h"
 #include "embed_builder.h"
 #include "utils.h"
+#include "task.h"
 
 #include <variant>
 #include <vector>
@@ -118,7 +119,7 @@ namespace discpp {
          *
          * @return discpp::Channel, this is a constructor.
          */
-		Channel(rapidjson::Document& json);
+		Channel(const rapidjson::Value& json);
 
         /**
          * @brief Requests a channel from discord's api.
@@ -151,6 +152,26 @@ namespace discpp {
          */
 		discpp::Message Send(const std::string& text, const bool tts = false, discpp::EmbedBuilder* embed = nullptr, std::vector<discpp::File> files = {});
 
+#ifdef DISCPP_COROUTINES
+        /**
+         * @brief Coroutine version of discpp::Channel::Send. Requires building with DISCPP_COROUTINES.
+         *
+         * The message is sent from the client's worker threads and the coroutine is resumed there once it's sent.
+         *
+         * ```cpp
+         *      discpp::Message message = co_await ctx.SendAsync("Hello, I'm a bot!");
+         * ```
+         *
+         * @param[in] text The text that goes along with the embed.
+         * @param[in] tts Should it be a text to speech message?
+         * @param[in] embed Embed to send, it must stay alive until the message is sent.
+         * @param[in] files Files to send
+         *
+         * @return discpp::Task<discpp::Message>
+         */
+		discpp::Task<discpp::Message> SendAsync(std::string text, bool tts = false, discpp::EmbedBuilder* embed = nullptr, std::vector<discpp::File> files = {});
+#endif
+
         /**
          * @brief Modify the channel.
          *
@@ -2,8 +2,15 @@
 #define DISCPP_BOT_H
 
 #include <string>
-#include <future>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <bitset>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 #include <ixwebsocket/IXWebSocket.h>
@@ -12,6 +19,14 @@
 #include "settings.h"
 #include "channel.h"
 #include "cache.h"
+#include "zlib_stream.h"
+#include "gateway_codec.h"
+#include "gateway_send_queue.h"
+#include "thread_pool.h"
+#include "strand.h"
+#include "event_queue.h"
+#include "timer_queue.h"
+#include "gateway_event.h"
 
 namespace discpp {
 	class Role;
@@ -27,7 +42,7 @@ namespace discpp {
 	public:
 		ClientUser() = default;
 		ClientUser(const Snowflake& id) : User(id) {}
-		ClientUser(rapidjson::Document & json);
+		ClientUser(const rapidjson::Value& json);
 
         /**
          * @brief Get all connections of this user.
@@ -55,7 +70,7 @@ namespace discpp {
 	    int type;
 	public:
         UserRelationship() = default;
-        UserRelationship(rapidjson::Document& json);
+        UserRelationship(const rapidjson::Value& json);
 
         /**
          * @brief Returns if this relation is a friend.
@@ -78,6 +93,16 @@ namespace discpp {
 
 	class Shard;
 
+#ifdef DISCPP_COROUTINES
+	template<typename T>
+	class EventAwaiter;
+#endif
+
+    enum class ReplayPacing {
+        AS_FAST_AS_POSSIBLE,
+        ORIGINAL /**< Wait between frames as long as the gateway did when they were recorded. */
+    };
+
 	class Client {
 	    friend class Shard;
 	public:
@@ -106,6 +131,11 @@ namespace discpp {
          */
 		Client(const std::string& token, ClientConfig* config);
 
+        /**
+         * @brief Stops the timers and then the worker threads, tasks that are still queued run before it returns.
+         */
+        ~Client();
+
         /**
          * @brief Executes the discpp bot.
          *
@@ -114,6 +144,9 @@ namespace discpp {
          *		bot.Run();
          * ```
          *
+         * @throws discpp::exceptions::MaximumLimitException If the gateway start limit was reached, anything else that
+         * kept the shards from starting is thrown from here too.
+         *
          * @return int, currently only returns zero.
          */
 		int Run();
@@ -135,6 +168,28 @@ namespace discpp {
 
 		void StopClient();
 
+        /**
+         * @brief Replays a log written by discpp::GatewayRecorder without connecting to the gateway.
+         *
+         * Every shard in the log is created and fed its frames through the same decompression, decoding and
+         * dispatching as frames from a real connection, so listeners and the cache see the recorded traffic. Only
+         * dispatches are handled, there's no connection to answer HELLO, heartbeat acks or invalid sessions with,
+         * and nothing the shards try to send goes anywhere. This returns after every listener has finished.
+         *
+         * ```cpp
+         *      discpp::Client client(TOKEN, &config);
+         *      client.Replay("gateway.dpcap", discpp::ReplayPacing::AS_FAST_AS_POSSIBLE);
+         * ```
+         *
+         * @param[in] path The path of the log.
+         * @param[in] pacing If the frames should be replayed as fast as possible or with the time between them when they were recorded.
+         *
+         * @throws discpp::exceptions::RecordingException If the log couldn't be read.
+         *
+         * @return uint64_t, the amount of frames that were replayed.
+         */
+        uint64_t Replay(const std::string& path, ReplayPacing pacing = ReplayPacing::AS_FAST_AS_POSSIBLE);
+
 		// Discord based methods.
 
         /**
@@ -199,6 +254,72 @@ namespace discpp {
          */
         void UpdatePresence(discpp::Presence& activity);
 
+        /**
+         * @brief Get the shard that receives events for a guild.
+         *
+         * ```cpp
+         *      discpp::Shard* shard = bot.GetShardForGuild(guild.id);
+         * ```
+         *
+         * @param[in] guild_id The id of the guild.
+         *
+         * @return discpp::Shard*, nullptr if the guild belongs to a shard that another process is running.
+         */
+        Shard* GetShardForGuild(const discpp::Snowflake& guild_id);
+
+        /**
+         * @brief Get the amount of shards the bot has across every process.
+         *
+         * @return int
+         */
+        int GetTotalShards() const;
+
+        /**
+         * @brief Get the metrics of the worker threads that events, listeners and commands run on.
+         *
+         * ```cpp
+         *      discpp::ThreadPoolStats stats = bot.GetExecutorStats();
+         * ```
+         *
+         * @return discpp::ThreadPoolStats
+         */
+        ThreadPoolStats GetExecutorStats() const;
+
+        /**
+         * @brief Get the metrics of the queue of an event, see discpp::ClientConfig::event_queues.
+         *
+         * ```cpp
+         *      uint64_t dropped = bot.GetEventQueueStats(discpp::GatewayEvent::TYPING_START).dropped;
+         * ```
+         *
+         * @param[in] event The event.
+         *
+         * @return discpp::EventQueueStats
+         */
+        EventQueueStats GetEventQueueStats(GatewayEvent event) const;
+
+#ifdef DISCPP_COROUTINES
+        /**
+         * @brief Wait for an event from a coroutine. Requires building with DISCPP_COROUTINES and including discpp/coroutine.h.
+         *
+         * The coroutine doesn't use a thread while it waits, it's resumed on the worker threads with the first
+         * event the predicate accepts, or with nullptr once the timeout has passed.
+         *
+         * ```cpp
+         *      std::shared_ptr<const discpp::MessageCreateEvent> reply = co_await bot.WaitFor<discpp::MessageCreateEvent>([&](const discpp::MessageCreateEvent& event) {
+         *          return event.message.author.id == author_id;
+         *      }, std::chrono::seconds(30));
+         * ```
+         *
+         * @param[in] predicate Returns true for the event to wait for, every event matches if it's empty.
+         * @param[in] timeout How long to wait, zero waits until an event matches.
+         *
+         * @return discpp::EventAwaiter<T>
+         */
+        template<typename T>
+        EventAwaiter<T> WaitFor(std::function<bool(const T&)> predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+#endif
+
         /**
          * @brief Get a user.
          *
@@ -242,6 +363,10 @@ namespace discpp {
 			/**
 			 * @brief Do a function async so it wont hold the bot up.
 			 *
+			 * The function is run by one of the client's worker threads, see discpp::ClientConfig::worker_threads. It
+			 * isn't kept in order with the event that was being handled when it was called, so listeners and commands
+			 * of a guild can run at the same time.
+			 *
 			 * ```cpp
 			 *      bot.DoFunctionLater(method, this, message);
 			 * ```
@@ -252,22 +377,59 @@ namespace discpp {
 			 * @return void
 			 */
 
-            {
-                std::lock_guard<std::mutex> futures_guard(futures_mutex);
-                futures.push_back(std::async(std::launch::async, func, std::forward<T>(args)...));
-            }
+            Schedule([func = std::forward<FType>(func), args = std::make_tuple(std::forward<T>(args)...)]() mutable {
+                std::apply(func, std::move(args));
+            });
+		}
+
+		template <typename FType, typename... T>
+		void DoFunctionAfter(std::chrono::milliseconds delay, FType&& func, T&&... args) {
+			/**
+			 * @brief Do a function async once a delay has passed, without holding a thread while waiting.
+			 *
+			 * The function is run by one of the client's worker threads.
+			 *
+			 * ```cpp
+			 *      bot.DoFunctionAfter(std::chrono::seconds(10), method, this, message);
+			 * ```
+			 *
+			 * @param[in] delay How long to wait before running the function.
+			 * @param[in] func The method that will run when the delay has passed.
+			 * @param[in] args The arguments for the method.
+			 *
+			 * @return void
+			 */
+
+            ScheduleAfter(delay, [func = std::forward<FType>(func), args = std::make_tuple(std::forward<T>(args)...)]() mutable {
+                std::apply(func, std::move(args));
+            });
 		}
 	private:
 		friend class Shard;
         friend class EventDispatcher;
 		bool stay_disconnected = false;
-		bool run = true;
+		bool custom_command_handler = false; /**< SetCommandHandler was used, so every message could be a command. */
+		std::atomic<bool> run { true };
+
+        std::mutex run_mutex;
+        std::condition_variable run_condition;
+        std::exception_ptr startup_exception; /**< Why the shards couldn't be started, set before run is cleared. */
 
-        std::vector<std::future<void>> futures;
+        std::once_flag client_user_set; /**< client_user is only set by the first shard that becomes ready. */
 
-		std::mutex futures_mutex;
+        // The queues post to the strands and the strands to the pool, so they're declared first to be destroyed
+        // after it has finished its tasks.
+        std::unique_ptr<EventQueues> event_queues;
+        std::unique_ptr<StrandExecutor> strands;
+        std::unique_ptr<ThreadPool> executor;
+        std::unique_ptr<TimerQueue> timers; /**< Hands tasks to the pool, ~Client stops it before the pool and resets it after, since the pool's remaining tasks can still add timers. */
+
+        void Schedule(ThreadPool::Task task);
+        void ScheduleAfter(std::chrono::milliseconds delay, ThreadPool::Task task);
+        void ScheduleCacheExpiry();
 
 		int message_cache_count;
+		int total_shards = 1;
 
 		// Websocket Methods
 
@@ -308,7 +470,9 @@ namespace discpp {
         /**
          * @brief Send a request to the websocket.
          *
-         * Be cautious with this as it will close the websocket connection if the packet is invalid.
+         * Be cautious with this as it will close the websocket connection if the packet is invalid. The payload is
+         * put in the shard's send queue, heartbeats, identifies and resumes go in its priority lane and presence
+         * updates that are still queued get replaced by newer ones.
          *
          * ```cpp
          *      bot.CreateWebsocketRequest(request_json);
@@ -335,39 +499,99 @@ namespace discpp {
             HEARTBEAT_ACK = 11			// Receive
         };
 
+        /**
+         * @brief Get how long it took this shard to become ready, measured from when it was created.
+         *
+         * ```cpp
+         *      client->logger->Info("Shard 0 started in " + std::to_string(client->shards[0]->GetStartupTime().count()) + "ms");
+         * ```
+         *
+         * @return std::chrono::milliseconds, zero if the shard isn't ready yet.
+         */
+        std::chrono::milliseconds GetStartupTime() const;
+
+        /**
+         * @brief Get the metrics of this shard's outbound send queue.
+         *
+         * ```cpp
+         *      discpp::GatewaySendQueueStats stats = shard->GetSendQueueStats();
+         * ```
+         *
+         * @return discpp::GatewaySendQueueStats
+         */
+        GatewaySendQueueStats GetSendQueueStats() const;
+
+        /**
+         * @brief Get the shard whose event this thread is handling.
+         *
+         * This is set while the handlers of a dispatch run, so listeners that are triggered by them can see
+         * which shard the event came from.
+         *
+         * ```cpp
+         *      discpp::Shard* shard = discpp::Shard::GetCurrent();
+         * ```
+         *
+         * @return discpp::Shard*, nullptr if this thread isn't handling an event.
+         */
+        static Shard* GetCurrent();
+
         int id;
         Client& client;
     private:
         friend class Client;
         friend class EventDispatcher;
 
-        Shard(Client& client, int id, std::string endpoint) : client(client), id(id), gateway_endpoint(endpoint) {}
+        Shard(Client& client, int id, std::string endpoint);
+
+        inline static thread_local Shard* current = nullptr; /**< See GetCurrent, set by discpp::EventDispatcher. */
 
-        std::string session_id;
+        // The heartbeat thread saves the session while the receive thread changes it.
+        mutable std::mutex session_mutex;
+        std::string session_id; /**< Guarded by session_mutex, see GetSessionId and SetSessionId. */
         std::string gateway_endpoint;
 
         rapidjson::Document hello_packet;
 
         std::thread heartbeat_thread;
+        std::thread identify_thread; /**< Waits for identify schedulers that can't reserve a time, see discpp::IdentifyScheduler::ReserveIdentify. */
 
         ix::WebSocket websocket;
 
+        std::unique_ptr<discpp::GatewayCodec> codec;
+        discpp::ZlibStream zlib_stream;
+        std::string inflate_buffer; /**< Reused between messages so inflating doesn't allocate for every payload. */
+        std::bitset<kGatewayEventCount> ignored_events; /**< From discpp::ClientConfig::ignored_events. */
+
+        discpp::GatewaySendQueue send_queue; /**< Must be declared after the websocket and codec so its thread stops first. */
+
         discpp::Client::HeartbeatWaiter heartbeat_waiter;
 
         bool ready = false;
         bool disconnected = true;
         bool reconnecting = false;
         bool heartbeat_acked;
-        int last_sequence_number = 0;
+        bool replaying = false; /**< The shard is fed frames by discpp::Client::Replay instead of a connection. */
+        std::atomic<int> last_sequence_number = 0;
         long long packet_counter;
 
+        std::chrono::steady_clock::time_point start_time;
+        std::chrono::milliseconds startup_time = std::chrono::milliseconds(0);
+
         void ReconnectToWebsocket();
-        void DisconnectWebsocket();
+        void DisconnectWebsocket(uint16_t code = ix::WebSocketCloseConstants::kNormalClosureCode);
         void WebSocketStart();
         void OnWebSocketListen(ix::WebSocketMessagePtr& msg);
-        void OnWebSocketPacket(rapidjson::Document& result);
-        void HandleDiscordDisconnect(const ix::WebSocketMessagePtr& msg);
+        void OnWebSocketFrame(const std::string& frame, bool compressed);
+        bool IsIgnoredEvent(GatewayEvent event) const;
+        void OnWebSocketPacket(std::shared_ptr<rapidjson::Document> packet);
+        void HandleDiscordDisconnect(const ix::WebSocketCloseInfo& close_info);
         void HandleHeartbeat();
+        void Identify();
+        void SendIdentify();
+        void Resume();
+        void SaveSession();
+        std::string GetSessionId() const;
+        void SetSessionId(std::string session_id);
         std::unique_ptr<rapidjson::Document> GetIdentifyPacket();
     };
 }
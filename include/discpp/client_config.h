@@ -2,7 +2,17 @@
 #define DISCPP_CLIENT_CONFIG_H
 
 #include "log.h"
+#include "identify_scheduler.h"
+#include "intents.h"
+#include "session_store.h"
+#include "gateway_recorder.h"
+#include "gateway_event.h"
+#include "event_queue.h"
+#include "cache_policy.h"
+#include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -12,14 +22,57 @@ namespace discpp {
         BOT
     };
 
+    enum class GatewayEncoding {
+        JSON,
+        ETF
+    };
+
 	class ClientConfig {
 	public:
 		std::vector<std::string> prefixes;
 		TokenType type;
 		int logger_flags;
-		int message_cache_size;
+		int message_cache_size; /**< The amount of messages the cache holds across every channel, edits, deletes and reactions of older messages can't be given the original message. */
+		int message_cache_channel_size = 100; /**< The amount of messages the cache holds of a single channel. */
+		CachePolicies cache_policies; /**< Which members, presences, messages, DM channels, emojis and voice states are cached. Large bots can save most of their memory by not caching members. */
 		int shard_amount;
+		int total_shards = 0; /**< The amount of shards the bot has across every process, zero means `shard_amount`. Set this when running a cluster. */
+		std::vector<int> shard_ids; /**< The shards this process runs, empty means all of them. Only shards below the total can be used. */
 		std::string logger_path;
+		bool zlib_compress = false; /**< Use zlib-stream transport compression for gateway connections. */
+		std::string gateway_url; /**< Connect to this gateway instead of asking Discord for one, for testing against a local gateway. */
+		GatewayEncoding gateway_encoding = GatewayEncoding::JSON; /**< The encoding gateway payloads are sent in. */
+		std::optional<GatewayIntents> intents; /**< The intents sent when identifying, if this is empty Discord sends every event. See discpp::SuggestIntents. */
+		std::shared_ptr<SessionStore> session_store; /**< Where shard sessions are saved so they can be resumed after a restart, nothing is saved if this is empty. */
+		std::vector<GatewayEvent> ignored_events; /**< Events that are dropped as soon as they're received, before they're decoded when possible. READY and RESUMED can't be ignored. */
+		std::unordered_map<GatewayEvent, EventQueueLimit> event_queues; /**< Limits the events of a type that can wait to be handled, events without a limit are never dropped. Shed low value events like TYPING_START first. */
+		unsigned int worker_threads = 0; /**< The amount of threads events, listeners and commands run on, zero uses the amount of hardware threads. */
+		std::shared_ptr<GatewayRecorder> gateway_recorder; /**< Every frame the shards receive is appended to this, see discpp::Client::Replay. */
+		std::shared_ptr<IdentifyScheduler> identify_scheduler; /**< Decides when shards can identify, a discpp::BucketIdentifyScheduler is used if this is left empty. */
+
+        /**
+         * @brief Makes this process only run shards `first` through `last` (inclusive) of `total`.
+         *
+         * This lets several processes or machines each run a slice of the same bot.
+         *
+         * ```cpp
+         *      config->SetShardRange(16, 31, 64); // This process is the second of four nodes.
+         * ```
+         *
+         * @param[in] first The first shard id this process will run.
+         * @param[in] last The last shard id this process will run.
+         * @param[in] total The amount of shards across all processes.
+         *
+         * @return void
+         */
+		void SetShardRange(int first, int last, int total) {
+		    shard_ids.clear();
+		    for (int i = first; i <= last; i++) {
+		        shard_ids.push_back(i);
+		    }
+
+		    total_shards = total;
+		}
 
         /**
          * @brief Creates a ClientConfig object.
@@ -0,0 +1,224 @@
+#ifndef DISCPP_CONCURRENT_MAP_H
+#define DISCPP_CONCURRENT_MAP_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace discpp {
+    /**
+     * @brief A hash map that can be used from many threads at once.
+     *
+     * The keys are spread over a fixed amount of stripes that each have their own lock, so threads only wait for
+     * each other when they use keys of the same stripe, and readers of a stripe don't wait for each other. Every
+     * stripe is a `Map`, which can be any map with the std::unordered_map interface, like discpp::SnowflakeMap.
+     *
+     * Values are only ever handed out as copies, or to a callback while the stripe is locked, so nothing can keep
+     * a reference to a value another thread is changing. Maps of std::shared_ptr share the object they point to,
+     * those objects should be replaced instead of changed.
+     *
+     * ```cpp
+     *      discpp::ConcurrentMap<discpp::Snowflake, discpp::Channel, discpp::SnowflakeMap<discpp::Channel>> channels;
+     *      channels.InsertOrAssign(channel.id, channel);
+     *
+     *      std::optional<discpp::Channel> channel = channels.Get(channel_id);
+     * ```
+     */
+    template<typename K, typename V, typename Map = std::unordered_map<K, V>, size_t StripeCount = 16>
+    class ConcurrentMap {
+    public:
+        /**
+         * @brief Get a copy of the value of a key.
+         *
+         * @param[in] key The key.
+         *
+         * @return std::optional<V>, empty if the key isn't in the map.
+         */
+        std::optional<V> Get(const K& key) const {
+            const Stripe& stripe = GetStripe(key);
+            std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+
+            auto itr = stripe.map.find(key);
+            if (itr == stripe.map.end()) return std::nullopt;
+            return itr->second;
+        }
+
+        /**
+         * @brief Check if a key is in the map.
+         *
+         * @param[in] key The key.
+         *
+         * @return bool
+         */
+        bool Contains(const K& key) const {
+            const Stripe& stripe = GetStripe(key);
+            std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+
+            return stripe.map.find(key) != stripe.map.end();
+        }
+
+        /**
+         * @brief Adds a value if the key isn't in the map yet.
+         *
+         * @param[in] key The key.
+         * @param[in] value The value.
+         *
+         * @return bool, false if the key was already in the map, its value isn't changed then.
+         */
+        bool Insert(const K& key, V value) {
+            Stripe& stripe = GetStripe(key);
+            std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+
+            return stripe.map.emplace(key, std::move(value)).second;
+        }
+
+        /**
+         * @brief Sets the value of a key, adding it if it isn't in the map yet.
+         *
+         * @param[in] key The key.
+         * @param[in] value The value.
+         *
+         * @return void
+         */
+        void InsertOrAssign(const K& key, V value) {
+            Stripe& stripe = GetStripe(key);
+            std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+
+            stripe.map.insert_or_assign(key, std::move(value));
+        }
+
+        /**
+         * @brief Changes the value of a key while no other thread can use it.
+         *
+         * The callback is run with the stripe locked, so it shouldn't use the map itself.
+         *
+         * ```cpp
+         *      channels.Update(channel_id, [&](discpp::Channel& channel) {
+         *          channel.last_pin_timestamp = timestamp;
+         *      });
+         * ```
+         *
+         * @param[in] key The key.
+         * @param[in] update Called with the value if the key is in the map.
+         *
+         * @return bool, false if the key isn't in the map.
+         */
+        template<typename F>
+        bool Update(const K& key, F&& update) {
+            Stripe& stripe = GetStripe(key);
+            std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+
+            auto itr = stripe.map.find(key);
+            if (itr == stripe.map.end()) return false;
+
+            update(itr->second);
+            return true;
+        }
+
+        /**
+         * @brief Removes a key.
+         *
+         * @param[in] key The key.
+         *
+         * @return std::optional<V>, the removed value, empty if the key wasn't in the map.
+         */
+        std::optional<V> Erase(const K& key) {
+            Stripe& stripe = GetStripe(key);
+            std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+
+            auto itr = stripe.map.find(key);
+            if (itr == stripe.map.end()) return std::nullopt;
+
+            std::optional<V> value(std::move(itr->second));
+            stripe.map.erase(itr);
+            return value;
+        }
+
+        /**
+         * @brief Calls a function with every key and value.
+         *
+         * One stripe is locked at a time, so changes made to other stripes while iterating may or may not be seen.
+         * The callback shouldn't use the map itself.
+         *
+         * @param[in] function Called with every key and value.
+         *
+         * @return void
+         */
+        template<typename F>
+        void ForEach(F&& function) const {
+            for (const Stripe& stripe : stripes) {
+                std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+                for (const auto& entry : stripe.map) {
+                    function(entry.first, entry.second);
+                }
+            }
+        }
+
+        /**
+         * @brief Get a copy of every value.
+         *
+         * @return std::vector<V>
+         */
+        std::vector<V> Values() const {
+            std::vector<V> values;
+            ForEach([&](const K&, const V& value) {
+                values.push_back(value);
+            });
+            return values;
+        }
+
+        /**
+         * @brief Get the amount of keys in the map.
+         *
+         * @return size_t
+         */
+        size_t Size() const {
+            size_t size = 0;
+            for (const Stripe& stripe : stripes) {
+                std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+                size += stripe.map.size();
+            }
+            return size;
+        }
+
+        /**
+         * @brief Removes every key.
+         *
+         * @return void
+         */
+        void Clear() {
+            for (Stripe& stripe : stripes) {
+                std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+                stripe.map.clear();
+            }
+        }
+    private:
+        struct Stripe {
+            mutable std::shared_mutex mutex;
+            Map map;
+        };
+
+        std::array<Stripe, StripeCount> stripes;
+
+        size_t GetStripeIndex(const K& key) const {
+            // Mix the hash so keys whose low bits look alike, like snowflakes, still spread over the stripes.
+            uint64_t hash = static_cast<uint64_t>(typename Map::hasher()(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(hash >> 32) % StripeCount;
+        }
+
+        Stripe& GetStripe(const K& key) {
+            return stripes[GetStripeIndex(key)];
+        }
+
+        const Stripe& GetStripe(const K& key) const {
+            return stripes[GetStripeIndex(key)];
+        }
+    };
+}
+
+#endif
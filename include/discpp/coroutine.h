@@ -0,0 +1,212 @@
+#ifndef DISCPP_COROUTINE_H
+#define DISCPP_COROUTINE_H
+
+#ifdef DISCPP_COROUTINES
+
+#include "task.h"
+#include "client.h"
+#include "event_handler.h"
+#include "utils.h"
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+namespace discpp {
+    /**
+     * @brief Awaits the next event that matches a predicate, see discpp::Client::WaitFor.
+     *
+     * Awaiting it gives the event, or nullptr if the timeout passed first. The coroutine is resumed on the
+     * client's worker threads.
+     */
+    template<typename T>
+    class EventAwaiter {
+    public:
+        using Predicate = std::function<bool(const T&)>;
+
+        EventAwaiter(Client& client, Predicate predicate, std::chrono::milliseconds timeout) : state(std::make_shared<State>()), timeout(timeout) {
+            static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
+
+            state->client = &client;
+            state->predicate = std::move(predicate);
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            // The coroutine, and this awaiter with it, can be resumed and gone as soon as the lock is released, so
+            // only the state is used from here on.
+            std::shared_ptr<State> state = this->state;
+            std::chrono::milliseconds timeout = this->timeout;
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->awaiting = awaiting;
+            state->listener = EventHandler<T>::RegisterListener(typename EventHandler<T>::SharedListener([state](const std::shared_ptr<const T>& event) {
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (state->finished || (state->predicate && !state->predicate(*event))) return;
+
+                    state->finished = true;
+                    state->event = event;
+                }
+                state->Resume();
+            }));
+
+            if (timeout > std::chrono::milliseconds::zero()) {
+                state->client->DoFunctionAfter(timeout, [state] {
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (state->finished) return;
+
+                        state->finished = true;
+                    }
+                    state->Resume();
+                });
+            }
+        }
+
+        std::shared_ptr<const T> await_resume() noexcept {
+            return std::move(state->event);
+        }
+    private:
+        struct State {
+            Client* client = nullptr;
+            Predicate predicate;
+
+            std::mutex mutex;
+            bool finished = false;
+            std::shared_ptr<const T> event;
+            EventListenerHandle listener;
+            std::coroutine_handle<> awaiting;
+
+            void Resume() {
+                EventHandler<T>::RemoveListener(listener);
+
+                std::coroutine_handle<> resume = awaiting;
+                client->DoFunctionLater([resume] { resume.resume(); });
+            }
+        };
+
+        std::shared_ptr<State> state;
+        std::chrono::milliseconds timeout;
+    };
+
+    template<typename T>
+    EventAwaiter<T> Client::WaitFor(std::function<bool(const T&)> predicate, std::chrono::milliseconds timeout) {
+        return EventAwaiter<T>(*this, std::move(predicate), timeout);
+    }
+
+    /**
+     * @brief Awaits a blocking function run on the client's worker threads, see discpp::RunOnExecutor.
+     */
+    template<typename F>
+    class ExecutorAwaiter {
+    public:
+        using Result = std::invoke_result_t<F&>;
+
+        explicit ExecutorAwaiter(F function) : function(std::move(function)) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            globals::client_instance->DoFunctionLater([this, awaiting] {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        function();
+                        result.emplace();
+                    } else {
+                        result.emplace(function());
+                    }
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+
+                awaiting.resume();
+            });
+        }
+
+        Result await_resume() {
+            if (exception) std::rethrow_exception(exception);
+            if constexpr (!std::is_void_v<Result>) return std::move(*result);
+        }
+    private:
+        F function;
+        std::optional<std::conditional_t<std::is_void_v<Result>, std::monostate, Result>> result;
+        std::exception_ptr exception;
+    };
+
+    /**
+     * @brief Runs a blocking function on the client's worker threads and resumes the coroutine there once it returns.
+     *
+     * ```cpp
+     *      discpp::User user = co_await discpp::RunOnExecutor([&] { return bot.GetUser(id); });
+     * ```
+     *
+     * @param[in] function The function to run, what it captures by reference must outlive the co_await.
+     *
+     * @return discpp::ExecutorAwaiter
+     */
+    template<typename F>
+    ExecutorAwaiter<F> RunOnExecutor(F function) {
+        return ExecutorAwaiter<F>(std::move(function));
+    }
+
+    /**
+     * @brief Coroutine version of discpp::SendGetRequest, the request is sent from the client's worker threads.
+     *
+     * ```cpp
+     *      std::unique_ptr<rapidjson::Document> response = co_await discpp::SendGetRequestAsync(url, discpp::DefaultHeaders(), object, discpp::RateLimitBucketType::CHANNEL);
+     * ```
+     *
+     * @param[in] url The url to create a request to.
+     * @param[in] headers The http header.
+     * @param[in] object The object id to handle the ratelimits for.
+     * @param[in] ratelimit_bucket The rate limit bucket that Discord will check for this request.
+     * @param[in] body The body of the request.
+     *
+     * @return discpp::Task<std::unique_ptr<rapidjson::Document>>
+     */
+    Task<std::unique_ptr<rapidjson::Document>> SendGetRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body = {});
+
+    /**
+     * @brief Coroutine version of discpp::SendPostRequest, see discpp::SendGetRequestAsync.
+     *
+     * @return discpp::Task<std::unique_ptr<rapidjson::Document>>
+     */
+    Task<std::unique_ptr<rapidjson::Document>> SendPostRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body = {});
+
+    /**
+     * @brief Coroutine version of discpp::SendPutRequest, see discpp::SendGetRequestAsync.
+     *
+     * @return discpp::Task<std::unique_ptr<rapidjson::Document>>
+     */
+    Task<std::unique_ptr<rapidjson::Document>> SendPutRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body = {});
+
+    /**
+     * @brief Coroutine version of discpp::SendPatchRequest, see discpp::SendGetRequestAsync.
+     *
+     * @return discpp::Task<std::unique_ptr<rapidjson::Document>>
+     */
+    Task<std::unique_ptr<rapidjson::Document>> SendPatchRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body = {});
+
+    /**
+     * @brief Coroutine version of discpp::SendDeleteRequest, see discpp::SendGetRequestAsync.
+     *
+     * @return discpp::Task<std::unique_ptr<rapidjson::Document>>
+     */
+    Task<std::unique_ptr<rapidjson::Document>> SendDeleteRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket);
+}
+
+#endif
+
+#endif
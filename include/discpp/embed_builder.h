@@ -45,7 +45,7 @@ namespace discpp {
          *
          * @return discpp::EmbedBuilder, this is a constructor.
          */
-        EmbedBuilder(rapidjson::Document& json);
+        EmbedBuilder(const rapidjson::Value& json);
 
         EmbedBuilder(const discpp::EmbedBuilder& embed);
         EmbedBuilder operator=(const EmbedBuilder embed) {
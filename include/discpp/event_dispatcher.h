@@ -4,57 +4,83 @@
 #include "event.h"
 #include "utils.h"
 #include "client.h"
+#include "gateway_event.h"
+#include <array>
+#include <atomic>
 #include <string>
 #include <future>
 #include <string_view>
 #include <optional>
+#include <shared_mutex>
 #include <vector>
 
 namespace discpp {
 	class EventDispatcher {
 	private:
-	    inline static std::unordered_map<std::string, std::function<void(Shard& shard, rapidjson::Document&)>> internal_event_map = {};
+	    inline static std::array<std::function<void(Shard& shard, const rapidjson::Value&)>, kGatewayEventCount> event_handlers = {};
+	    inline static std::unordered_map<std::string, std::function<void(Shard& shard, const rapidjson::Value&)>> custom_event_map = {}; /**< Handlers of events that aren't a discpp::GatewayEvent. */
+	    inline static std::shared_mutex handlers_mutex; /**< Guards event_handlers and custom_event_map, handlers can be registered while events are handled. */
+	    inline static std::array<std::atomic<uint64_t>, kGatewayEventCount> event_counts = {};
         static std::unordered_map<int, rapidjson::Document> json_docs;
 
-		static void ReadyEvent(Shard& shard, rapidjson::Document& result);
-        static void ResumedEvent(Shard& shard, rapidjson::Document& result);
-        static void ReconnectEvent(Shard& shard, rapidjson::Document& result);
-        static void InvalidSessionEvent(Shard& shard, rapidjson::Document& result);
-        static void ChannelCreateEvent(Shard& shard, rapidjson::Document& result);
-        static void ChannelUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void ChannelDeleteEvent(Shard& shard, rapidjson::Document& result);
-        static void ChannelPinsUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildCreateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildDeleteEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildBanAddEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildBanRemoveEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildEmojisUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildIntegrationsUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildMemberAddEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildMemberRemoveEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildMemberUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildMembersChunkEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildRoleCreateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildRoleUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void GuildRoleDeleteEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageCreateEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageDeleteEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageDeleteBulkEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageReactionAddEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageReactionRemoveEvent(Shard& shard, rapidjson::Document& result);
-        static void MessageReactionRemoveAllEvent(Shard& shard, rapidjson::Document& result);
-        static void PresenceUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void TypingStartEvent(Shard& shard, rapidjson::Document& result);
-        static void UserUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void VoiceStateUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void VoiceServerUpdateEvent(Shard& shard, rapidjson::Document& result);
-        static void WebhooksUpdateEvent(Shard& shard, rapidjson::Document& result);
+		static void MarkShardReady(Shard& shard);
+        static void SetClientUser(const rapidjson::Value* user); /**< Only the first call sets discpp::Client::client_user, requests it if `user` is null. */
+        static bool WantsCommand(const rapidjson::Value& message); /**< If the command handler could do something with a message, without building it first. */
+        static uint64_t GetStrandKey(const rapidjson::Value& data, GatewayEvent event);
+        static uint64_t GetObjectKey(const rapidjson::Value& data); /**< The object an event is about, for coalescing queued events. */
+
+		static void ReadyEvent(Shard& shard, const rapidjson::Value& result);
+        static void ResumedEvent(Shard& shard, const rapidjson::Value& result);
+        static void ReconnectEvent(Shard& shard, const rapidjson::Value& result);
+        static void InvalidSessionEvent(Shard& shard, const rapidjson::Value& result);
+        static void ChannelCreateEvent(Shard& shard, const rapidjson::Value& result);
+        static void ChannelUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void ChannelDeleteEvent(Shard& shard, const rapidjson::Value& result);
+        static void ChannelPinsUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildCreateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildDeleteEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildBanAddEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildBanRemoveEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildEmojisUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildIntegrationsUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildMemberAddEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildMemberRemoveEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildMemberUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildMembersChunkEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildRoleCreateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildRoleUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void GuildRoleDeleteEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageCreateEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageDeleteEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageDeleteBulkEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageReactionAddEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageReactionRemoveEvent(Shard& shard, const rapidjson::Value& result);
+        static void MessageReactionRemoveAllEvent(Shard& shard, const rapidjson::Value& result);
+        static void PresenceUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void TypingStartEvent(Shard& shard, const rapidjson::Value& result);
+        static void UserUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void VoiceStateUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void VoiceServerUpdateEvent(Shard& shard, const rapidjson::Value& result);
+        static void WebhooksUpdateEvent(Shard& shard, const rapidjson::Value& result);
 	public:
         static void BindEvents();
-		static void HandleDiscordEvent(Shard& shard, rapidjson::Document& j, const std::string& event_name);
-        static void RegisterGatewayCustomEvent(const char* event_name, const std::function<void(Shard& shard, const rapidjson::Document&)>& func);
+		static void HandleDiscordEvent(Shard& shard, std::shared_ptr<rapidjson::Document> frame);
+        static void RegisterGatewayCustomEvent(const char* event_name, const std::function<void(Shard& shard, const rapidjson::Value&)>& func);
+
+        /**
+         * @brief Get how many times an event was received by every shard.
+         *
+         * ```cpp
+         *      uint64_t messages = discpp::EventDispatcher::GetEventCount(discpp::GatewayEvent::MESSAGE_CREATE);
+         * ```
+         *
+         * @param[in] event The event, discpp::GatewayEvent::UNKNOWN counts every event discpp doesn't handle.
+         *
+         * @return uint64_t
+         */
+        static uint64_t GetEventCount(GatewayEvent event);
 	};
 }
 
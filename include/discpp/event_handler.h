@@ -6,23 +6,54 @@
 #include "client.h"
 #include "log.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <climits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace discpp {
 	struct EventListenerHandle {
 		unsigned int id = UINT_MAX;
 	};
 
+	enum class BatchScope {
+		GLOBAL, /**< One batch for the events of every shard. */
+		PER_SHARD /**< A batch for every shard, see discpp::Shard::GetCurrent. */
+	};
+
+	/**
+	 * @brief When the events of a batch listener are delivered, see discpp::EventHandler::RegisterBatchListener.
+	 */
+	struct BatchOptions {
+		size_t max_events = 100; /**< A batch is delivered as soon as it has this many events. */
+		std::chrono::milliseconds max_delay = std::chrono::milliseconds(1000); /**< A batch is delivered this long after its first event, zero only delivers full batches. */
+		BatchScope scope = BatchScope::GLOBAL;
+	};
+
 	template<typename T>
 	class EventHandler {
 	public:
 		using IdType = unsigned int;
+		using SharedListener = std::function<void(const std::shared_ptr<const T>&)>;
+		using BatchListener = std::function<void(const std::vector<std::shared_ptr<const T>>&)>;
+
+		struct Listener {
+			IdType id;
+			std::shared_ptr<const SharedListener> function;
+			bool run_inline; /**< Called on the dispatching thread instead of getting a task, only for listeners that return right away. */
+		};
+		using ListenerList = std::vector<Listener>;
 
 		static EventListenerHandle RegisterListener(const std::function<void(const T&)>& listener) {
 			/**
 			 * @brief Registers an event listener.
 			 *
-			 * The given event class must derive from discpp::Event
+			 * The given event class must derive from discpp::Event. Every listener is given the same event object, it's
+			 * only valid until the listener returns, use the std::shared_ptr overload to keep it longer.
 			 *
 			 * ```cpp
 			 *      discpp::EventHandler<discpp::ChannelPinsUpdateEvent>::RegisterListener([](discpp::ChannelPinsUpdateEvent event)->bool {
@@ -39,11 +70,61 @@ namespace discpp {
 			// Make sure that the given event class derives from discpp::Event
 			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
 
-			discpp::globals::client_instance->logger->Debug(LogTextColor::GREEN + "Event listener registered: " + typeid(T).name());
+			return RegisterListener(SharedListener([listener](const std::shared_ptr<const T>& event) {
+				listener(*event);
+			}));
+		}
 
-			auto id = GetNextId();
-			GetHandlers()[id] = listener;
-			return EventListenerHandle{ id };
+		static EventListenerHandle RegisterListener(const SharedListener& listener) {
+			/**
+			 * @brief Registers an event listener that shares ownership of the event.
+			 *
+			 * The given event class must derive from discpp::Event. The event can be kept after the listener returns,
+			 * it's shared by every listener so it can't be changed.
+			 *
+			 * ```cpp
+			 *      discpp::EventHandler<discpp::MessageCreateEvent>::RegisterListener([](const std::shared_ptr<const discpp::MessageCreateEvent>& event) {
+			 *			last_message = event;
+			 *		});
+			 * ```
+			 *
+			 * @param[in] listener The code to execute when the event gets dispatched.
+			 *
+			 * @return discpp::EventListenerhandle
+			 */
+
+			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
+
+			return AddListener(listener, false);
+		}
+
+		static EventListenerHandle RegisterBatchListener(const BatchListener& listener, const BatchOptions& options = {}) {
+			/**
+			 * @brief Registers an event listener that is given the events in batches.
+			 *
+			 * The given event class must derive from discpp::Event. Events are collected without starting a task for
+			 * each of them, a batch gets one task once it has `max_events` events or once `max_delay` has passed since
+			 * its first event. Batches can be delivered at the same time, and events that are still collected when
+			 * the listener is removed are dropped.
+			 *
+			 * ```cpp
+			 *      discpp::EventHandler<discpp::MessageCreateEvent>::RegisterBatchListener([](const std::vector<std::shared_ptr<const discpp::MessageCreateEvent>>& events) {
+			 *			database.InsertMessages(events);
+			 *		}, { 500, std::chrono::seconds(5), discpp::BatchScope::PER_SHARD });
+			 * ```
+			 *
+			 * @param[in] listener The code to execute with every batch.
+			 * @param[in] options When batches are delivered and if every shard gets its own.
+			 *
+			 * @return discpp::EventListenerhandle
+			 */
+
+			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
+
+			auto batcher = std::make_shared<Batcher>(listener, options);
+			return AddListener(SharedListener([batcher](const std::shared_ptr<const T>& event) {
+				batcher->Add(event);
+			}), true);
 		}
 
 		static void RemoveListener(const EventListenerHandle& handle) {
@@ -70,14 +151,39 @@ namespace discpp {
 
 			discpp::globals::client_instance->logger->Debug("Event listener removed: " + std::string(typeid(T).name()));
 
-			GetHandlers().erase(handle.id);
+			UpdateListeners([&](ListenerList& listeners) {
+				listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [&](const Listener& listener) {
+					return listener.id == handle.id;
+				}), listeners.end());
+			});
 		}
 
-		static void TriggerEvent(const T& e) {
+		static void TriggerEvent(const std::shared_ptr<const T>& e) {
 			/**
 			 * @brief Triggers an event.
 			 *
-			 * The given event class must derive from discpp::Event. The event will be thrown on another thread.
+			 * The given event class must derive from discpp::Event. The event will be thrown on another thread, every
+			 * listener gets the same event object.
+			 *
+			 * ```cpp
+			 *      discpp::EventHandler<discpp::MessageCreateEvent>::TriggerEvent(std::make_shared<const discpp::MessageCreateEvent>(created_message));
+			 * ```
+			 *
+			 * @param[in] e The event to trigger.
+			 *
+			 * @return void
+			 */
+
+			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
+
+			if (GetListenerCount() == 0) return;
+
+			Dispatch(*GetListeners(), e);
+		}
+
+		static void TriggerEvent(T&& e) {
+			/**
+			 * @brief Triggers an event, moving it into the object every listener shares.
 			 *
 			 * ```cpp
 			 *      discpp::EventHandler<discpp::MessageCreateEvent>::TriggerEvent(discpp::MessageCreateEvent(created_message));
@@ -88,28 +194,216 @@ namespace discpp {
 			 * @return void
 			 */
 
+			// Nothing is allocated for events no one listens to.
+			if (GetListenerCount() == 0) return;
+
+			std::shared_ptr<const ListenerList> listeners = GetListeners();
+			if (listeners->empty()) return;
+
+			Dispatch(*listeners, std::make_shared<const T>(std::move(e)));
+		}
+
+		static void TriggerEvent(const T& e) {
+			/**
+			 * @brief Triggers an event, copying it once into the object every listener shares.
+			 *
+			 * @param[in] e The event to trigger.
+			 *
+			 * @return void
+			 */
+
+			if (GetListenerCount() == 0) return;
+
+			std::shared_ptr<const ListenerList> listeners = GetListeners();
+			if (listeners->empty()) return;
+
+			Dispatch(*listeners, std::make_shared<const T>(e));
+		}
+
+		static size_t GetListenerCount() {
+			/**
+			 * @brief Get the amount of listeners registered for this event.
+			 *
+			 * ```cpp
+			 *      if (discpp::EventHandler<discpp::TypingStartEvent>::GetListenerCount() == 0) return;
+			 * ```
+			 *
+			 * @return size_t
+			 */
+
 			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
 
-			discpp::globals::client_instance->logger->Debug("Event listener triggered: " + std::string(typeid(T).name()));
+			return GetListenerCounter().load(std::memory_order_acquire);
+		}
 
-			for (std::pair<IdType, std::function<void(const T&)>> handler : GetHandlers()) {
-                discpp::globals::client_instance->DoFunctionLater(handler.second, e);
+	private:
+		// Collects the events of a batch listener until a batch is due.
+		class Batcher : public std::enable_shared_from_this<Batcher> {
+		public:
+			Batcher(const BatchListener& listener, const BatchOptions& options) : listener(listener), options(options) {}
+
+			void Add(const std::shared_ptr<const T>& event) {
+				Shard* shard = options.scope == BatchScope::PER_SHARD ? Shard::GetCurrent() : nullptr;
+				int key = shard ? shard->id : -1;
+
+				std::vector<std::shared_ptr<const T>> batch;
+				bool first = false;
+				uint64_t generation = 0;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					Batch& pending = batches[key];
+					pending.events.push_back(event);
+					if (pending.events.size() >= options.max_events) {
+						batch.swap(pending.events);
+						pending.generation++;
+					} else {
+						first = pending.events.size() == 1;
+						generation = pending.generation;
+					}
+				}
+
+				if (!batch.empty()) {
+					discpp::globals::client_instance->DoFunctionLater([self = this->shared_from_this(), batch = std::move(batch)] {
+						self->listener(batch);
+					});
+				} else if (first && options.max_delay > std::chrono::milliseconds::zero()) {
+					// The timer doesn't keep the batcher alive, a removed listener isn't given any more batches.
+					discpp::globals::client_instance->DoFunctionAfter(options.max_delay, [weak = this->weak_from_this(), key, generation] {
+						if (auto self = weak.lock()) self->Flush(key, generation);
+					});
+				}
 			}
+		private:
+			struct Batch {
+				std::vector<std::shared_ptr<const T>> events;
+				uint64_t generation = 0; /**< Increased when the batch is delivered, so timers of earlier batches don't deliver it early. */
+			};
+
+			BatchListener listener;
+			BatchOptions options;
+
+			std::mutex mutex;
+			std::unordered_map<int, Batch> batches;
+
+			void Flush(int key, uint64_t generation) {
+				std::vector<std::shared_ptr<const T>> batch;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					Batch& pending = batches[key];
+					if (pending.generation != generation || pending.events.empty()) return;
+
+					batch.swap(pending.events);
+					pending.generation++;
+				}
+
+				listener(batch);
+			}
+		};
+
+		static EventListenerHandle AddListener(const SharedListener& listener, bool run_inline) {
+			discpp::globals::client_instance->logger->Debug(LogTextColor::GREEN + "Event listener registered: " + typeid(T).name());
+
+			auto id = GetNextId();
+			auto shared_listener = std::make_shared<const SharedListener>(listener);
+			UpdateListeners([&](ListenerList& listeners) {
+				listeners.push_back(Listener{ id, std::move(shared_listener), run_inline });
+			});
+			return EventListenerHandle{ id };
 		}
 
-	private:
 		static IdType GetNextId() {
 			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
 
-			static IdType id = 0;
+			static std::atomic<IdType> id { 0 };
 			return ++id;
 		}
 
-		static std::unordered_map<IdType, std::function<void(const T&)>>& GetHandlers() {
+		static void Dispatch(const ListenerList& listeners, const std::shared_ptr<const T>& e) {
+			if (discpp::globals::client_instance->logger->IsDebugEnabled()) {
+				discpp::globals::client_instance->logger->Debug("Event listener triggered: " + std::string(typeid(T).name()));
+			}
+
+			// Tasks hold on to the listener, so removing it while it's running is safe.
+			for (const Listener& listener : listeners) {
+				if (listener.run_inline) {
+					(*listener.function)(e);
+					continue;
+				}
+
+				discpp::globals::client_instance->DoFunctionLater([listener = listener.function, e] {
+					(*listener)(e);
+				});
+			}
+		}
+
+		/*
+		 * The listeners are an immutable list that is replaced as a whole when a listener is registered or removed.
+		 * Dispatching only loads the current list, it never waits for a registration to finish copying, and a list
+		 * stays alive while anything is still iterating it.
+		 *
+		 * Loading the list isn't lock-free. std::atomic<std::shared_ptr> is used where the library has it, which
+		 * libstdc++ implements with a lock in the pointer itself, and a mutex per event type is used otherwise. The
+		 * shared_ptr atomic functions are deprecated since C++20, so they aren't used. Either way the lock is only
+		 * held long enough to copy the pointer, and events without listeners don't touch it, GetListenerCount is a
+		 * plain atomic that is checked first.
+		 */
+#ifdef __cpp_lib_atomic_shared_ptr
+		using ListenerSnapshot = std::atomic<std::shared_ptr<const ListenerList>>;
+#else
+		struct ListenerSnapshot {
+			std::mutex mutex;
+			std::shared_ptr<const ListenerList> listeners;
+		};
+#endif
+
+		static std::shared_ptr<const ListenerList> GetListeners() {
+			ListenerSnapshot& snapshot = GetListenerSnapshot();
+#ifdef __cpp_lib_atomic_shared_ptr
+			return snapshot.load(std::memory_order_acquire);
+#else
+			std::lock_guard<std::mutex> lock(snapshot.mutex);
+			return snapshot.listeners;
+#endif
+		}
+
+		template<typename F>
+		static void UpdateListeners(F&& update) {
+			// Writers copy the current list, so they have to take turns or one could drop the other's change.
+			static std::mutex write_mutex;
+			std::lock_guard<std::mutex> lock(write_mutex);
+
+			auto listeners = std::make_shared<ListenerList>(*GetListeners());
+			update(*listeners);
+
+			size_t count = listeners->size();
+			ListenerSnapshot& snapshot = GetListenerSnapshot();
+#ifdef __cpp_lib_atomic_shared_ptr
+			snapshot.store(std::shared_ptr<const ListenerList>(std::move(listeners)), std::memory_order_release);
+#else
+			{
+				std::lock_guard<std::mutex> snapshot_lock(snapshot.mutex);
+				snapshot.listeners = std::move(listeners);
+			}
+#endif
+			GetListenerCounter().store(count, std::memory_order_release);
+		}
+
+		static std::atomic<size_t>& GetListenerCounter() {
+			static std::atomic<size_t> count { 0 };
+			return count;
+		}
+
+		static ListenerSnapshot& GetListenerSnapshot() {
 			static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
 
-			static std::unordered_map<IdType, std::function<void(const T&)>> handlers;
-			return handlers;
+#ifdef __cpp_lib_atomic_shared_ptr
+			static ListenerSnapshot snapshot { std::make_shared<const ListenerList>() };
+#else
+			static ListenerSnapshot snapshot { {}, std::make_shared<const ListenerList>() };
+#endif
+			return snapshot;
 		}
 	};
 
@@ -124,11 +418,11 @@ namespace discpp {
 
 	// For convenience
 	template<typename T>
-	void DispatchEvent(const T& t) {
+	void DispatchEvent(T t) {
 		/**
 		 * @brief Dispatches an event, shorter than using TriggerEvent.
 		 *
-		 * The given event class must derive from discpp::Event.
+		 * The given event class must derive from discpp::Event. The event is moved into the object the listeners share.
 		 *
 		 * ```cpp
 		 *      DispatchEvent(discpp::MessageCreateEvent(created_message));
@@ -141,7 +435,7 @@ namespace discpp {
 
 		static_assert(std::is_base_of_v<Event, T>, "Event class must derive from discpp::Event");
 
-		EventHandler<T>::TriggerEvent(t);
+		EventHandler<T>::TriggerEvent(std::move(t));
 	}
 
 	// To let the caller pass pointers as the event object
@@ -165,6 +459,21 @@ namespace discpp {
 
 		DispatchEvent<T>(*t);
 	}
+
+	template<typename... T>
+	bool HasListeners() {
+		/**
+		 * @brief Check if any of the events has a listener, so work that only feeds listeners can be skipped.
+		 *
+		 * ```cpp
+		 *      if (discpp::HasListeners<discpp::GuildBanAddEvent, discpp::GuildBanRemoveEvent>()) intents |= discpp::GatewayIntents::GUILD_BANS;
+		 * ```
+		 *
+		 * @return bool
+		 */
+
+		return ((EventHandler<T>::GetListenerCount() != 0) || ...);
+	}
 }
 
 #endif
\ No newline at end of file
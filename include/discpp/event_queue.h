@@ -0,0 +1,150 @@
+#ifndef DISCPP_EVENT_QUEUE_H
+#define DISCPP_EVENT_QUEUE_H
+
+#include "strand.h"
+#include "gateway_event.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace discpp {
+    /**
+     * @brief What happens to an event that arrives while its queue is full.
+     */
+    enum class OverflowPolicy {
+        BLOCK, /**< The shard stops reading until the queue has room, so nothing is lost but the whole shard is slowed down. */
+        DROP_OLDEST, /**< The oldest event in the queue is dropped to make room. */
+        DROP_NEWEST, /**< The event that arrived is dropped. */
+        COALESCE /**< An event replaces the queued event of the same object instead of being queued after it, otherwise it's dropped when the queue is full. Only use this for events where the latest one is all that matters, like PRESENCE_UPDATE. */
+    };
+
+    /**
+     * @brief The limit of the queue of one gateway event, see discpp::ClientConfig::event_queues.
+     *
+     * ```cpp
+     *      config->event_queues[discpp::GatewayEvent::TYPING_START] = { 500, discpp::OverflowPolicy::DROP_NEWEST };
+     * ```
+     */
+    struct EventQueueLimit {
+        size_t capacity = 0; /**< The amount of events that can be waiting to be handled, zero means no limit. */
+        OverflowPolicy policy = OverflowPolicy::BLOCK;
+    };
+
+    /**
+     * @brief The metrics of the queue of one gateway event.
+     */
+    struct EventQueueStats {
+        size_t depth = 0; /**< The events waiting to be handled. */
+        uint64_t dropped = 0; /**< The events dropped because the queue was full. */
+        uint64_t coalesced = 0; /**< The events that replaced a queued event. */
+        uint64_t blocked = 0; /**< The times a shard had to wait for room in the queue. */
+    };
+
+    /**
+     * @brief Bounds the amount of events of each type that are waiting to be handled.
+     *
+     * Events are still handled on the strands they're posted to, this only decides if they're let in. Events
+     * without a limit go to the strands directly and are only counted.
+     *
+     * ```cpp
+     *      discpp::EventQueues queues(strands);
+     *      queues.SetLimit(discpp::GatewayEvent::TYPING_START, { 500, discpp::OverflowPolicy::DROP_NEWEST });
+     *      queues.Post(discpp::GatewayEvent::TYPING_START, guild_id, user_id, [] { ... });
+     * ```
+     */
+    class EventQueues {
+    public:
+        /**
+         * @param[in] strands The strands the events are handled on, they must outlive the queues' tasks.
+         */
+        explicit EventQueues(StrandExecutor& strands);
+
+        /**
+         * @brief Sets the limit of an event's queue. It has to be set before any events are posted.
+         *
+         * @param[in] event The event.
+         * @param[in] limit The limit and what to do when it's reached.
+         *
+         * @return void
+         */
+        void SetLimit(GatewayEvent event, EventQueueLimit limit);
+
+        /**
+         * @brief Check if queued events of this type are replaced by newer ones, the object key only matters then.
+         *
+         * @param[in] event The event.
+         *
+         * @return bool
+         */
+        bool Coalesces(GatewayEvent event) const;
+
+        /**
+         * @brief Queues the handling of an event on a strand, unless the queue's policy drops it.
+         *
+         * With discpp::OverflowPolicy::BLOCK this waits until the queue has room, so it must not be called from
+         * the strands or the pool they run on.
+         *
+         * @param[in] event The event.
+         * @param[in] strand_key The strand to handle the event on.
+         * @param[in] object_key The object the event is about, events with the same strand and object replace each other when coalescing. Zero never coalesces.
+         * @param[in] task Handles the event.
+         *
+         * @return bool, false if the event was dropped.
+         */
+        bool Post(GatewayEvent event, uint64_t strand_key, uint64_t object_key, ThreadPool::Task task);
+
+        /**
+         * @brief Lets blocked shards continue, the limits aren't enforced anymore after this.
+         *
+         * @return void
+         */
+        void Stop();
+
+        /**
+         * @brief Get the metrics of an event's queue.
+         *
+         * @param[in] event The event.
+         *
+         * @return discpp::EventQueueStats
+         */
+        EventQueueStats GetStats(GatewayEvent event) const;
+    private:
+        struct Slot;
+        using SlotList = std::list<std::shared_ptr<Slot>>;
+
+        struct Slot {
+            ThreadPool::Task task; /**< Empty once the event is running or was dropped. */
+            std::pair<uint64_t, uint64_t> key;
+            SlotList::iterator position;
+        };
+
+        struct Queue {
+            EventQueueLimit limit;
+
+            mutable std::mutex mutex;
+            std::condition_variable room;
+            SlotList pending; /**< Oldest first. */
+            std::map<std::pair<uint64_t, uint64_t>, std::shared_ptr<Slot>> by_key;
+
+            std::atomic<size_t> depth { 0 };
+            std::atomic<uint64_t> dropped { 0 };
+            std::atomic<uint64_t> coalesced { 0 };
+            std::atomic<uint64_t> blocked { 0 };
+        };
+
+        StrandExecutor& strands;
+        std::array<Queue, kGatewayEventCount> queues;
+        std::atomic<bool> stopping { false };
+
+        void Remove(Queue& queue, Slot& slot);
+        void Run(Queue& queue, const std::shared_ptr<Slot>& slot);
+    };
+}
+
+#endif
@@ -14,7 +14,7 @@ namespace discpp {
             payload.CopyFrom(ready_event.payload, payload.GetAllocator());
         }
 
-		inline ReadyEvent(rapidjson::Document& json) {
+		inline ReadyEvent(const rapidjson::Value& json) {
 		    /*payload->SetObject();
 		    payload->CopyFrom(json, payload->GetAllocator());*/
 
@@ -7,9 +7,15 @@
 namespace discpp {
 	class VoiceServerUpdateEvent : public Event {
 	public:
-		inline VoiceServerUpdateEvent(rapidjson::Document& json) : json(json) { }
+		VoiceServerUpdateEvent(const discpp::VoiceServerUpdateEvent& event) {
+		    json.CopyFrom(event.json, json.GetAllocator());
+		}
 
-		rapidjson::Document& json;
+		inline VoiceServerUpdateEvent(const rapidjson::Value& json) {
+		    this->json.CopyFrom(json, this->json.GetAllocator());
+		}
+
+		rapidjson::Document json;
 	};
 }
 
@@ -7,9 +7,16 @@
 namespace discpp {
 	class VoiceStateUpdateEvent : public Event {
 	public:
-		inline VoiceStateUpdateEvent(rapidjson::Document& json) : json(json) { }
+		VoiceStateUpdateEvent(const discpp::VoiceStateUpdateEvent& event) {
+		    json.CopyFrom(event.json, json.GetAllocator());
+		}
 
-		rapidjson::Document& json;
+		// Listeners run after the gateway payload is gone, so the event keeps its own copy of the data.
+		inline VoiceStateUpdateEvent(const rapidjson::Value& json) {
+		    this->json.CopyFrom(json, this->json.GetAllocator());
+		}
+
+		rapidjson::Document json;
 	};
 }
 
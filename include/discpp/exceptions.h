@@ -92,6 +92,20 @@ namespace discpp {
             explicit InvalidAPIVersionException(const std::string &str) : std::runtime_error(str) {}
         };
 
+        class DecompressionException : public std::runtime_error {
+        public:
+            explicit DecompressionException(const std::string &str) : std::runtime_error(str) {}
+        };
+
+        class PayloadDecodeException : public std::runtime_error {
+        public:
+            explicit PayloadDecodeException(const std::string &str) : std::runtime_error(str) {}
+        };
+        class RecordingException : public std::runtime_error {
+        public:
+            explicit RecordingException(const std::string &str) : std::runtime_error(str) {}
+        };
+
         namespace http {
             class HTTPResponseException : public std::runtime_error {
             public:
@@ -0,0 +1,124 @@
+#ifndef DISCPP_GATEWAY_CODEC_H
+#define DISCPP_GATEWAY_CODEC_H
+
+#ifndef RAPIDJSON_HAS_STDSTRING
+#define RAPIDJSON_HAS_STDSTRING 1
+#endif
+
+#include <rapidjson/document.h>
+
+#include "client_config.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace discpp {
+    /**
+     * @brief The fields of a gateway payload that say what it is, read without decoding the rest of it.
+     */
+    struct PayloadHeader {
+        int op = -1;
+        int sequence = -1; /**< -1 if the payload doesn't have a sequence number. */
+        std::string_view event_name; /**< Points into the payload, empty if it isn't a dispatch. */
+    };
+
+    /**
+     * @brief Translates gateway payloads between their wire format and the json documents the shards and
+     * event dispatchers work with.
+     *
+     * Every codec produces the same in-memory representation, so nothing past the shard has to know which
+     * encoding the gateway connection is using. The only difference is that ETF sends snowflakes as 64-bit
+     * integers instead of strings, use discpp::GetSnowflake to read them.
+     */
+    class GatewayCodec {
+    public:
+        virtual ~GatewayCodec() = default;
+
+        /**
+         * @brief Decodes a payload received from the gateway.
+         *
+         * @param[in] payload The raw (already decompressed) payload.
+         *
+         * @throws discpp::exceptions::PayloadDecodeException If the payload is malformed.
+         *
+         * @return std::unique_ptr<rapidjson::Document>
+         */
+        virtual std::unique_ptr<rapidjson::Document> Decode(const std::string& payload) = 0;
+
+        /**
+         * @brief Encodes a payload that will be sent to the gateway.
+         *
+         * @param[in] payload The payload to encode.
+         *
+         * @return std::string
+         */
+        virtual std::string Encode(const rapidjson::Value& payload) = 0;
+
+        /**
+         * @brief Reads the `op`, `s` and `t` fields of a payload without decoding `d`.
+         *
+         * This is used to drop events that are ignored before paying for decoding them, see
+         * discpp::ClientConfig::ignored_events. Codecs that can't do this cheaply don't have to, the payload is
+         * then decoded and dropped after.
+         *
+         * @param[in] payload The raw (already decompressed) payload.
+         * @param[out] header The fields that were read, the event name points into the payload.
+         *
+         * @return bool, false if the header couldn't be read, the payload should be decoded as usual then.
+         */
+        virtual bool PeekHeader(const std::string&, PayloadHeader&) { return false; }
+
+        /**
+         * @brief Get the name of this encoding, this is what goes in the gateway url's `encoding` parameter.
+         *
+         * @return const char*
+         */
+        virtual const char* GetEncodingName() const = 0;
+
+        /**
+         * @brief Returns if encoded payloads must be sent as binary websocket frames.
+         *
+         * @return bool
+         */
+        virtual bool IsBinary() const = 0;
+
+        /**
+         * @brief Creates a codec for an encoding.
+         *
+         * ```cpp
+         *      std::unique_ptr<discpp::GatewayCodec> codec = discpp::GatewayCodec::Create(discpp::GatewayEncoding::ETF);
+         * ```
+         *
+         * @param[in] encoding The encoding the codec will use.
+         *
+         * @return std::unique_ptr<discpp::GatewayCodec>
+         */
+        static std::unique_ptr<GatewayCodec> Create(GatewayEncoding encoding);
+    };
+
+    class JsonCodec : public GatewayCodec {
+    public:
+        std::unique_ptr<rapidjson::Document> Decode(const std::string& payload) override;
+        std::string Encode(const rapidjson::Value& payload) override;
+        bool PeekHeader(const std::string& payload, PayloadHeader& header) override;
+        const char* GetEncodingName() const override { return "json"; }
+        bool IsBinary() const override { return false; }
+    };
+
+    /**
+     * @brief Erlang external term format codec.
+     *
+     * Atoms are decoded as strings, except for `nil`, `true` and `false` which become null and booleans. Big
+     * integers that fit in 64 bits (snowflakes) are decoded as 64-bit integers.
+     */
+    class EtfCodec : public GatewayCodec {
+    public:
+        std::unique_ptr<rapidjson::Document> Decode(const std::string& payload) override;
+        std::string Encode(const rapidjson::Value& payload) override;
+        const char* GetEncodingName() const override { return "etf"; }
+        bool IsBinary() const override { return true; }
+    };
+}
+
+#endif
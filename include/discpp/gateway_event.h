@@ -0,0 +1,78 @@
+#ifndef DISCPP_GATEWAY_EVENT_H
+#define DISCPP_GATEWAY_EVENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace discpp {
+    /**
+     * @brief The dispatch events the gateway sends that discpp handles.
+     *
+     * The event name of every dispatch is turned into one of these once when it's received, then they're used
+     * to pick the event's handler and to count events.
+     */
+    enum class GatewayEvent : uint8_t {
+        UNKNOWN = 0, /**< An event discpp doesn't handle, it can still have a custom handler. */
+        READY,
+        RESUMED,
+        INVALID_SESSION,
+        CHANNEL_CREATE,
+        CHANNEL_UPDATE,
+        CHANNEL_DELETE,
+        CHANNEL_PINS_UPDATE,
+        GUILD_CREATE,
+        GUILD_UPDATE,
+        GUILD_DELETE,
+        GUILD_BAN_ADD,
+        GUILD_BAN_REMOVE,
+        GUILD_EMOJIS_UPDATE,
+        GUILD_INTEGRATIONS_UPDATE,
+        GUILD_MEMBER_ADD,
+        GUILD_MEMBER_REMOVE,
+        GUILD_MEMBER_UPDATE,
+        GUILD_MEMBERS_CHUNK,
+        GUILD_ROLE_CREATE,
+        GUILD_ROLE_UPDATE,
+        GUILD_ROLE_DELETE,
+        MESSAGE_CREATE,
+        MESSAGE_UPDATE,
+        MESSAGE_DELETE,
+        MESSAGE_DELETE_BULK,
+        MESSAGE_REACTION_ADD,
+        MESSAGE_REACTION_REMOVE,
+        MESSAGE_REACTION_REMOVE_ALL,
+        PRESENCE_UPDATE,
+        TYPING_START,
+        USER_UPDATE,
+        VOICE_STATE_UPDATE,
+        VOICE_SERVER_UPDATE,
+        WEBHOOKS_UPDATE
+    };
+
+    constexpr size_t kGatewayEventCount = static_cast<size_t>(GatewayEvent::WEBHOOKS_UPDATE) + 1;
+
+    /**
+     * @brief Get the event of a dispatch's event name.
+     *
+     * ```cpp
+     *      discpp::GatewayEvent event = discpp::ParseGatewayEvent(packet["t"].GetString());
+     * ```
+     *
+     * @param[in] name The event name, the `t` field of the dispatch.
+     *
+     * @return discpp::GatewayEvent, discpp::GatewayEvent::UNKNOWN if discpp doesn't handle the event.
+     */
+    GatewayEvent ParseGatewayEvent(std::string_view name);
+
+    /**
+     * @brief Get the name the gateway uses for an event.
+     *
+     * @param[in] event The event.
+     *
+     * @return const char*
+     */
+    const char* GetGatewayEventName(GatewayEvent event);
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef DISCPP_GATEWAY_RECORDER_H
+#define DISCPP_GATEWAY_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace discpp {
+    /**
+     * @brief A frame received from the gateway, as it was captured by discpp::GatewayRecorder.
+     */
+    struct GatewayFrame {
+        enum Flags : uint8_t {
+            BINARY = 1 << 0, /**< The frame was sent as a binary websocket frame. */
+            ZLIB_STREAM = 1 << 1, /**< The connection used zlib-stream transport compression, so the frame must be inflated with the frames before it. */
+            ETF = 1 << 2, /**< The connection used the ETF encoding. */
+            CONNECTED = 1 << 3, /**< The shard connected to the gateway, the frame has no data. */
+        };
+
+        int shard_id = 0;
+        std::chrono::nanoseconds timestamp = std::chrono::nanoseconds(0); /**< Time since the recording started. */
+        uint8_t flags = 0;
+        std::string data; /**< The raw frame, before it was decompressed or decoded. */
+    };
+
+    /**
+     * @brief Appends every frame the shards receive to a binary log so the traffic can be replayed later
+     * with discpp::Client::Replay.
+     *
+     * The log starts with a header and then has a record for each frame, a record is the time since the
+     * previous frame in nanoseconds, the shard id, the frame's flags, the frame's size and its data. Every
+     * number is a LEB128 varint so a record is only a few bytes larger than the frame.
+     *
+     * ```cpp
+     *      config->gateway_recorder = std::make_shared<discpp::GatewayRecorder>("gateway.dpcap");
+     * ```
+     */
+    class GatewayRecorder {
+    public:
+        /**
+         * @brief Creates the log, replacing the file if it already exists.
+         *
+         * @param[in] path The path of the log.
+         *
+         * @throws discpp::exceptions::RecordingException If the file couldn't be opened.
+         */
+        explicit GatewayRecorder(const std::string& path);
+
+        /**
+         * @brief Appends a frame to the log.
+         *
+         * @param[in] shard_id The shard that received the frame.
+         * @param[in] flags The frame's discpp::GatewayFrame::Flags.
+         * @param[in] data The raw frame.
+         *
+         * @return void
+         */
+        void Record(int shard_id, uint8_t flags, const std::string& data);
+
+        /**
+         * @brief Writes the frames that are still buffered to the file.
+         *
+         * @return void
+         */
+        void Flush();
+
+        /**
+         * @brief Get the amount of frames that were recorded.
+         *
+         * @return uint64_t
+         */
+        uint64_t GetFrameCount() const;
+    private:
+        std::ofstream file;
+        mutable std::mutex mutex;
+
+        std::chrono::steady_clock::time_point start_time;
+        std::chrono::nanoseconds last_timestamp = std::chrono::nanoseconds(0);
+        uint64_t frame_count = 0;
+    };
+
+    /**
+     * @brief Reads the frames of a log written by discpp::GatewayRecorder.
+     *
+     * ```cpp
+     *      discpp::GatewayRecordingReader reader("gateway.dpcap");
+     *      discpp::GatewayFrame frame;
+     *      while (reader.Next(frame)) {
+     *          // ...
+     *      }
+     * ```
+     */
+    class GatewayRecordingReader {
+    public:
+        /**
+         * @brief Opens a log.
+         *
+         * @param[in] path The path of the log.
+         *
+         * @throws discpp::exceptions::RecordingException If the file couldn't be opened or isn't a gateway log.
+         */
+        explicit GatewayRecordingReader(const std::string& path);
+
+        /**
+         * @brief Reads the next frame.
+         *
+         * A record that was cut off, which happens if the process was killed while recording, is treated as the
+         * end of the log.
+         *
+         * @param[out] frame The frame that was read.
+         *
+         * @return bool, false if there are no frames left.
+         */
+        bool Next(GatewayFrame& frame);
+    private:
+        std::ifstream file;
+        std::streamoff file_size = 0; /**< Frame sizes are checked against it, so a corrupt size can't allocate more than the file has. */
+        std::chrono::nanoseconds timestamp = std::chrono::nanoseconds(0);
+    };
+}
+
+#endif
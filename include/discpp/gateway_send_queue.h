@@ -0,0 +1,121 @@
+#ifndef DISCPP_GATEWAY_SEND_QUEUE_H
+#define DISCPP_GATEWAY_SEND_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace discpp {
+    enum class GatewaySendLane {
+        PRIORITY, /**< Heartbeats, identifies and resumes. These skip the queue and can use the reserved commands. */
+        NORMAL
+    };
+
+    struct GatewaySendQueueStats {
+        size_t depth = 0; /**< Payloads that are waiting to be sent. */
+        uint64_t sent = 0; /**< Payloads that have been sent. */
+        uint64_t coalesced = 0; /**< Payloads that replaced a queued payload instead of being added. */
+        std::chrono::microseconds average_wait = std::chrono::microseconds(0); /**< Average time payloads spent queued. */
+        std::chrono::microseconds max_wait = std::chrono::microseconds(0); /**< Longest time a payload spent queued. */
+    };
+
+    /**
+     * @brief Outbound gateway payload queue for one shard.
+     *
+     * Discord disconnects a shard that sends more than 120 commands in 60 seconds, so payloads are sent from
+     * this queue's own thread, which remembers when the commands of the last window were sent and never lets any
+     * window hold more than the limit. A few commands of every window are reserved for the priority lane so a
+     * burst of presence updates or member requests can't delay a heartbeat.
+     */
+    class GatewaySendQueue {
+    public:
+        using SendFunction = std::function<void(const std::string& payload)>;
+
+        /**
+         * @brief Creates a send queue and starts its thread.
+         *
+         * @param[in] send Sends a payload on the websocket.
+         * @param[in] commands_per_window The amount of commands that can be sent in a window.
+         * @param[in] window The length of a rate limit window.
+         * @param[in] reserved_commands Commands of each window that only the priority lane can use.
+         *
+         * @return discpp::GatewaySendQueue, this is a constructor.
+         */
+        explicit GatewaySendQueue(SendFunction send, int commands_per_window = 120, std::chrono::milliseconds window = std::chrono::seconds(60), int reserved_commands = 5);
+        ~GatewaySendQueue();
+
+        GatewaySendQueue(const GatewaySendQueue&) = delete;
+        GatewaySendQueue& operator=(const GatewaySendQueue&) = delete;
+
+        /**
+         * @brief Queues a payload to be sent.
+         *
+         * ```cpp
+         *      send_queue.Push(codec->Encode(heartbeat), discpp::GatewaySendLane::PRIORITY);
+         * ```
+         *
+         * @param[in] payload The encoded payload.
+         * @param[in] lane The lane the payload is sent in.
+         * @param[in] coalesce If true, this replaces a queued payload that was also pushed with `coalesce` instead of being added.
+         *
+         * @return void
+         */
+        void Push(std::string payload, GatewaySendLane lane = GatewaySendLane::NORMAL, bool coalesce = false);
+
+        /**
+         * @brief Drops every queued payload and forgets the commands that were sent, call this when a new connection is made.
+         *
+         * @return void
+         */
+        void Reset();
+
+        /**
+         * @brief Stops the queue's thread, anything still queued is dropped.
+         *
+         * @return void
+         */
+        void Stop();
+
+        /**
+         * @brief Get the queue depth and wait time metrics.
+         *
+         * @return discpp::GatewaySendQueueStats
+         */
+        GatewaySendQueueStats GetStats() const;
+    private:
+        struct QueuedPayload {
+            std::string payload;
+            bool coalesce;
+            std::chrono::steady_clock::time_point queued_at;
+        };
+
+        SendFunction send;
+        const size_t commands_per_window;
+        const std::chrono::steady_clock::duration window;
+        const size_t reserved;
+
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<QueuedPayload> priority_queue;
+        std::deque<QueuedPayload> normal_queue;
+        std::deque<std::chrono::steady_clock::time_point> sent_at; /**< When each command of the last window was sent, oldest first. */
+        bool stopped = false;
+
+        uint64_t sent = 0;
+        uint64_t coalesced = 0;
+        std::chrono::microseconds total_wait = std::chrono::microseconds(0);
+        std::chrono::microseconds max_wait = std::chrono::microseconds(0);
+
+        std::thread thread;
+
+        void ForgetExpired(std::chrono::steady_clock::time_point now);
+        void Run();
+    };
+}
+
+#endif
@@ -7,6 +7,8 @@
 #include "permission.h"
 #include "channel.h"
 #include "emoji.h"
+#include "snowflake_map.h"
+#include "concurrent_map.h"
 
 #include <utility>
 #include <variant>
@@ -20,6 +22,14 @@ namespace discpp {
     class AuditLog;
     class User;
 
+    /**
+     * @brief The members of a guild, every copy of the guild shares them.
+     *
+     * Replacing a guild in the cache copies it, so its members are kept out of the copy. Member and presence
+     * events change the map in place, without copying the guild or its other members.
+     */
+    using GuildMembers = ConcurrentMap<Snowflake, std::shared_ptr<Member>, SnowflakeMap<std::shared_ptr<Member>>, 1>;
+
 	struct GuildBan {
         /**
          * @brief Constructs a discpp::GuildBan object.
@@ -60,7 +70,7 @@ namespace discpp {
          *
          * @return discpp::GuildInvite, this is a constructor.
          */
-		GuildInvite(rapidjson::Document& json);
+		GuildInvite(const rapidjson::Value& json);
 
         std::string code; /**< The invite code (unique ID). */
         std::shared_ptr<discpp::Guild> guild; /**< The guild this invite is for. */
@@ -75,7 +85,7 @@ namespace discpp {
 	class IntegrationAccount : public DiscordObject {
 	public:
         IntegrationAccount() = default;
-        IntegrationAccount(rapidjson::Document& json) {
+        IntegrationAccount(const rapidjson::Value& json) {
 
             /**
              * @brief Constructs a discpp::IntegrationAccount object from json.
@@ -88,7 +98,7 @@ namespace discpp {
              *
              * @return discpp::IntegrationAccount, this is a constructor.
              */
-			id = Snowflake(json["id"].GetString());
+			id = discpp::GetSnowflake(json["id"]);
 			name = json["name"].GetString();
 		}
 
@@ -114,7 +124,7 @@ namespace discpp {
          *
          * @return discpp::Integration, this is a constructor.
          */
-        explicit Integration(rapidjson::Document& json);
+        explicit Integration(const rapidjson::Value& json);
 
         std::string name; /**< Integration name. */
         std::string type; /**< Integration type (twitch, youtube, etc). */
@@ -133,7 +143,7 @@ namespace discpp {
 	class GuildEmbed : public DiscordObject {
 	public:
         GuildEmbed() = default;
-		GuildEmbed(rapidjson::Document& json) {
+		GuildEmbed(const rapidjson::Value& json) {
             /**
              * @brief Constructs a discpp::GuildEmbed object from json.
              *
@@ -227,7 +237,7 @@ namespace discpp {
          *
          * @return discpp::Guild, this is a constructor.
          */
-		Guild(rapidjson::Document& json);
+		Guild(const rapidjson::Value& json);
 
         /**
          * @brief Modify the guild.
@@ -948,6 +958,19 @@ namespace discpp {
          */
         std::chrono::system_clock::time_point GetCreatedAt() const;
 
+        /**
+         * @brief Takes what a GUILD_UPDATE payload leaves out from the cached guild this guild replaces.
+         *
+         * The channels, members, voice states, join date, member count and large and unavailable flags only come
+         * with GUILD_CREATE. Roles and emojis are sent in full with every update, so this guild's are kept. The
+         * members are shared with the cached guild.
+         *
+         * @param[in] cached The guild that was cached before the update.
+         *
+         * @return void
+         */
+        void KeepCachedObjects(const discpp::Guild& cached);
+
 		std::string name; /**< Guild name. */
 		Snowflake owner_id; /**< ID of the guild owner. */
 		int permissions; /**< Total permissions for the bot in the guild (does not include channel overrides). */
@@ -957,8 +980,8 @@ namespace discpp {
 		discpp::specials::VerificationLevel verification_level; /**< Verification level required for the guild. */
 		discpp::specials::DefaultMessageNotificationLevel default_message_notifications; /**< Default message notifications level. */
 		discpp::specials::ExplicitContentFilterLevel explicit_content_filter; /**< Explicit content filter level. */
-		std::unordered_map<Snowflake, std::shared_ptr<Role>> roles; /**< Roles in the guild. */
-		std::unordered_map<Snowflake, Emoji> emojis; /**< Custom guild emojis. */
+		SnowflakeMap<std::shared_ptr<Role>> roles; /**< Roles in the guild. */
+		SnowflakeMap<Emoji> emojis; /**< Custom guild emojis. */
 		std::vector<std::string> features; /**< Enabled guild features. */
 		discpp::specials::MFALevel mfa_level; /**< Required MFA level for the guild. */
 		Snowflake application_id; /**< Application id of the guild creator if it is bot-created. */
@@ -970,8 +993,8 @@ namespace discpp {
         std::chrono::system_clock::time_point joined_at; /**< When this guild was joined at. */
 		int member_count; /**< Total number of members in this guild. */
 		std::vector<discpp::VoiceState> voice_states; /**< Array of partial voice state objects. */
-		std::unordered_map<Snowflake, std::shared_ptr<Member>> members; /**< Users in the guild. */
-		std::unordered_map<Snowflake, discpp::Channel> channels; /**< Channels in the guild. */
+		std::shared_ptr<GuildMembers> members = std::make_shared<GuildMembers>(); /**< Users in the guild, shared by every copy of the guild. */
+		SnowflakeMap<discpp::Channel> channels; /**< Channels in the guild. */
 		int max_presences; /**< The maximum amount of presences for the guild (the default value, currently 25000, is in effect when null is returned). */
 		int max_members; /**< The maximum amount of members for the guild. */
 		std::string vanity_url_code; /**< The vanity url code for the guild. */
@@ -1007,7 +1030,7 @@ namespace discpp {
          *
          * @return discpp::VoiceState, this is a constructor.
          */
-        VoiceState(rapidjson::Document& json);
+        VoiceState(const rapidjson::Value& json);
 
         Snowflake guild_id; /**< The guild id this voice state is for. */
         Snowflake channel_id; /**< The channel id this user is connected to. */
@@ -0,0 +1,83 @@
+#ifndef DISCPP_IDENTIFY_SCHEDULER_H
+#define DISCPP_IDENTIFY_SCHEDULER_H
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace discpp {
+    /**
+     * @brief Decides when a shard is allowed to send its identify payload.
+     *
+     * Discord only lets `max_concurrency` shards identify every 5 seconds, where shard `id` belongs to rate
+     * limit bucket `id % max_concurrency`. Shards ask the scheduler before they identify, so a custom
+     * scheduler can be set in discpp::ClientConfig to share the limit between processes that run shards for
+     * the same bot.
+     *
+     * A shard keeps heartbeating while it waits, and never waits on the thread that receives its messages.
+     */
+    class IdentifyScheduler {
+    public:
+        virtual ~IdentifyScheduler() = default;
+
+        /**
+         * @brief Sets the `session_start_limit.max_concurrency` that was received from `/gateway/bot`.
+         *
+         * This is called by discpp::Client::Run before any shards are started.
+         *
+         * @param[in] max_concurrency The amount of shards that may identify at the same time.
+         *
+         * @return void
+         */
+        virtual void SetMaxConcurrency(int max_concurrency) = 0;
+
+        /**
+         * @brief Blocks until the shard is allowed to identify.
+         *
+         * ```cpp
+         *      scheduler->AwaitIdentify(shard.id);
+         *      shard.CreateWebsocketRequest(identify);
+         * ```
+         *
+         * @param[in] shard_id The id of the shard that wants to identify.
+         *
+         * @return void
+         */
+        virtual void AwaitIdentify(int shard_id) = 0;
+
+        /**
+         * @brief Reserves the shard's turn to identify without blocking, and returns when it is.
+         *
+         * Shards identify on a timer when this returns a time, and call AwaitIdentify on a thread of their own
+         * when it doesn't. Schedulers that can only find out by waiting, like ones that ask another process,
+         * don't have to override it.
+         *
+         * @param[in] shard_id The id of the shard that wants to identify.
+         *
+         * @return std::optional<std::chrono::steady_clock::time_point>
+         */
+        virtual std::optional<std::chrono::steady_clock::time_point> ReserveIdentify(int) {
+            return std::nullopt;
+        }
+    };
+
+    /**
+     * @brief The default identify scheduler, each rate limit bucket lets one shard identify per interval.
+     */
+    class BucketIdentifyScheduler : public IdentifyScheduler {
+    public:
+        explicit BucketIdentifyScheduler(std::chrono::milliseconds interval = std::chrono::milliseconds(5050));
+
+        void SetMaxConcurrency(int max_concurrency) override;
+        void AwaitIdentify(int shard_id) override;
+        std::optional<std::chrono::steady_clock::time_point> ReserveIdentify(int shard_id) override;
+    private:
+        std::chrono::milliseconds interval;
+
+        std::mutex mutex;
+        std::vector<std::chrono::steady_clock::time_point> next_identify; /**< When each bucket can identify next. */
+    };
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef DISCPP_INTENTS_H
+#define DISCPP_INTENTS_H
+
+#include <cstdint>
+
+namespace discpp {
+    /**
+     * @brief Gateway intents, these decide which events Discord will send to the shards.
+     *
+     * Combine them with `|` and set the result as discpp::ClientConfig::intents.
+     *
+     * ```cpp
+     *      config->intents = discpp::GatewayIntents::GUILDS | discpp::GatewayIntents::GUILD_MESSAGES;
+     * ```
+     */
+    enum class GatewayIntents : uint32_t {
+        NONE = 0,
+        GUILDS = 1 << 0,
+        GUILD_MEMBERS = 1 << 1, /**< Privileged, this must be enabled in the developer portal. */
+        GUILD_BANS = 1 << 2,
+        GUILD_EMOJIS = 1 << 3,
+        GUILD_INTEGRATIONS = 1 << 4,
+        GUILD_WEBHOOKS = 1 << 5,
+        GUILD_INVITES = 1 << 6,
+        GUILD_VOICE_STATES = 1 << 7,
+        GUILD_PRESENCES = 1 << 8, /**< Privileged, this must be enabled in the developer portal. */
+        GUILD_MESSAGES = 1 << 9,
+        GUILD_MESSAGE_REACTIONS = 1 << 10,
+        GUILD_MESSAGE_TYPING = 1 << 11,
+        DIRECT_MESSAGES = 1 << 12,
+        DIRECT_MESSAGE_REACTIONS = 1 << 13,
+        DIRECT_MESSAGE_TYPING = 1 << 14,
+
+        PRIVILEGED = GUILD_MEMBERS | GUILD_PRESENCES,
+        ALL = (1 << 15) - 1,
+        UNPRIVILEGED = ALL & ~PRIVILEGED
+    };
+
+    constexpr GatewayIntents operator|(GatewayIntents a, GatewayIntents b) {
+        return static_cast<GatewayIntents>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+    }
+
+    constexpr GatewayIntents operator&(GatewayIntents a, GatewayIntents b) {
+        return static_cast<GatewayIntents>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+    }
+
+    constexpr GatewayIntents operator~(GatewayIntents a) {
+        return static_cast<GatewayIntents>(~static_cast<uint32_t>(a)) & GatewayIntents::ALL;
+    }
+
+    constexpr GatewayIntents& operator|=(GatewayIntents& a, GatewayIntents b) {
+        return a = a | b;
+    }
+
+    constexpr GatewayIntents& operator&=(GatewayIntents& a, GatewayIntents b) {
+        return a = a & b;
+    }
+
+    /**
+     * @brief Check if all of the intents in `intent` are set in `intents`.
+     *
+     * ```cpp
+     *      if (discpp::HasIntents(config->intents, discpp::GatewayIntents::GUILD_PRESENCES)) { ... }
+     * ```
+     *
+     * @param[in] intents The intents to check.
+     * @param[in] intent The intents that must be set.
+     *
+     * @return bool
+     */
+    constexpr bool HasIntents(GatewayIntents intents, GatewayIntents intent) {
+        return (intents & intent) == intent;
+    }
+
+    /**
+     * @brief Suggests the intents the bot needs from the event listeners that are currently registered.
+     *
+     * GUILDS is always included since the cache is built from its events, and the message intents are
+     * included because the command handler needs MESSAGE_CREATE. Call this after registering listeners.
+     *
+     * ```cpp
+     *      config->intents = discpp::SuggestIntents();
+     * ```
+     *
+     * @return discpp::GatewayIntents
+     */
+    GatewayIntents SuggestIntents();
+}
+
+#endif
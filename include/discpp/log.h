@@ -242,6 +242,20 @@ namespace discpp {
 		}
 
 
+		inline bool IsDebugEnabled() {
+			/**
+			 * @brief Check if debug messages will be logged, use this to skip building expensive debug text.
+			 *
+			 * ```cpp
+			 *      if (bot->logger->IsDebugEnabled()) bot->logger->Debug("Received payload: " + DumpJson(result));
+			 * ```
+			 *
+			 * @return bool
+			 */
+
+			return CanLog(LogSeverity::SEV_DEBUG);
+		}
+
 		inline void Debug(const std::string& text) {
             /**
              * @brief Logs to console or file, maybe even both in the debug severity.
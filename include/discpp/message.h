@@ -6,6 +6,7 @@
 #include "reaction.h"
 #include "attachment.h"
 #include "channel.h"
+#include "snowflake_map.h"
 
 namespace discpp {
     class Guild;
@@ -30,7 +31,7 @@ namespace discpp {
 		std::string party_id;
 
 		MessageActivity() = default;
-		MessageActivity(rapidjson::Document& json) {
+		MessageActivity(const rapidjson::Value& json) {
 			type = static_cast<ActivityType>(json["type"].GetInt());
 			party_id = GetDataSafely<std::string>(json, "party_id");
 		}
@@ -43,8 +44,8 @@ namespace discpp {
 		std::string name;
 
 		MessageApplication() = default;
-		MessageApplication(rapidjson::Document& json) {
-			id = discpp::Snowflake(json["id"].GetString());
+		MessageApplication(const rapidjson::Value& json) {
+			id = discpp::GetSnowflake(json["id"]);
 			cover_image = GetDataSafely<std::string>(json, "cover_image");
 			description = json["description"].GetString();
 			icon = json["icon"].GetString();
@@ -58,9 +59,9 @@ namespace discpp {
 		Snowflake guild_id;
 
 		MessageReference() = default;
-		MessageReference(rapidjson::Document& json) {
+		MessageReference(const rapidjson::Value& json) {
 			message_id = GetIDSafely(json, "message_id");
-			channel_id = discpp::Snowflake(json["channel_id"].GetString());
+			channel_id = discpp::GetSnowflake(json["channel_id"]);
 			guild_id = GetIDSafely(json, "guild_id");
 		}
 	};
@@ -69,9 +70,9 @@ namespace discpp {
 	public:
 	    class ChannelMention : public DiscordObject {
 	    public:
-            ChannelMention(rapidjson::Document& json) {
-                id = discpp::Snowflake(json["id"].GetString());
-                guild_id = discpp::Snowflake(json["id"].GetString());
+            ChannelMention(const rapidjson::Value& json) {
+                id = discpp::GetSnowflake(json["id"]);
+                guild_id = discpp::GetSnowflake(json["id"]);
                 type = static_cast<discpp::ChannelType>(json["type"].GetInt());
                 name = json["name"].GetString();
             }
@@ -109,7 +110,7 @@ namespace discpp {
          *
          * @return discpp::Message, this is a constructor.
          */
-		Message(rapidjson::Document& json);
+		Message(const rapidjson::Value& json);
 
 
         /**
@@ -328,9 +329,9 @@ namespace discpp {
 		std::string content;
 		std::chrono::system_clock::time_point timestamp;
 		std::chrono::system_clock::time_point edited_timestamp = std::chrono::system_clock::from_time_t(0);
-		std::unordered_map<discpp::Snowflake, discpp::User> mentions;
+		SnowflakeMap<discpp::User> mentions;
 		std::vector<discpp::Snowflake> mentioned_roles;
-        std::unordered_map<discpp::Snowflake, ChannelMention> mention_channels;
+        SnowflakeMap<ChannelMention> mention_channels;
 		std::vector<discpp::Attachment> attachments;
 		std::vector<discpp::EmbedBuilder> embeds;
 		std::vector<discpp::Reaction> reactions;
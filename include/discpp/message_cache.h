@@ -0,0 +1,152 @@
+#ifndef DISCPP_MESSAGE_CACHE_H
+#define DISCPP_MESSAGE_CACHE_H
+
+#include "snowflake_map.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace discpp {
+    class Message;
+
+    /**
+     * @brief The latest messages of every channel, up to a total amount of messages.
+     *
+     * Every channel keeps its messages oldest first, in the order they were received, which is snowflake order for
+     * the messages of a channel. A channel that is full drops its oldest message. When the cache is full the oldest
+     * message of the channel that least recently received a message is dropped, so quiet channels make room for
+     * busy ones. Looking up a message by id, adding and dropping messages all take constant time.
+     *
+     * The messages are shared with whoever got them from the cache, so they're replaced instead of changed, see
+     * discpp::MessageCache::Update. The cache can be used from any thread.
+     *
+     * ```cpp
+     *      discpp::MessageCache messages(5000);
+     *      messages.Insert(message);
+     *
+     *      std::shared_ptr<discpp::Message> cached = messages.Get(message_id);
+     * ```
+     */
+    class MessageCache {
+    public:
+        /**
+         * @param[in] capacity The amount of messages the cache can hold, zero doesn't cache any.
+         * @param[in] channel_capacity The amount of messages a single channel can hold.
+         */
+        explicit MessageCache(size_t capacity = 0, size_t channel_capacity = 100);
+
+        /**
+         * @brief Changes the amount of messages the cache can hold, dropping messages if it holds more.
+         *
+         * @param[in] capacity The amount of messages the cache can hold, zero doesn't cache any.
+         * @param[in] channel_capacity The amount of messages a single channel can hold.
+         *
+         * @return void
+         */
+        void SetCapacity(size_t capacity, size_t channel_capacity);
+
+        /**
+         * @brief Adds a message to the end of its channel, a cached message with the same id is replaced in place.
+         *
+         * @param[in] message The message.
+         *
+         * @return void
+         */
+        void Insert(std::shared_ptr<Message> message);
+
+        /**
+         * @brief Get a message.
+         *
+         * @param[in] id The id of the message.
+         *
+         * @return std::shared_ptr<discpp::Message>, nullptr if the message isn't cached.
+         */
+        std::shared_ptr<Message> Get(const Snowflake& id) const;
+
+        /**
+         * @brief Check if a message is cached.
+         *
+         * @param[in] id The id of the message.
+         *
+         * @return bool
+         */
+        bool Contains(const Snowflake& id) const;
+
+        /**
+         * @brief Replaces a cached message with a changed copy of it.
+         *
+         * The callback is run with the cache locked, so it shouldn't use the cache.
+         *
+         * @param[in] id The id of the message.
+         * @param[in] update Changes the copy.
+         *
+         * @return std::shared_ptr<discpp::Message>, the changed message, nullptr if the message isn't cached.
+         */
+        std::shared_ptr<Message> Update(const Snowflake& id, const std::function<void(Message&)>& update);
+
+        /**
+         * @brief Removes a message.
+         *
+         * @param[in] id The id of the message.
+         *
+         * @return std::shared_ptr<discpp::Message>, the removed message, nullptr if it wasn't cached.
+         */
+        std::shared_ptr<Message> Erase(const Snowflake& id);
+
+        /**
+         * @brief Get the cached messages of a channel, oldest first.
+         *
+         * @param[in] channel_id The id of the channel.
+         *
+         * @return std::vector<std::shared_ptr<discpp::Message>>
+         */
+        std::vector<std::shared_ptr<Message>> GetChannelMessages(const Snowflake& channel_id) const;
+
+        /**
+         * @brief Get the amount of cached messages.
+         *
+         * @return size_t
+         */
+        size_t Size() const;
+
+        /**
+         * @brief Removes every message.
+         *
+         * @return void
+         */
+        void Clear();
+    private:
+        struct ChannelMessages {
+            std::deque<std::shared_ptr<Message>> messages; /**< Oldest first, removed messages are left empty until they're the oldest. */
+            uint64_t first_position = 0; /**< The position of the front message, positions are never reused. */
+            std::list<Snowflake>::iterator recent; /**< This channel in `recent_channels`. */
+        };
+
+        struct Location {
+            Snowflake channel_id;
+            uint64_t position;
+        };
+
+        size_t capacity;
+        size_t channel_capacity;
+
+        mutable std::shared_mutex mutex;
+        SnowflakeMap<ChannelMessages> channels;
+        SnowflakeMap<Location> index;
+        std::list<Snowflake> recent_channels; /**< The channel that most recently received a message first. */
+        size_t size = 0;
+
+        std::shared_ptr<Message>* Find(const Snowflake& id);
+        void PopFront(ChannelMessages& channel);
+        void DropOldest();
+        void RemoveIfEmpty(const Snowflake& channel_id);
+    };
+}
+
+#endif
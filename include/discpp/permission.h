@@ -174,7 +174,7 @@ namespace discpp {
          *
          * @return discpp::Permissions, this is a constructor.
          */
-		Permissions(rapidjson::Document& json);
+		Permissions(const rapidjson::Value& json);
 
         /**
          * @brief Converts this permissions object to json.
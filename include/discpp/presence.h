@@ -22,7 +22,7 @@ namespace discpp {
 
         struct Party {
             Party() = default;
-            Party(rapidjson::Document& json) {
+            Party(const rapidjson::Value& json) {
                 if (ContainsNotNull(json, "id")) {
                     id = json["id"].GetString();
                 }
@@ -39,7 +39,7 @@ namespace discpp {
 
         struct Assets {
             Assets() = default;
-            Assets(rapidjson::Document& json) {
+            Assets(const rapidjson::Value& json) {
                 if (ContainsNotNull(json, "large_image")) {
                     large_image = json["large_image"].GetString();
                 }
@@ -62,7 +62,7 @@ namespace discpp {
 
         struct Secrets {
             Secrets() = default;
-            Secrets(rapidjson::Document& json) {
+            Secrets(const rapidjson::Value& json) {
                 if (ContainsNotNull(json, "join")) {
                     join = json["join"].GetString();
                 }
@@ -80,7 +80,7 @@ namespace discpp {
         };
 
         Activity() = default;
-        Activity(rapidjson::Document& json) {
+        Activity(const rapidjson::Value& json) {
             name = json["name"].GetString();
             type = static_cast<ActivityType>(json["type"].GetInt());
             if (ContainsNotNull(json, "url")) {
@@ -88,8 +88,7 @@ namespace discpp {
             }
             created_at = std::chrono::system_clock::from_time_t(json["created_at"].Get<std::time_t>());
             if (ContainsNotNull(json, "timestamps")) {
-                rapidjson::Document timestamps_json(rapidjson::kObjectType);
-                timestamps_json.CopyFrom(json["timestamps"], timestamps_json.GetAllocator());
+                const rapidjson::Value& timestamps_json = json["timestamps"];
 
                 if (ContainsNotNull(timestamps_json, "start")) {
                     this->timestamps.emplace("start", timestamps_json["start"].Get<std::time_t>());
@@ -133,14 +132,11 @@ namespace discpp {
 	class Presence {
 	public:
 	    Presence() = default;
-		Presence(rapidjson::Document& json) {
+		Presence(const rapidjson::Value& json) {
 		    status = json["status"].GetString();
 		    game = std::make_shared<discpp::Activity>(ConstructDiscppObjectFromJson(json, "game", discpp::Activity()));
             for (auto const& activity : json["activities"].GetArray()) {
-                rapidjson::Document activity_json(rapidjson::kObjectType);
-                activity_json.CopyFrom(activity, activity_json.GetAllocator());
-
-                activities.emplace_back(activity_json);
+                activities.emplace_back(activity);
             }
 		}
 
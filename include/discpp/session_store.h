@@ -0,0 +1,87 @@
+#ifndef DISCPP_SESSION_STORE_H
+#define DISCPP_SESSION_STORE_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace discpp {
+    /**
+     * @brief The state a shard needs to resume its gateway session after the process restarts.
+     */
+    struct ShardSession {
+        int shard_id = 0;
+        std::string session_id;
+        int sequence = 0; /**< The last sequence number the shard received. */
+        std::string gateway_url;
+    };
+
+    /**
+     * @brief Stores shard sessions between runs, set one in discpp::ClientConfig::session_store to enable it.
+     *
+     * Shards save their session when they become ready, after every heartbeat and when the client is stopped,
+     * then on startup they try to resume the saved session before identifying. Resumed sessions don't replay
+     * GUILD_CREATE, so the cache only has what is received after the restart.
+     */
+    class SessionStore {
+    public:
+        virtual ~SessionStore() = default;
+
+        /**
+         * @brief Loads the saved session of a shard.
+         *
+         * @param[in] shard_id The id of the shard.
+         *
+         * @return std::optional<discpp::ShardSession>, empty if there isn't a saved session.
+         */
+        virtual std::optional<ShardSession> Load(int shard_id) = 0;
+
+        /**
+         * @brief Saves a shard's session, replacing the one it had before.
+         *
+         * @param[in] session The session to save.
+         *
+         * @return void
+         */
+        virtual void Save(const ShardSession& session) = 0;
+
+        /**
+         * @brief Stores sessions that Save held on to, called by discpp::Client::StopClient after every shard saved.
+         *
+         * @return void
+         */
+        virtual void Flush() {}
+    };
+
+    /**
+     * @brief Stores the sessions of every shard in a json file.
+     *
+     * Every shard saves after each heartbeat, so saved sessions are kept in memory and written together at most
+     * once every `write_interval`. A session that wasn't written yet only loses a few events when it's resumed.
+     *
+     * ```cpp
+     *      config->session_store = std::make_shared<discpp::FileSessionStore>("sessions.json");
+     * ```
+     */
+    class FileSessionStore : public SessionStore {
+    public:
+        explicit FileSessionStore(std::string path, std::chrono::milliseconds write_interval = std::chrono::seconds(10));
+
+        std::optional<ShardSession> Load(int shard_id) override;
+        void Save(const ShardSession& session) override;
+        void Flush() override;
+    private:
+        std::string path;
+        std::chrono::milliseconds write_interval;
+
+        std::mutex mutex;
+        std::map<int, ShardSession> unwritten; /**< Saved sessions that aren't in the file yet. */
+        std::chrono::steady_clock::time_point last_write;
+
+        void Write();
+    };
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef DISCPP_SNOWFLAKE_H
 #define DISCPP_SNOWFLAKE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace discpp {
@@ -10,7 +12,7 @@ namespace discpp {
     public:
         constexpr Snowflake() noexcept : id(0) {}
         constexpr Snowflake(const uint64_t& snowflake) noexcept : id(snowflake) {}
-        explicit Snowflake(const std::string& snowflake) noexcept : id(std::stoll(snowflake)) {}
+        explicit Snowflake(const std::string& snowflake) noexcept : id(std::stoull(snowflake)) {}
         operator uint64_t() const { return id; }
         operator std::string() const { return std::to_string(id); }
     };
@@ -19,8 +21,16 @@ namespace discpp {
 namespace std {
     template <>
     struct hash<discpp::Snowflake> {
+        // The low bits of a snowflake are its worker, process and increment, which barely change, so the bits are
+        // mixed for tables that index by the low bits of the hash.
         std::size_t operator()(const discpp::Snowflake& k) const {
-            return hash<uint64_t>()(k);
+            uint64_t hash = k;
+            hash ^= hash >> 32;
+            hash *= 0xD6E8FEB86659FD93ull;
+            hash ^= hash >> 32;
+            hash *= 0xD6E8FEB86659FD93ull;
+            hash ^= hash >> 32;
+            return static_cast<std::size_t>(hash);
         }
     };
 }
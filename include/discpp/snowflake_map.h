@@ -0,0 +1,456 @@
+#ifndef DISCPP_SNOWFLAKE_MAP_H
+#define DISCPP_SNOWFLAKE_MAP_H
+
+#include "snowflake.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace discpp {
+    /**
+     * @brief A hash map from snowflakes to values, stored in one flat array.
+     *
+     * It's used in place of std::unordered_map for the objects the client keeps by id. Every entry lives in a slot
+     * of one array instead of its own heap node, and every slot has a control byte that holds a few bits of the
+     * key's hash. Looking up a key walks the control bytes from where its hash points to, so most slots that
+     * don't hold the key are skipped without reading their entry. Iterating reads both arrays front to back.
+     *
+     * It has the parts of the std::unordered_map interface the library uses, with a few differences:
+     * - Adding an entry can move every entry, invalidating references and iterators to them, like a rehash does.
+     * - Removing an entry leaves the others where they are, so erasing while iterating works the same.
+     * - The value type is `std::pair<const Snowflake, V>` and entries are moved when the map grows, so V has to be
+     *   movable.
+     *
+     * ```cpp
+     *      discpp::SnowflakeMap<discpp::Channel> channels;
+     *      channels.insert({ channel.id, channel });
+     *
+     *      auto it = channels.find(channel_id);
+     *      if (it != channels.end()) std::cout << it->second.name << std::endl;
+     * ```
+     */
+    template<typename V>
+    class SnowflakeMap {
+    public:
+        using key_type = Snowflake;
+        using mapped_type = V;
+        using value_type = std::pair<const Snowflake, V>;
+        using size_type = size_t;
+        using hasher = std::hash<Snowflake>;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        template<bool Const>
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename SnowflakeMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+            using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+            Iterator() = default;
+
+            template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            Iterator(const Iterator<OtherConst>& other) : control(other.control), control_end(other.control_end), slot(other.slot) {}
+
+            reference operator*() const { return *slot; }
+            pointer operator->() const { return slot; }
+
+            Iterator& operator++() {
+                ++control;
+                ++slot;
+                SkipFree();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.control == b.control; }
+            friend bool operator!=(const Iterator& a, const Iterator& b) { return a.control != b.control; }
+        private:
+            friend class SnowflakeMap;
+            template<bool> friend class Iterator;
+
+            const uint8_t* control = nullptr;
+            const uint8_t* control_end = nullptr;
+            pointer slot = nullptr;
+
+            Iterator(const uint8_t* control, const uint8_t* control_end, pointer slot) : control(control), control_end(control_end), slot(slot) {}
+
+            void SkipFree() {
+                while (control != control_end && !IsFull(*control)) {
+                    ++control;
+                    ++slot;
+                }
+            }
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        SnowflakeMap() = default;
+
+        SnowflakeMap(std::initializer_list<value_type> values) {
+            reserve(values.size());
+            for (const value_type& value : values) insert(value);
+        }
+
+        SnowflakeMap(const SnowflakeMap& other) {
+            if (other.size_ == 0) return;
+
+            // Copies keep the same layout, so the control bytes are copied as they are and no key is hashed again.
+            Allocate(other.capacity);
+            size_t constructed = 0;
+            try {
+                for (; constructed < capacity; constructed++) {
+                    if (IsFull(other.control[constructed])) new (&slots[constructed]) value_type(other.slots[constructed]);
+                }
+            } catch (...) {
+                for (size_t i = 0; i < constructed; i++) {
+                    if (IsFull(other.control[i])) slots[i].~value_type();
+                }
+                Deallocate();
+                throw;
+            }
+
+            std::memcpy(control, other.control, capacity);
+            size_ = other.size_;
+            used = other.used;
+        }
+
+        SnowflakeMap(SnowflakeMap&& other) noexcept {
+            swap(other);
+        }
+
+        SnowflakeMap& operator=(const SnowflakeMap& other) {
+            if (this != &other) {
+                SnowflakeMap copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        SnowflakeMap& operator=(SnowflakeMap&& other) noexcept {
+            if (this != &other) {
+                SnowflakeMap moved(std::move(other));
+                swap(moved);
+            }
+            return *this;
+        }
+
+        ~SnowflakeMap() {
+            DestroyAll();
+            Deallocate();
+        }
+
+        iterator begin() {
+            iterator it(control, control + capacity, slots);
+            it.SkipFree();
+            return it;
+        }
+
+        const_iterator begin() const {
+            const_iterator it(control, control + capacity, slots);
+            it.SkipFree();
+            return it;
+        }
+
+        const_iterator cbegin() const { return begin(); }
+
+        iterator end() { return iterator(control + capacity, control + capacity, slots + capacity); }
+        const_iterator end() const { return const_iterator(control + capacity, control + capacity, slots + capacity); }
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return size_ == 0; }
+        size_t size() const { return size_; }
+
+        /**
+         * @brief Removes every entry, the memory is kept for new entries.
+         *
+         * @return void
+         */
+        void clear() {
+            DestroyAll();
+            if (control) std::memset(control, kEmpty, capacity);
+            size_ = 0;
+            used = 0;
+        }
+
+        /**
+         * @brief Makes room for an amount of entries, so adding up to that many doesn't move any.
+         *
+         * @param[in] count The amount of entries.
+         *
+         * @return void
+         */
+        void reserve(size_t count) {
+            size_t needed = CapacityFor(count);
+            if (needed > capacity) Rehash(needed);
+        }
+
+        iterator find(const Snowflake& key) {
+            size_t index = FindIndex(key);
+            return index == kNotFound ? end() : IteratorAt(index);
+        }
+
+        const_iterator find(const Snowflake& key) const {
+            size_t index = FindIndex(key);
+            return index == kNotFound ? end() : const_iterator(control + index, control + capacity, slots + index);
+        }
+
+        size_t count(const Snowflake& key) const {
+            return FindIndex(key) == kNotFound ? 0 : 1;
+        }
+
+        bool contains(const Snowflake& key) const {
+            return FindIndex(key) != kNotFound;
+        }
+
+        V& at(const Snowflake& key) {
+            size_t index = FindIndex(key);
+            if (index == kNotFound) throw std::out_of_range("SnowflakeMap::at: key not found");
+            return slots[index].second;
+        }
+
+        const V& at(const Snowflake& key) const {
+            size_t index = FindIndex(key);
+            if (index == kNotFound) throw std::out_of_range("SnowflakeMap::at: key not found");
+            return slots[index].second;
+        }
+
+        V& operator[](const Snowflake& key) {
+            return try_emplace(key).first->second;
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const Snowflake& key, Args&&... args) {
+            size_t index = FindIndex(key);
+            if (index != kNotFound) return { IteratorAt(index), false };
+
+            index = PrepareInsert(key);
+            new (&slots[index]) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+            FinishInsert(index, key);
+
+            return { IteratorAt(index), true };
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            value_type value(std::forward<Args>(args)...);
+            return try_emplace(value.first, std::move(value.second));
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value) {
+            return try_emplace(value.first, std::move(value.second));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) insert(*first);
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const Snowflake& key, M&& value) {
+            auto result = try_emplace(key, std::forward<M>(value));
+            if (!result.second) result.first->second = std::forward<M>(value);
+            return result;
+        }
+
+        size_t erase(const Snowflake& key) {
+            size_t index = FindIndex(key);
+            if (index == kNotFound) return 0;
+
+            EraseAt(index);
+            return 1;
+        }
+
+        iterator erase(const_iterator position) {
+            size_t index = static_cast<size_t>(position.control - control);
+            EraseAt(index);
+
+            iterator next = IteratorAt(index);
+            ++next;
+            return next;
+        }
+
+        iterator erase(iterator position) {
+            return erase(const_iterator(position));
+        }
+
+        void swap(SnowflakeMap& other) noexcept {
+            std::swap(control, other.control);
+            std::swap(slots, other.slots);
+            std::swap(capacity, other.capacity);
+            std::swap(size_, other.size_);
+            std::swap(used, other.used);
+        }
+    private:
+        // A full slot's control byte is the low 7 bits of its key's hash, the other two have the high bit set.
+        static constexpr uint8_t kEmpty = 0x80;
+        static constexpr uint8_t kDeleted = 0xFE;
+        static constexpr size_t kNotFound = static_cast<size_t>(-1);
+        static constexpr size_t kMinCapacity = 8;
+
+        uint8_t* control = nullptr;
+        value_type* slots = nullptr;
+        size_t capacity = 0; /**< Always zero or a power of two. */
+        size_t size_ = 0;
+        size_t used = 0; /**< Full and deleted slots, lookups only stop at empty ones so these count against the load. */
+
+        static bool IsFull(uint8_t control) {
+            return (control & 0x80) == 0;
+        }
+
+        static size_t Hash(const Snowflake& key) {
+            return hasher()(key);
+        }
+
+        static uint8_t ControlOf(size_t hash) {
+            return static_cast<uint8_t>(hash & 0x7F);
+        }
+
+        // At most 7/8 of the slots can be used, so every lookup reaches an empty slot.
+        static size_t CapacityFor(size_t count) {
+            if (count == 0) return 0;
+
+            size_t capacity = kMinCapacity;
+            while (capacity - capacity / 8 < count) capacity *= 2;
+            return capacity;
+        }
+
+        iterator IteratorAt(size_t index) {
+            return iterator(control + index, control + capacity, slots + index);
+        }
+
+        size_t FindIndex(const Snowflake& key) const {
+            if (size_ == 0) return kNotFound;
+
+            size_t hash = Hash(key);
+            uint8_t expected = ControlOf(hash);
+            size_t mask = capacity - 1;
+            for (size_t index = (hash >> 7) & mask;; index = (index + 1) & mask) {
+                uint8_t current = control[index];
+                if (current == expected && slots[index].first == key) return index;
+                if (current == kEmpty) return kNotFound;
+            }
+        }
+
+        // Finds the slot a key that isn't in the map goes in, growing the map if it's too full.
+        size_t PrepareInsert(const Snowflake& key) {
+            if (used + 1 > capacity - capacity / 8) {
+                // Mostly deleted slots are cleaned up at the same size, otherwise the map grows.
+                Rehash(size_ + 1 <= (capacity - capacity / 8) / 2 ? capacity : std::max(capacity * 2, kMinCapacity));
+            }
+
+            size_t mask = capacity - 1;
+            size_t index = (Hash(key) >> 7) & mask;
+            while (IsFull(control[index])) index = (index + 1) & mask;
+            return index;
+        }
+
+        void FinishInsert(size_t index, const Snowflake& key) {
+            if (control[index] == kEmpty) used++;
+            control[index] = ControlOf(Hash(key));
+            size_++;
+        }
+
+        void EraseAt(size_t index) {
+            slots[index].~value_type();
+            size_--;
+
+            // A lookup that reaches the next slot would go on past this one, unless the next is empty.
+            if (control[(index + 1) & (capacity - 1)] == kEmpty) {
+                control[index] = kEmpty;
+                used--;
+            } else {
+                control[index] = kDeleted;
+            }
+        }
+
+        void Rehash(size_t new_capacity) {
+            uint8_t* old_control = control;
+            value_type* old_slots = slots;
+            size_t old_capacity = capacity;
+
+            control = nullptr;
+            slots = nullptr;
+            Allocate(new_capacity);
+            size_ = 0;
+            used = 0;
+
+            size_t mask = capacity - 1;
+            for (size_t i = 0; i < old_capacity; i++) {
+                if (!IsFull(old_control[i])) continue;
+
+                value_type& entry = old_slots[i];
+                size_t index = (Hash(entry.first) >> 7) & mask;
+                while (IsFull(control[index])) index = (index + 1) & mask;
+
+                new (&slots[index]) value_type(entry.first, std::move(entry.second));
+                control[index] = old_control[i];
+                size_++;
+                used++;
+
+                entry.~value_type();
+            }
+
+            ::operator delete(old_slots);
+            delete[] old_control;
+        }
+
+        void Allocate(size_t new_capacity) {
+            capacity = new_capacity;
+            if (capacity == 0) return;
+
+            control = new uint8_t[capacity];
+            std::memset(control, kEmpty, capacity);
+            try {
+                slots = static_cast<value_type*>(::operator new(capacity * sizeof(value_type)));
+            } catch (...) {
+                delete[] control;
+                control = nullptr;
+                capacity = 0;
+                throw;
+            }
+        }
+
+        void Deallocate() {
+            ::operator delete(slots);
+            delete[] control;
+
+            slots = nullptr;
+            control = nullptr;
+            capacity = 0;
+        }
+
+        void DestroyAll() {
+            if (std::is_trivially_destructible<value_type>::value) return;
+
+            for (size_t i = 0; i < capacity; i++) {
+                if (IsFull(control[i])) slots[i].~value_type();
+            }
+        }
+    };
+}
+
+#endif
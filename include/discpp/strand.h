@@ -0,0 +1,66 @@
+#ifndef DISCPP_STRAND_H
+#define DISCPP_STRAND_H
+
+#include "thread_pool.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace discpp {
+    /**
+     * @brief Runs tasks on a discpp::ThreadPool one at a time per key, in the order they were posted.
+     *
+     * Tasks with the same key (a strand) never run at the same time and run in order, tasks with different keys
+     * run in parallel. The client uses the guild id as the key for gateway events, or the channel id for events
+     * outside of guilds, so events of a guild are handled in the order they were received.
+     *
+     * A strand only exists while it has tasks, and after running a few tasks it goes to the back of the pool's
+     * queue so a busy guild can't keep a worker to itself.
+     *
+     * ```cpp
+     *      discpp::StrandExecutor strands(pool);
+     *      strands.Post(guild.id, [] { ... });
+     * ```
+     */
+    class StrandExecutor {
+    public:
+        /**
+         * @param[in] pool The pool the tasks run on, it must outlive the executor's tasks.
+         * @param[in] batch_size The amount of tasks a strand runs before letting other tasks use the worker.
+         */
+        explicit StrandExecutor(ThreadPool& pool, size_t batch_size = 32);
+
+        /**
+         * @brief Queues a task on a strand.
+         *
+         * @param[in] key The strand to run the task on.
+         * @param[in] task The task to run.
+         *
+         * @return void
+         */
+        void Post(uint64_t key, ThreadPool::Task task);
+
+        /**
+         * @brief Get the amount of strands that have tasks queued or running.
+         *
+         * @return size_t
+         */
+        size_t GetStrandCount() const;
+    private:
+        struct Strand {
+            std::deque<ThreadPool::Task> tasks;
+        };
+
+        ThreadPool& pool;
+        size_t batch_size;
+
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Strand> strands;
+
+        void Drain(uint64_t key);
+    };
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef DISCPP_TASK_H
+#define DISCPP_TASK_H
+
+#ifdef DISCPP_COROUTINES
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace discpp {
+    template<typename T>
+    class Task;
+
+    namespace detail {
+        // The states of a task's continuation, any other value is the handle of the coroutine awaiting the task.
+        inline void* const kTaskRunning = nullptr;
+        inline void* const kTaskDone = reinterpret_cast<void*>(1);
+        inline void* const kTaskDetached = reinterpret_cast<void*>(2);
+
+        // Hands the thread to the coroutine awaiting the task, if there is one, once the task has finished.
+        struct TaskFinalAwaiter {
+            bool await_ready() noexcept { return false; }
+
+            template<typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+                void* continuation = handle.promise().continuation.exchange(kTaskDone);
+
+                // Nothing owns the task anymore, so it cleans up after itself.
+                if (continuation == kTaskDetached) {
+                    handle.destroy();
+                    return std::noop_coroutine();
+                }
+
+                if (continuation == kTaskRunning) return std::noop_coroutine();
+                return std::coroutine_handle<>::from_address(continuation);
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        class TaskPromiseBase {
+        public:
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            TaskFinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() noexcept {
+                exception = std::current_exception();
+            }
+
+            std::atomic<void*> continuation { kTaskRunning };
+            std::exception_ptr exception;
+        };
+
+        template<typename T>
+        class TaskPromise : public TaskPromiseBase {
+        public:
+            Task<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U&& value) {
+                result.emplace(std::forward<U>(value));
+            }
+
+            T TakeResult() {
+                if (exception) std::rethrow_exception(exception);
+                return std::move(*result);
+            }
+
+            std::optional<T> result;
+        };
+
+        template<>
+        class TaskPromise<void> : public TaskPromiseBase {
+        public:
+            Task<void> get_return_object() noexcept;
+
+            void return_void() noexcept {}
+
+            void TakeResult() {
+                if (exception) std::rethrow_exception(exception);
+            }
+        };
+    }
+
+    /**
+     * @brief The result of a discpp coroutine. Requires building with DISCPP_COROUTINES.
+     *
+     * A task starts running as soon as it's called and runs until it first suspends. Awaiting the task resumes the
+     * awaiting coroutine once the task has finished, and gives its result or rethrows its exception. A task that is
+     * dropped without being awaited keeps running and is cleaned up when it finishes, so listeners can be coroutines.
+     * Exceptions of a dropped task are lost.
+     *
+     * ```cpp
+     *      discpp::Task<discpp::Message> Reply(discpp::Channel channel) {
+     *          co_return co_await channel.SendAsync("Hello!");
+     *      }
+     * ```
+     */
+    template<typename T = void>
+    class Task {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                Release();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task() {
+            Release();
+        }
+
+        /**
+         * @brief Check if the task has finished.
+         *
+         * @return bool
+         */
+        bool IsDone() const {
+            return !handle || handle.promise().continuation.load() == detail::kTaskDone;
+        }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() const noexcept {
+                    return handle.promise().continuation.load() == detail::kTaskDone;
+                }
+
+                bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    // Fails if the task finished on another thread in the meantime, then there's no need to suspend.
+                    void* expected = detail::kTaskRunning;
+                    return handle.promise().continuation.compare_exchange_strong(expected, awaiting.address());
+                }
+
+                T await_resume() {
+                    return handle.promise().TakeResult();
+                }
+            };
+
+            return Awaiter{ handle };
+        }
+    private:
+        friend promise_type;
+
+        std::coroutine_handle<promise_type> handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+        void Release() {
+            if (!handle) return;
+
+            // A finished task is destroyed here, a running one destroys itself when it finishes.
+            if (handle.promise().continuation.exchange(detail::kTaskDetached) == detail::kTaskDone) {
+                handle.destroy();
+            }
+            handle = nullptr;
+        }
+    };
+
+    namespace detail {
+        template<typename T>
+        Task<T> TaskPromise<T>::get_return_object() noexcept {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+    }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef DISCPP_THREAD_POOL_H
+#define DISCPP_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace discpp {
+    struct ThreadPoolStats {
+        size_t workers = 0;
+        uint64_t queued = 0; /**< Tasks waiting for a worker. */
+        uint64_t running = 0;
+        uint64_t completed = 0;
+        uint64_t stolen = 0; /**< Tasks a worker took from another worker's queue. */
+    };
+
+    /**
+     * @brief A fixed amount of worker threads that run tasks, used by discpp::Client::DoFunctionLater so events
+     * and listeners don't each start a thread.
+     *
+     * Every worker has its own queue. Tasks submitted by a worker go on its own queue and other tasks are spread
+     * between the workers, a worker with nothing to do takes tasks from the back of the other queues. Workers run
+     * their own queue oldest first so a burst of events is handled in about the order it arrived.
+     *
+     * A task that blocks holds its worker until it returns, so long running listeners should start their own thread.
+     *
+     * ```cpp
+     *      discpp::ThreadPool pool(4);
+     *      pool.Submit([] { ... });
+     *      pool.WaitIdle();
+     * ```
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+        using ErrorHandler = std::function<void(std::exception_ptr)>;
+
+        /**
+         * @brief Starts the workers.
+         *
+         * @param[in] worker_count The amount of workers, zero uses the amount of hardware threads.
+         * @param[in] error_handler Called on the worker with exceptions that escape a task, they're ignored if this is empty.
+         */
+        explicit ThreadPool(size_t worker_count = 0, ErrorHandler error_handler = nullptr);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Queues a task to run on a worker.
+         *
+         * Tasks submitted after the pool was stopped are dropped.
+         *
+         * @param[in] task The task to run.
+         *
+         * @return void
+         */
+        void Submit(Task task);
+
+        /**
+         * @brief Blocks until every submitted task has finished, including ones submitted while waiting.
+         *
+         * This must not be called from a task, it would wait for itself.
+         *
+         * @return void
+         */
+        void WaitIdle();
+
+        /**
+         * @brief Runs the tasks that are still queued then stops the workers.
+         *
+         * A task can't wait for its own worker, so called from a task this only tells the workers to stop once
+         * the queues are empty. They're joined by the next call from outside the pool, or the destructor.
+         *
+         * @return void
+         */
+        void Stop();
+
+        size_t GetWorkerCount() const;
+
+        ThreadPoolStats GetStats() const;
+    private:
+        struct Worker {
+            std::deque<Task> tasks;
+            std::mutex mutex;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        ErrorHandler error_handler;
+
+        std::mutex join_mutex; /**< Only one Stop can join the workers. */
+
+        std::mutex wake_mutex;
+        std::condition_variable wake_condition;
+
+        std::mutex idle_mutex;
+        std::condition_variable idle_condition;
+
+        std::atomic<uint64_t> queued { 0 };
+        std::atomic<uint64_t> running { 0 };
+        std::atomic<uint64_t> pending { 0 }; /**< Submitted but not finished. */
+        std::atomic<uint64_t> completed { 0 };
+        std::atomic<uint64_t> stolen { 0 };
+
+        std::atomic<size_t> next_worker { 0 };
+        std::atomic<bool> stopping { false };
+
+        void WorkerLoop(size_t index);
+        bool TryPop(size_t index, Task& task);
+        void RunTask(Task& task);
+    };
+}
+
+#endif
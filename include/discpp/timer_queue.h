@@ -0,0 +1,61 @@
+#ifndef DISCPP_TIMER_QUEUE_H
+#define DISCPP_TIMER_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace discpp {
+    /**
+     * @brief Runs functions once their delay has passed, on a single thread.
+     *
+     * Every timer shares the thread, so the functions should only hand their work off, like
+     * discpp::Client::DoFunctionAfter does. Timers that haven't run when the queue is stopped or destroyed are dropped.
+     *
+     * ```cpp
+     *      discpp::TimerQueue timers;
+     *      timers.Add(std::chrono::seconds(5), [&] { pool.Submit(task); });
+     * ```
+     */
+    class TimerQueue {
+    public:
+        using Function = std::function<void()>;
+
+        TimerQueue();
+        ~TimerQueue();
+
+        TimerQueue(const TimerQueue&) = delete;
+        TimerQueue& operator=(const TimerQueue&) = delete;
+
+        /**
+         * @brief Runs a function once the delay has passed.
+         *
+         * @param[in] delay How long to wait before running the function.
+         * @param[in] function The function to run.
+         *
+         * @return void
+         */
+        void Add(std::chrono::milliseconds delay, Function function);
+
+        /**
+         * @brief Stops the thread, timers that haven't run and ones added later are dropped.
+         *
+         * @return void
+         */
+        void Stop();
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::multimap<std::chrono::steady_clock::time_point, Function> timers;
+        bool stopping = false;
+        std::mutex join_mutex; /**< Stop can be called again by the destructor, only one of them joins. */
+        std::thread thread;
+
+        void Loop();
+    };
+}
+
+#endif
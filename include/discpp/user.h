@@ -40,7 +40,7 @@ namespace discpp {
              *
              * @return discpp::User::Connection, this is a constructor.
              */
-            Connection(rapidjson::Document& json);
+            Connection(const rapidjson::Value& json);
         };
 
 		User() = default;
@@ -71,7 +71,7 @@ namespace discpp {
          *
          * @return discpp::User, this is a constructor.
          */
-		User(rapidjson::Document& json);
+		User(const rapidjson::Value& json);
 
         /**
          * @brief Create a DM channel with this user.
@@ -13,6 +13,7 @@
 
 #include <unordered_map>
 #include <climits>
+#include <cstdlib>
 
 namespace discpp {
 	class Client;
@@ -94,70 +95,85 @@ namespace discpp {
 
     [[deprecated]] [[maybe_unused]] [[nodiscard]] discpp::Snowflake SnowflakeFromString(const std::string& str);
 
-	inline discpp::Snowflake GetIDSafely(rapidjson::Document& json, const char* value_name) {
-        rapidjson::Value::ConstMemberIterator itr = json.FindMember(value_name);
-        if (itr != json.MemberEnd()) {
-            if (!json[value_name].IsNull()) {
-                rapidjson::Document t_doc;
-                t_doc.CopyFrom(json[value_name], t_doc.GetAllocator());
+    /**
+     * @brief Get a snowflake from a json value.
+     *
+     * JSON payloads send snowflakes as strings, but ETF payloads send them as 64-bit integers.
+     *
+     * ```cpp
+     *      discpp::Snowflake guild_id = discpp::GetSnowflake(json["guild_id"]);
+     * ```
+     *
+     * @param[in] value The json value that holds the snowflake.
+     *
+     * @return discpp::Snowflake
+     */
+    inline discpp::Snowflake GetSnowflake(const rapidjson::Value& value) {
+        if (value.IsString()) {
+            return discpp::Snowflake(static_cast<uint64_t>(std::strtoull(value.GetString(), nullptr, 10)));
+        } else if (value.IsUint64()) {
+            return discpp::Snowflake(value.GetUint64());
+        }
+
+        return 0;
+    }
 
-                return discpp::Snowflake(std::string(t_doc.GetString()));
-            }
+	inline discpp::Snowflake GetIDSafely(const rapidjson::Value& json, const char* value_name) {
+        rapidjson::Value::ConstMemberIterator itr = json.FindMember(value_name);
+        if (itr != json.MemberEnd() && !itr->value.IsNull()) {
+            return GetSnowflake(itr->value);
         }
 
         return 0;
 	}
 
     template<typename T>
-    inline T GetDataSafely(const rapidjson::Document & json, const char* value_name) {
+    inline T GetDataSafely(const rapidjson::Value& json, const char* value_name) {
         rapidjson::Value::ConstMemberIterator itr = json.FindMember(value_name);
-        if (itr != json.MemberEnd()) {
-            if (!json[value_name].IsNull()) {
-                rapidjson::Document t_doc;
-                t_doc.CopyFrom(json[value_name], t_doc.GetAllocator());
-
-                return t_doc.Get<T>();
-            }
+        if (itr != json.MemberEnd() && !itr->value.IsNull()) {
+            return itr->value.Get<T>();
         }
 
         return T();
     }
 
     template<class T>
-    inline T ConstructDiscppObjectFromID(const rapidjson::Document& doc, const char* value_name, T default_val) {
+    inline T ConstructDiscppObjectFromID(const rapidjson::Value& doc, const char* value_name, T default_val) {
         rapidjson::Value::ConstMemberIterator itr = doc.FindMember(value_name);
-        if (itr != doc.MemberEnd()) {
-            if (!doc[value_name].IsNull()) {
-                rapidjson::Document t_doc;
-                t_doc.CopyFrom(doc[value_name], t_doc.GetAllocator());
-
-                return T(discpp::Snowflake(t_doc.GetString()));
-            }
+        if (itr != doc.MemberEnd() && !itr->value.IsNull()) {
+            return T(discpp::GetSnowflake(itr->value));
         }
 
         return default_val;
     }
 
+    /**
+     * @brief Constructs a discpp object from a json member, the object reads directly from the member so nothing is copied.
+     *
+     * ```cpp
+     *      author = discpp::ConstructDiscppObjectFromJson(json, "author", discpp::User());
+     * ```
+     *
+     * @param[in] doc The json object that contains the member.
+     * @param[in] value_name The name of the member.
+     * @param[in] default_val The value to return if the member is missing or null.
+     *
+     * @return T
+     */
 	template<class T>
-	inline T ConstructDiscppObjectFromJson(const rapidjson::Document& doc, const char* value_name, T default_val) {
+	inline T ConstructDiscppObjectFromJson(const rapidjson::Value& doc, const char* value_name, T default_val) {
         rapidjson::Value::ConstMemberIterator itr = doc.FindMember(value_name);
-        if (itr != doc.MemberEnd()) {
-            if (!doc[value_name].IsNull()) {
-                rapidjson::Document t_doc;
-                t_doc.CopyFrom(doc[value_name], t_doc.GetAllocator());
-
-                return T(t_doc);
-            }
+        if (itr != doc.MemberEnd() && !itr->value.IsNull()) {
+            return T(itr->value);
         }
 
         return default_val;
 	}
 
-	void IterateThroughNotNullJson(rapidjson::Document& json, const std::function<void(rapidjson::Document&)>& func);
-    bool ContainsNotNull(rapidjson::Document& json, const char * value_name);
-    std::string DumpJson(rapidjson::Document& json);
-    std::string DumpJson(rapidjson::Value& json);
-    std::unique_ptr<rapidjson::Document> GetDocumentInsideJson(rapidjson::Document &json, const char* value_name);
+	void IterateThroughNotNullJson(const rapidjson::Value& json, const std::function<void(const rapidjson::Value&)>& func);
+    bool ContainsNotNull(const rapidjson::Value& json, const char * value_name);
+    std::string DumpJson(const rapidjson::Document& json);
+    std::string DumpJson(const rapidjson::Value& json);
 
 	// Rate limits
 	struct RateLimit {
@@ -0,0 +1,56 @@
+#ifndef DISCPP_ZLIB_STREAM_H
+#define DISCPP_ZLIB_STREAM_H
+
+#include <zlib.h>
+
+#include <string>
+
+namespace discpp {
+    /**
+     * @brief Streaming inflate context for a `compress=zlib-stream` gateway connection.
+     *
+     * Discord shares one zlib context across the whole connection, so this must live as long as the
+     * websocket does and be reset whenever a new connection is made. A message may be split across
+     * several binary frames, it is only complete once the Z_SYNC_FLUSH suffix (`00 00 ff ff`) is received.
+     */
+    class ZlibStream {
+    public:
+        ZlibStream();
+        ~ZlibStream();
+
+        ZlibStream(const ZlibStream&) = delete;
+        ZlibStream& operator=(const ZlibStream&) = delete;
+
+        /**
+         * @brief Resets the inflate context, this must be called before a new connection is made.
+         *
+         * @return void
+         */
+        void Reset();
+
+        /**
+         * @brief Feeds a binary websocket frame into the inflate context.
+         *
+         * ```cpp
+         *      if (zlib_stream.Feed(msg->str, inflate_buffer)) HandlePayload(inflate_buffer);
+         * ```
+         *
+         * The output buffer is cleared before it is written to, so passing the same string for every
+         * message will reuse its allocation.
+         *
+         * @param[in] frame The binary frame that was received.
+         * @param[out] out The buffer that the decompressed payload will be written to.
+         *
+         * @throws discpp::exceptions::DecompressionException If zlib fails to inflate the data.
+         *
+         * @return bool, true if a full payload was decompressed into `out`.
+         */
+        bool Feed(const std::string& frame, std::string& out);
+    private:
+        z_stream stream;
+        bool initialized = false;
+        std::string pending; /**< Compressed frames that haven't ended with the Z_SYNC_FLUSH suffix yet. */
+    };
+}
+
+#endif
@@ -2,8 +2,8 @@
 #include "utils.h"
 
 namespace discpp {
-	discpp::Attachment::Attachment(rapidjson::Document& json) {
-		id = discpp::Snowflake(json["id"].GetString());
+	discpp::Attachment::Attachment(const rapidjson::Value& json) {
+		id = discpp::GetSnowflake(json["id"]);
 		filename = json["filename"].GetString();
 		size = json["size"].GetInt();
 		url = json["url"].GetString();
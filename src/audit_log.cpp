@@ -11,7 +11,7 @@
 #include "role.h"
 
 // This is extremely ugly and probably slow, maybe theres a way we could trim this down?
-discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j) {
+discpp::AuditLogChangeKey GetKey(const std::string& key, const rapidjson::Value& j) {
 	discpp::AuditLogChangeKey a_key;
 
 	discpp::AuditLogKey keyval = discpp::StrToKey(key);
@@ -27,13 +27,13 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
 	        a_key.splash_hash = j.GetString();
 	        break;
 	    case discpp::AuditLogKey::OWNER_ID:
-            a_key.owner_id = discpp::Snowflake(j.GetString());
+            a_key.owner_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::REGION:
             a_key.region = j.GetString();
 	        break;
 	    case discpp::AuditLogKey::AFK_CHANNEL_ID:
-            a_key.afk_channel_id = discpp::Snowflake(j.GetString());
+            a_key.afk_channel_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::AFK_TIMEOUT:
             a_key.afk_timeout = j.GetInt();
@@ -55,18 +55,12 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
 	        break;
 	    case discpp::AuditLogKey::ADD:
             for (auto const& role : j.GetArray()) {
-                rapidjson::Document role_json(rapidjson::kObjectType);
-                role_json.CopyFrom(role, role_json.GetAllocator());
-
-                a_key.roles_add.push_back(discpp::Role(role_json));
+                a_key.roles_add.push_back(discpp::Role(role));
             }
 	        break;
 	    case discpp::AuditLogKey::REMOVE:
             for (auto const& role : j.GetArray()) {
-                rapidjson::Document role_json(rapidjson::kObjectType);
-                role_json.CopyFrom(role, role_json.GetAllocator());
-
-                a_key.roles_remove.push_back(discpp::Role(role_json));
+                a_key.roles_remove.push_back(discpp::Role(role));
             }
 	        break;
 	    case discpp::AuditLogKey::PRUNE_DELETE_DAYS:
@@ -76,10 +70,10 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
             a_key.widget_enabled = j.GetBool();
 	        break;
 	    case discpp::AuditLogKey::WIDGET_CHANNEL_ID:
-            a_key.widget_channel_id = discpp::Snowflake(j.GetString());
+            a_key.widget_channel_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::SYSTEM_CHANNEL_ID:
-            a_key.system_channel_id = discpp::Snowflake(j.GetString());
+            a_key.system_channel_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::POSITION:
             a_key.position = j.GetInt();
@@ -92,17 +86,14 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
 	        break;
 	    case discpp::AuditLogKey::PERMISSION_OVERWRITES:
             for (auto const& perm : j.GetArray()) {
-                rapidjson::Document perm_json(rapidjson::kObjectType);
-                perm_json.CopyFrom(perm, perm_json.GetAllocator());
-
-                a_key.permission_overwrites.push_back(discpp::Permissions(perm_json));
+                a_key.permission_overwrites.push_back(discpp::Permissions(perm));
             }
 	        break;
 	    case discpp::AuditLogKey::NSFW:
             a_key.nsfw = j.GetBool();
 	        break;
 	    case discpp::AuditLogKey::APPLICATION_ID:
-            a_key.application_id = discpp::Snowflake(j.GetString());
+            a_key.application_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::RATE_LIMIT_PER_USER:
             a_key.rate_limit_per_user = j.GetInt();
@@ -129,10 +120,10 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
             a_key.code = j.GetString();
 	        break;
 	    case discpp::AuditLogKey::CHANNEL_ID:
-            a_key.channel_id = discpp::Snowflake(j.GetString());
+            a_key.channel_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::INVITER_ID:
-            a_key.inviter_id = discpp::Snowflake(j.GetString());
+            a_key.inviter_id = discpp::GetSnowflake(j);
 	        break;
 	    case discpp::AuditLogKey::MAX_USES:
             a_key.max_uses = j.GetInt();
@@ -158,7 +149,7 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
         case discpp::AuditLogKey::AVATAR_HASH:
             break;
         case discpp::AuditLogKey::ID:
-            a_key.id = discpp::Snowflake(j.GetString());
+            a_key.id = discpp::GetSnowflake(j);
             break;
         case discpp::AuditLogKey::TYPE:
             a_key.type = j.GetString();
@@ -177,29 +168,27 @@ discpp::AuditLogChangeKey GetKey(const std::string& key, rapidjson::Document& j)
 	return a_key;
 }
 
-discpp::AuditLogChange::AuditLogChange(rapidjson::Document& json) {
+discpp::AuditLogChange::AuditLogChange(const rapidjson::Value& json) {
 	key = json["key"].GetString();
 
 	if (ContainsNotNull(json, "new_value")) {
-	    std::unique_ptr<rapidjson::Document> new_value_json = GetDocumentInsideJson(json, "new_value");
-		new_value = GetKey(key, *new_value_json);
+		new_value = GetKey(key, json["new_value"]);
 	}
 
     if (ContainsNotNull(json, "old_value")) {
-        std::unique_ptr<rapidjson::Document> old_value_json = GetDocumentInsideJson(json, "old_value");
-        old_value = GetKey(key, *old_value_json);
+        old_value = GetKey(key, json["old_value"]);
     }
 }
 
-discpp::AuditEntryOptions::AuditEntryOptions(rapidjson::Document& json) {
+discpp::AuditEntryOptions::AuditEntryOptions(const rapidjson::Value& json) {
 	delete_member_days = GetDataSafely<std::string>(json, "delete_member_days");
 	members_removed = GetDataSafely<std::string>(json, "members_removed");
 	// @TODO: Make channel valid.
 	if (ContainsNotNull(json, "channel_id")) {
-        channel_id = discpp::Snowflake(json["channel_id"].GetString());
+        channel_id = discpp::GetSnowflake(json["channel_id"]);
 	}
     if (ContainsNotNull(json, "message_id")) {
-        message_id = discpp::Snowflake(json["message_id"].GetString());
+        message_id = discpp::GetSnowflake(json["message_id"]);
     }
 	count = GetDataSafely<std::string>(json, "count");
 	id = GetIDSafely(json, "id");
@@ -207,49 +196,34 @@ discpp::AuditEntryOptions::AuditEntryOptions(rapidjson::Document& json) {
 	role_name = GetDataSafely<std::string>(json, "role_name");
 }
 
-discpp::AuditLogEntry::AuditLogEntry(rapidjson::Document& json) {
+discpp::AuditLogEntry::AuditLogEntry(const rapidjson::Value& json) {
     target_id = GetDataSafely<std::string>(json, "target_id");
     if (ContainsNotNull(json, "changes")) {
         for (auto const& change : json["changes"].GetArray()) {
-            rapidjson::Document change_json(rapidjson::kObjectType);
-            change_json.CopyFrom(change, change_json.GetAllocator());
-
-            changes.push_back(discpp::AuditLogChange(change_json));
+            changes.push_back(discpp::AuditLogChange(change));
         }
     }
-    user = discpp::User(discpp::Snowflake(json["user_id"].GetString()));
-    id = discpp::Snowflake(json["id"].GetString());
+    user = discpp::User(discpp::GetSnowflake(json["user_id"]));
+    id = discpp::GetSnowflake(json["id"]);
     action_type = static_cast<discpp::AuditLogEvent>(json["action_type"].GetInt());
     options = ConstructDiscppObjectFromJson(json, "options", discpp::AuditEntryOptions());
     reason = GetDataSafely<std::string>(json, "reason");
 }
 
-discpp::AuditLog::AuditLog(rapidjson::Document& json) {
+discpp::AuditLog::AuditLog(const rapidjson::Value& json) {
     for (auto const& webhook : json["webhooks"].GetArray()) {
-        rapidjson::Document webhook_json(rapidjson::kObjectType);
-        webhook_json.CopyFrom(webhook, webhook_json.GetAllocator());
-
-        webhooks.push_back(discpp::Webhook(webhook_json));
+        webhooks.push_back(discpp::Webhook(webhook));
     }
 
     for (auto const& user : json["user"].GetArray()) {
-        rapidjson::Document user_json(rapidjson::kObjectType);
-        user_json.CopyFrom(user, user_json.GetAllocator());
-
-        users.push_back(discpp::User(user_json));
+        users.push_back(discpp::User(user));
     }
 
     for (auto const& audit_log_entry : json["audit_log_entries"].GetArray()) {
-        rapidjson::Document audit_log_entry_json(rapidjson::kObjectType);
-        audit_log_entry_json.CopyFrom(audit_log_entry, audit_log_entry_json.GetAllocator());
-
-        audit_log_entries.push_back(discpp::AuditLogEntry(audit_log_entry_json));
+        audit_log_entries.push_back(discpp::AuditLogEntry(audit_log_entry));
     }
 
     for (auto const& integration : json["integrations"].GetArray()) {
-        rapidjson::Document integration_json(rapidjson::kObjectType);
-        integration_json.CopyFrom(integration, integration_json.GetAllocator());
-
-        integrations.push_back(discpp::Integration(integration_json));
+        integrations.push_back(discpp::Integration(integration));
     }
 }
\ No newline at end of file
@@ -7,55 +7,65 @@
 #include "cache.h"
 #include "exceptions.h"
 #include "utils.h"
+#include "client.h"
+
+#include <algorithm>
+#include <unordered_set>
 
 std::shared_ptr<discpp::Guild> discpp::Cache::GetGuild(const discpp::Snowflake &guild_id, bool can_request) {
-    auto it = guilds.find(guild_id);
-    if (it != guilds.end()) {
-        return it->second;
+    if (std::optional<std::shared_ptr<discpp::Guild>> guild = guilds.Get(guild_id)) {
+        return *guild;
     }
 
     if (can_request) {
         std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/guilds/" + std::to_string(guild_id)), DefaultHeaders(), guild_id, RateLimitBucketType::GUILD);
         auto guild = std::make_shared<discpp::Guild>(*result);
-        guilds.emplace(guild->id, guild);
+        guilds.Insert(guild->id, guild);
         return guild;
     } else {
         throw exceptions::DiscordObjectNotFound("Guild not found of id: " + std::to_string(guild_id));
     }
 }
 
+std::optional<discpp::Channel> discpp::Cache::FindChannel(const discpp::Snowflake& id) const {
+    std::optional<discpp::Snowflake> guild_id = channel_guilds.Get(id);
+    if (!guild_id) return std::nullopt;
+
+    if (*guild_id == 0) return private_channels.Get(id);
+
+    std::optional<std::shared_ptr<discpp::Guild>> guild = guilds.Get(*guild_id);
+    if (!guild) return std::nullopt;
+
+    auto channel = (*guild)->channels.find(id);
+    if (channel == (*guild)->channels.end()) return std::nullopt;
+
+    return channel->second;
+}
+
 discpp::Channel discpp::Cache::GetChannel(const discpp::Snowflake &id, bool can_request) {
-    try {
-        return GetDMChannel(id, can_request);
-    } catch (exceptions::DiscordObjectNotFound) {
-        for (const auto &guild : guilds) {
-            try {
-                discpp::Channel channel = guild.second->GetChannel(id);
-
-                if (channel.id != 0) return channel;
-            } catch (exceptions::DiscordObjectNotFound) {}
-        }
+    if (std::optional<discpp::Channel> channel = FindChannel(id)) {
+        return *channel;
+    }
 
-        if (can_request) {
-            std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/channels/" + std::to_string(id)), DefaultHeaders(), id, RateLimitBucketType::CHANNEL);
-            return discpp::Channel(*result);
-        } else {
-            throw exceptions::DiscordObjectNotFound("Channel not found of id: " + std::to_string(id));
-        }
+    if (can_request) {
+        std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/channels/" + std::to_string(id)), DefaultHeaders(), id, RateLimitBucketType::CHANNEL);
+        return discpp::Channel(*result);
+    } else {
+        throw exceptions::DiscordObjectNotFound("Channel not found of id: " + std::to_string(id));
     }
 }
 
 discpp::Channel discpp::Cache::GetDMChannel(const discpp::Snowflake &id, bool can_request) {
-    auto it = private_channels.find(id);
-    if (it != private_channels.end()) {
-        return it->second;
+    if (std::optional<discpp::Channel> channel = private_channels.Get(id)) {
+        return *channel;
     }
 
     if (can_request) {
         std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/channels/" + std::to_string(id)), DefaultHeaders(), id, RateLimitBucketType::CHANNEL);
         discpp::Channel channel(*result);
 
-        private_channels.emplace(channel.id, channel);
+        private_channels.Insert(channel.id, channel);
+        channel_guilds.InsertOrAssign(channel.id, 0);
         return channel;
     } else {
         throw exceptions::DiscordObjectNotFound("DM Channel not found of id: " + std::to_string(id));
@@ -63,15 +73,14 @@ discpp::Channel discpp::Cache::GetDMChannel(const discpp::Snowflake &id, bool ca
 }
 
 std::shared_ptr<discpp::Member> discpp::Cache::GetMember(const discpp::Snowflake& guild_id, const discpp::Snowflake &id, bool can_request) {
-    auto it = members.find(id);
-    if (it != members.end()) {
-        return it->second;
+    if (std::optional<std::shared_ptr<discpp::Member>> member = members.Get(id)) {
+        return *member;
     }
 
     if (can_request) {
         std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/guilds/" + std::to_string(guild_id) + "/members/" + std::to_string(id)), DefaultHeaders(), guild_id, RateLimitBucketType::GUILD);
         auto member = std::make_shared<discpp::Member>(*result, guild_id);
-        members.emplace(member->user.id, member);
+        members.Insert(member->user.id, member);
         return member;
     } else {
         throw exceptions::DiscordObjectNotFound("Member not found of id: " + std::to_string(guild_id) + ", in guild of id: " + std::to_string(guild_id));
@@ -79,9 +88,8 @@ std::shared_ptr<discpp::Member> discpp::Cache::GetMember(const discpp::Snowflake
 }
 
 discpp::Message discpp::Cache::GetDiscordMessage(const discpp::Snowflake &channel_id, const discpp::Snowflake &id, bool can_request) {
-    auto message = messages.find(id);
-    if (message != messages.end()) {
-        return *message->second;
+    if (std::shared_ptr<discpp::Message> message = messages.Get(id)) {
+        return *message;
     }
 
     if (can_request) {
@@ -93,3 +101,134 @@ discpp::Message discpp::Cache::GetDiscordMessage(const discpp::Snowflake &channe
         throw exceptions::DiscordObjectNotFound("Message of id \"" + std::to_string(id) + "\" was not found!");
     }
 }
+
+std::shared_ptr<discpp::Guild> discpp::Cache::UpdateGuild(const discpp::Snowflake& guild_id, const std::function<void(discpp::Guild&)>& update) {
+    std::shared_ptr<discpp::Guild> updated;
+    guilds.Update(guild_id, [&](std::shared_ptr<discpp::Guild>& guild) {
+        updated = std::make_shared<discpp::Guild>(*guild);
+        update(*updated);
+        guild = updated;
+    });
+
+    return updated;
+}
+
+void discpp::Cache::SetPolicies(const discpp::CachePolicies& policies) {
+    this->policies = policies;
+
+    member_expiry.SetTTL(policies.members.Expires() ? policies.members.ttl : std::chrono::seconds::zero());
+    presence_expiry.SetTTL(policies.presences.Expires() ? policies.presences.ttl : std::chrono::seconds::zero());
+    message_expiry.SetTTL(policies.messages.Expires() ? policies.messages.ttl : std::chrono::seconds::zero());
+    dm_channel_expiry.SetTTL(policies.dm_channels.Expires() ? policies.dm_channels.ttl : std::chrono::seconds::zero());
+    emoji_expiry.SetTTL(policies.emojis.Expires() ? policies.emojis.ttl : std::chrono::seconds::zero());
+    voice_state_expiry.SetTTL(policies.voice_states.Expires() ? policies.voice_states.ttl : std::chrono::seconds::zero());
+}
+
+void discpp::Cache::TouchGuild(const discpp::Guild& guild) {
+    if (policies.members.Expires() || policies.presences.Expires()) {
+        guild.members->ForEach([&](const discpp::Snowflake& user_id, const std::shared_ptr<discpp::Member>& member) {
+            member_expiry.Touch(guild.id, user_id);
+            if (member->presence) presence_expiry.Touch(guild.id, user_id);
+        });
+    }
+
+    if (policies.emojis.Expires()) {
+        for (const auto& emoji : guild.emojis) {
+            emoji_expiry.Touch(guild.id, emoji.first);
+        }
+    }
+
+    if (policies.voice_states.Expires()) {
+        for (const discpp::VoiceState& voice_state : guild.voice_states) {
+            voice_state_expiry.Touch(guild.id, voice_state.user_id);
+        }
+    }
+}
+
+void discpp::Cache::ExpireEntries() {
+    struct ExpiredGuildObjects {
+        std::unordered_set<discpp::Snowflake> members;
+        std::unordered_set<discpp::Snowflake> presences;
+        std::unordered_set<discpp::Snowflake> emojis;
+        std::unordered_set<discpp::Snowflake> voice_states;
+    };
+
+    std::unordered_map<discpp::Snowflake, ExpiredGuildObjects> expired;
+    for (const discpp::CacheExpiry::Entry& entry : member_expiry.TakeExpired()) {
+        expired[entry.first].members.insert(entry.second);
+    }
+    for (const discpp::CacheExpiry::Entry& entry : presence_expiry.TakeExpired()) {
+        expired[entry.first].presences.insert(entry.second);
+    }
+    for (const discpp::CacheExpiry::Entry& entry : emoji_expiry.TakeExpired()) {
+        expired[entry.first].emojis.insert(entry.second);
+    }
+    for (const discpp::CacheExpiry::Entry& entry : voice_state_expiry.TakeExpired()) {
+        expired[entry.first].voice_states.insert(entry.second);
+    }
+
+    for (const discpp::CacheExpiry::Entry& entry : message_expiry.TakeExpired()) {
+        messages.Erase(entry.second);
+    }
+    for (const discpp::CacheExpiry::Entry& entry : dm_channel_expiry.TakeExpired()) {
+        private_channels.Erase(entry.second);
+        channel_guilds.Erase(entry.second);
+    }
+
+    discpp::Snowflake bot_id = discpp::globals::client_instance ? discpp::globals::client_instance->client_user.id : discpp::Snowflake();
+    for (auto& guild_objects : expired) {
+        const discpp::Snowflake& guild_id = guild_objects.first;
+        ExpiredGuildObjects& objects = guild_objects.second;
+
+        objects.members.erase(bot_id);
+
+        // The members whose presence was removed, so the members map can follow the guild.
+        std::vector<std::pair<std::shared_ptr<discpp::Member>, std::shared_ptr<discpp::Member>>> changed_members;
+        if (std::optional<std::shared_ptr<discpp::Guild>> guild = guilds.Get(guild_id)) {
+            discpp::GuildMembers& guild_members = *(*guild)->members;
+            for (const discpp::Snowflake& user_id : objects.members) {
+                guild_members.Erase(user_id);
+            }
+
+            for (const discpp::Snowflake& user_id : objects.presences) {
+                guild_members.Update(user_id, [&](std::shared_ptr<discpp::Member>& cached) {
+                    if (!cached->presence) return;
+
+                    auto member = std::make_shared<discpp::Member>(*cached);
+                    member->presence = nullptr;
+
+                    changed_members.emplace_back(cached, member);
+                    cached = member;
+                });
+            }
+        }
+
+        // The guild itself is only replaced when something other than its members expired.
+        if (!objects.emojis.empty() || !objects.voice_states.empty()) {
+            UpdateGuild(guild_id, [&](discpp::Guild& guild) {
+                for (const discpp::Snowflake& emoji_id : objects.emojis) {
+                    guild.emojis.erase(emoji_id);
+                }
+
+                if (!objects.voice_states.empty()) {
+                    auto expired_voice_state = [&](const discpp::VoiceState& voice_state) {
+                        return objects.voice_states.count(voice_state.user_id) != 0;
+                    };
+                    guild.voice_states.erase(std::remove_if(guild.voice_states.begin(), guild.voice_states.end(), expired_voice_state), guild.voice_states.end());
+                }
+            });
+        }
+
+        for (const discpp::Snowflake& user_id : objects.members) {
+            std::optional<std::shared_ptr<discpp::Member>> cached = members.Get(user_id);
+            if (cached && (*cached)->guild_id == guild_id) members.Erase(user_id);
+        }
+
+        for (const auto& change : changed_members) {
+            const std::shared_ptr<discpp::Member>& old_member = change.first;
+            members.Update(old_member->user.id, [&](std::shared_ptr<discpp::Member>& cached) {
+                if (cached == old_member) cached = change.second;
+            });
+        }
+    }
+}
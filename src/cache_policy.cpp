@@ -0,0 +1,52 @@
+#include "cache_policy.h"
+
+namespace discpp {
+    void CacheExpiry::SetTTL(std::chrono::seconds ttl) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        this->ttl = ttl;
+        if (ttl <= std::chrono::seconds::zero()) {
+            records.clear();
+            cached_at.clear();
+        }
+    }
+
+    void CacheExpiry::Touch(const Snowflake& owner_id, const Snowflake& id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ttl <= std::chrono::seconds::zero()) return;
+
+        auto now = std::chrono::steady_clock::now();
+        Entry entry(owner_id, id);
+
+        records.push_back(Record{ entry, now });
+        cached_at[entry] = now;
+    }
+
+    void CacheExpiry::Forget(const Snowflake& owner_id, const Snowflake& id) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Its record is skipped once it's the oldest.
+        cached_at.erase(Entry(owner_id, id));
+    }
+
+    std::vector<CacheExpiry::Entry> CacheExpiry::TakeExpired() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<Entry> expired;
+        auto now = std::chrono::steady_clock::now();
+        while (!records.empty() && records.front().cached_at + ttl <= now) {
+            const Record& record = records.front();
+
+            // An object that was cached again has a newer record, which it expires with instead.
+            auto it = cached_at.find(record.entry);
+            if (it != cached_at.end() && it->second == record.cached_at) {
+                expired.push_back(record.entry);
+                cached_at.erase(it);
+            }
+
+            records.pop_front();
+        }
+
+        return expired;
+    }
+}
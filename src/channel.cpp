@@ -6,13 +6,17 @@
 #include "guild.h"
 #include "exceptions.h"
 
+#ifdef DISCPP_COROUTINES
+#include "coroutine.h"
+#endif
+
 namespace discpp {
 	Channel::Channel(const Snowflake& id, bool can_request) : discpp::DiscordObject(id) {
 		*this = globals::client_instance->cache.GetChannel(id, can_request);
 	}
 
-	Channel::Channel(rapidjson::Document& json) {
-	    id = discpp::Snowflake(json["id"].GetString());
+	Channel::Channel(const rapidjson::Value& json) {
+	    id = discpp::GetSnowflake(json["id"]);
 		type = static_cast<ChannelType>(json["type"].GetInt());
 		name = GetDataSafely<std::string>(json, "name");
 		topic = GetDataSafely<std::string>(json, "topic");
@@ -23,10 +27,7 @@ namespace discpp {
 
         if (ContainsNotNull(json, "permission_overwrites")) {
             for (auto& permission_overwrite : json["permission_overwrites"].GetArray()) {
-                rapidjson::Document permission_json;
-                permission_json.CopyFrom(permission_overwrite, permission_json.GetAllocator());
-
-                permissions.push_back(discpp::Permissions(permission_json));
+                permissions.push_back(discpp::Permissions(permission_overwrite));
             }
         }
 
@@ -38,10 +39,7 @@ namespace discpp {
 
         if (ContainsNotNull(json, "recipients")) {
             for (auto& recipient : json["recipients"].GetArray()) {
-                rapidjson::Document user_json;
-                user_json.CopyFrom(recipient, user_json.GetAllocator());
-
-                recipients.emplace_back(user_json);
+                recipients.emplace_back(recipient);
             }
         }
 
@@ -129,6 +127,15 @@ namespace discpp {
         return discpp::Message(*result);
 	}
 
+#ifdef DISCPP_COROUTINES
+	discpp::Task<discpp::Message> Channel::SendAsync(std::string text, bool tts, discpp::EmbedBuilder* embed, std::vector<File> files) {
+        // Tasks start right away, so this copy is made before the caller's channel can go away.
+        discpp::Channel channel = *this;
+
+        co_return co_await RunOnExecutor([&] { return channel.Send(text, tts, embed, files); });
+	}
+#endif
+
 	std::string ChannelPropertyToString(ChannelProperty prop) {
         std::unordered_map<ChannelProperty, std::string> prop_str_map = {
                 {ChannelProperty::NAME, "name"}, {ChannelProperty::POSITION, "position"},
@@ -187,9 +194,7 @@ namespace discpp {
 
 		std::vector<discpp::Message> messages;
 		for (auto& message : result->GetArray()) {
-			rapidjson::Document message_json;
-			message_json.CopyFrom(message, message_json.GetAllocator());
-			messages.emplace_back(message_json);
+			messages.emplace_back(message);
 		}
 
 		return messages;
@@ -210,9 +215,7 @@ namespace discpp {
 
         std::vector<discpp::Message> messages;
         for (auto &message : result->GetArray()) {
-            rapidjson::Document message_json;
-            message_json.CopyFrom(message, message_json.GetAllocator());
-            messages.push_back(discpp::Message(message_json));
+            messages.push_back(discpp::Message(message));
         }
 
         return messages;
@@ -299,9 +302,7 @@ namespace discpp {
 		std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/channels/" + std::to_string(id) + "/invites"), DefaultHeaders(), {}, {});
 		std::vector<discpp::GuildInvite> invites;
 		for (auto& invite : result->GetArray()) {
-			rapidjson::Document invite_json;
-			invite_json.CopyFrom(invite, invite_json.GetAllocator());
-			invites.push_back(discpp::GuildInvite(invite_json));
+			invites.push_back(discpp::GuildInvite(invite));
 		}
 
 		return invites;
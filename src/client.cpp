@@ -11,31 +11,88 @@
 #include "client_config.h"
 #include "exceptions.h"
 #include "settings.h"
+#include "intents.h"
 #include "events/reconnect_event.h"
 
 #include <ixwebsocket/IXNetSystem.h>
 
+#include <algorithm>
+
 namespace discpp {
     Client::Client(const std::string& token, ClientConfig* config) : token(token), config(config) {
         fire_command_method = std::bind(discpp::FireCommand, std::placeholders::_1, std::placeholders::_2);
 
         discpp::globals::client_instance = this;
 
-        message_cache_count = config->message_cache_size;
+        cache.SetPolicies(config->cache_policies);
+
+        const CachePolicy<Message>& message_policy = config->cache_policies.messages;
+        if (message_policy.type == CachePolicyType::OFF) {
+            message_cache_count = 0;
+        } else if (message_policy.type == CachePolicyType::BOUNDED) {
+            message_cache_count = static_cast<int>(message_policy.max_entries);
+        } else {
+            message_cache_count = config->message_cache_size;
+        }
+        cache.messages.SetCapacity(std::max(message_cache_count, 0), std::max(config->message_cache_channel_size, 0));
+
+        if (!config->identify_scheduler) {
+            config->identify_scheduler = std::make_shared<discpp::BucketIdentifyScheduler>();
+        }
 
         if (config->logger_path.empty()) {
             logger = new discpp::Logger(config->logger_flags);
         } else {
             logger = new discpp::Logger(config->logger_path, config->logger_flags);
         }
+
+        executor = std::make_unique<ThreadPool>(config->worker_threads, [this](std::exception_ptr exception) {
+            try {
+                std::rethrow_exception(exception);
+            } catch (const std::exception& e) {
+                logger->Error(LogTextColor::RED + "Uncaught exception in a task: " + e.what());
+            } catch (...) {
+                logger->Error(LogTextColor::RED + "Uncaught exception in a task.");
+            }
+        });
+        strands = std::make_unique<StrandExecutor>(*executor);
+        timers = std::make_unique<TimerQueue>();
+
+        event_queues = std::make_unique<EventQueues>(*strands);
+        for (const auto& limit : config->event_queues) {
+            event_queues->SetLimit(limit.first, limit.second);
+        }
+    }
+
+    Client::~Client() {
+        // Tasks the pool still runs while it stops can add timers, like the batcher's flush, which a stopped timer
+        // queue drops. Both are only destroyed once the pool has finished.
+        timers->Stop();
+        executor->Stop();
+
+        timers.reset();
+        executor.reset();
     }
 
     int Client::Run() {
         EventDispatcher::BindEvents();
 
-        DoFunctionLater([&] {
+        if (cache.policies.AnyExpires()) {
+            ScheduleCacheExpiry();
+        }
+
+        if (config->intents) {
+            GatewayIntents missing = SuggestIntents() & ~*config->intents;
+            if (missing != GatewayIntents::NONE) {
+                logger->Warn(LogTextColor::YELLOW + "Listeners are registered for events that the configured intents won't receive, missing intents: " + std::to_string(static_cast<uint32_t>(missing)));
+            }
+        }
+
+        auto start_shards = [&] {
             rapidjson::Document gateway_request(rapidjson::kObjectType);
-            switch (config->type) {
+            if (!config->gateway_url.empty()) {
+                gateway_request.AddMember("url", config->gateway_url, gateway_request.GetAllocator());
+            } else switch (config->type) {
                 case TokenType::USER: {
                     std::unique_ptr<rapidjson::Document> user_doc = SendGetRequest(Endpoint("/gateway"), {{"Authorization", token}, {"User-Agent", "discpp (https://github.com/DisCPP/DisCPP, v0.0.0)"}}, {}, {});
                     gateway_request.CopyFrom(*user_doc, gateway_request.GetAllocator());
@@ -56,70 +113,159 @@ namespace discpp {
                     throw exceptions::MaximumLimitException("Gateway start limit exceeded!");
                 }
 
+                // User tokens and older responses don't send max_concurrency, which means only one shard can identify at a time.
+                int max_concurrency = 1;
+                if (ContainsNotNull(gateway_request, "session_start_limit") &&
+                    ContainsNotNull(gateway_request["session_start_limit"], "max_concurrency")) {
+                    max_concurrency = gateway_request["session_start_limit"]["max_concurrency"].GetInt();
+                }
+                config->identify_scheduler->SetMaxConcurrency(max_concurrency);
+                logger->Debug("Gateway max concurrency: " + std::to_string(max_concurrency));
+
+                total_shards = config->total_shards > 0 ? config->total_shards : config->shard_amount;
+
                 if (ContainsNotNull(gateway_request, "shards")) {
                     int recommended_shards = gateway_request["shards"].GetInt();
-                    if (recommended_shards > config->shard_amount) {
+                    if (config->total_shards > 0) {
+                        // The other processes in the cluster were started with the same total, so it can't be changed here.
+                        if (recommended_shards > total_shards) {
+                            logger->Warn(LogTextColor::YELLOW + "You set total shards to \"" + std::to_string(total_shards) + \
+                                "\" but discord recommends to use \"" + std::to_string(recommended_shards) + "\".");
+                        }
+                    } else if (recommended_shards > config->shard_amount) {
                         logger->Warn(LogTextColor::YELLOW + "You set shard amount to \"" + std::to_string(config->shard_amount) + \
                             "\" but discord recommends to use \"" + std::to_string(recommended_shards) + "\", so we're gonna listen to Discord...");
 
                         config->shard_amount = recommended_shards;
+                        total_shards = recommended_shards;
                     }
                 }
 
                 // Specify version and encoding just ot be safe
-                std::string url = std::string(gateway_request["url"].GetString()) + "/?v=6&encoding=json";
+                std::string encoding = config->gateway_encoding == GatewayEncoding::ETF ? "etf" : "json";
+                std::string url = std::string(gateway_request["url"].GetString()) + "/?v=6&encoding=" + encoding;
+                if (config->zlib_compress) {
+                    url += "&compress=zlib-stream";
+                }
+
+                std::vector<int> shard_ids = config->shard_ids;
+                if (shard_ids.empty()) {
+                    for (int i = 0; i < total_shards; i++) {
+                        shard_ids.push_back(i);
+                    }
+                }
+
+                // All shards connect right away, the identify scheduler spaces out their identify payloads.
+                for (int shard_id : shard_ids) {
+                    if (shard_id < 0 || shard_id >= total_shards) {
+                        logger->Error(LogTextColor::RED + "Shard id " + std::to_string(shard_id) + " is outside of the total shards (" + std::to_string(total_shards) + "), it will not be started.");
+                        continue;
+                    }
+
+                    std::optional<ShardSession> session;
+                    if (config->session_store) {
+                        session = config->session_store->Load(shard_id);
+                    }
+
+                    // The saved url is only used if it was saved with the same connection options.
+                    std::string shard_url = url;
+                    if (session && !session->gateway_url.empty()) {
+                        // The options are the query, a url without one was made without options.
+                        size_t saved_query = session->gateway_url.find('?');
+                        size_t query = url.find('?');
+                        std::string saved_options = saved_query == std::string::npos ? "" : session->gateway_url.substr(saved_query);
+                        std::string options = query == std::string::npos ? "" : url.substr(query);
+
+                        if (saved_options == options) {
+                            shard_url = session->gateway_url;
+                        }
+                    }
+
+                    auto* shard = new Shard(*this, shard_id, shard_url);
+                    if (session) {
+                        logger->Info(LogTextColor::GREEN + "[SHARD " + std::to_string(shard_id) + "] Found a saved session, it will be resumed.");
 
-                for (int i = 0; i < config->shard_amount; i++) {
-                    auto* shard = new Shard(*this, i, url);
+                        shard->SetSessionId(session->session_id);
+                        shard->last_sequence_number = session->sequence;
+                    }
                     shard->WebSocketStart();
 
                     shards.emplace_back(shard);
-
-                    // We can only start a new shard every 5 seconds.
-                    std::this_thread::sleep_for(std::chrono::milliseconds(5050));
                 }
             } else {
 
             }
-        });
+        };
 
-        while (run) {
-            {
-                std::lock_guard<std::mutex> futures_guard(this->futures_mutex);
-                futures.erase(std::remove_if(futures.begin(), futures.end(), [](const std::future<void>& future) {
-                    return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-                }), futures.end());
+        // The pool's error handler only logs, so an exception is taken to here instead, shards can't start without
+        // the gateway.
+        DoFunctionLater([&] {
+            try {
+                start_shards();
+            } catch (...) {
+                startup_exception = std::current_exception();
+                StopClient();
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
+        });
+
+        std::unique_lock<std::mutex> run_lock(run_mutex);
+        run_condition.wait(run_lock, [this] { return !run; });
+
+        if (startup_exception) std::rethrow_exception(startup_exception);
 
         return 0;
     }
 
-    void Shard::CreateWebsocketRequest(rapidjson::Document& json, const std::string& message) {
-        std::string json_payload = DumpJson(json);
+    Shard::Shard(Client& client, int id, std::string endpoint) : id(id), client(client), gateway_endpoint(std::move(endpoint)),
+        send_queue([this](const std::string& payload) { websocket.send(payload, codec->IsBinary()); }), start_time(std::chrono::steady_clock::now()) {
+        codec = GatewayCodec::Create(client.config->gateway_encoding);
 
+        for (GatewayEvent event : client.config->ignored_events) {
+            // The shard can't become ready without these.
+            if (event == GatewayEvent::READY || event == GatewayEvent::RESUMED) continue;
+
+            ignored_events.set(static_cast<size_t>(event));
+        }
+    }
+
+    bool Shard::IsIgnoredEvent(GatewayEvent event) const {
+        return ignored_events.test(static_cast<size_t>(event));
+    }
+
+    void Shard::CreateWebsocketRequest(rapidjson::Document& json, const std::string& message) {
         if (message.empty()) {
-            client.logger->Debug("[SHARD " + std::to_string(id) + "] Sending gateway payload: " + json_payload);
+            client.logger->Debug("[SHARD " + std::to_string(id) + "] Sending gateway payload: " + DumpJson(json));
         } else {
             client.logger->Debug(message);
         }
 
-        WaitForRateLimits(client.client_user.id, RateLimitBucketType::GLOBAL);
+        int op = json["op"].GetInt();
+        GatewaySendLane lane = (op == Opcode::HEARTBEAT || op == Opcode::IDENTIFY || op == Opcode::RESUME) ? GatewaySendLane::PRIORITY : GatewaySendLane::NORMAL;
+
+        // A replayed shard has no connection to send on.
+        if (replaying) return;
+
+        send_queue.Push(codec->Encode(json), lane, op == Opcode::STATUS_UPDATE);
+    }
+
+    GatewaySendQueueStats Shard::GetSendQueueStats() const {
+        return send_queue.GetStats();
+    }
 
-        //std::lock_guard<std::mutex> lock = std::lock_guard(websocket_client_mutex);
-        websocket.sendText(json_payload);
+    Shard* Shard::GetCurrent() {
+        return current;
     }
 
     void Client::SetCommandHandler(const std::function<void(discpp::Client*, discpp::Message)>& command_handler) {
         fire_command_method = command_handler;
+        custom_command_handler = true;
     }
 
-    void Shard::DisconnectWebsocket() {
+    void Shard::DisconnectWebsocket(uint16_t code) {
         client.logger->Debug(LogTextColor::YELLOW + "[SHARD " + std::to_string(id) + "] Closing websocket connection...");
 
-        websocket.close(ix::WebSocketCloseConstants::kNormalClosureCode);
-        websocket.stop(ix::WebSocketCloseConstants::kNormalClosureCode);
+        websocket.close(code);
+        websocket.stop(code);
     }
 
     void Shard::WebSocketStart() {
@@ -130,6 +276,10 @@ namespace discpp {
         websocket.setUrl(gateway_endpoint);
         websocket.disableAutomaticReconnection();
 
+        // Every connection gets its own zlib context and rate limit.
+        zlib_stream.Reset();
+        send_queue.Reset();
+
         websocket.setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
             OnWebSocketListen(const_cast<ix::WebSocketMessagePtr&>(msg));
         });
@@ -143,7 +293,7 @@ namespace discpp {
         disconnected = false;
     }
 
-    void Shard::HandleDiscordDisconnect(const ix::WebSocketMessagePtr& msg) {
+    void Shard::HandleDiscordDisconnect(const ix::WebSocketCloseInfo& close_info) {
         // if we're reconnecting this just stop here.
         if (reconnecting) {
             client.logger->Debug("[SHARD " + std::to_string(id) + "] Websocket was closed for reconnecting...");
@@ -152,7 +302,7 @@ namespace discpp {
             client.logger->Warn(LogTextColor::YELLOW + "[SHARD " + std::to_string(id) + "] Websocket was closed.");
             return;
         } else {
-            client.logger->Error(LogTextColor::RED + "[SHARD " + std::to_string(id) + "] Websocket was closed with error: " + std::to_string(msg->closeInfo.code) + ", " + msg->closeInfo.reason + "! Attempting reconnect...");
+            client.logger->Error(LogTextColor::RED + "[SHARD " + std::to_string(id) + "] Websocket was closed with error: " + std::to_string(close_info.code) + ", " + close_info.reason + "! Attempting reconnect...");
         }
 
         heartbeat_acked = false;
@@ -167,28 +317,80 @@ namespace discpp {
             case ix::WebSocketMessageType::Open:
                 client.logger->Info(LogTextColor::GREEN + "[SHARD " + std::to_string(id) + "] Connected to gateway!");
                 disconnected = false;
+
+                // Marks where a new zlib stream starts when the log is replayed.
+                if (client.config->gateway_recorder) {
+                    client.config->gateway_recorder->Record(id, GatewayFrame::CONNECTED, std::string());
+                }
                 break;
-            case ix::WebSocketMessageType::Close: {
-                std::lock_guard<std::mutex> futures_guard(client.futures_mutex);
-                client.futures.push_back(std::async(std::launch::async, &Shard::HandleDiscordDisconnect, this, std::move(msg)));
+            case ix::WebSocketMessageType::Close:
+                client.DoFunctionLater(&Shard::HandleDiscordDisconnect, this, msg->closeInfo);
                 break;
-            } case ix::WebSocketMessageType::Error:
+            case ix::WebSocketMessageType::Error:
                 client.logger->Error(LogTextColor::RED + "[SHARD " + std::to_string(id) + "] Error: " + msg->errorInfo.reason);
                 break;
-            case ix::WebSocketMessageType::Message:{
-                rapidjson::Document result;
-                result.Parse(msg->str);
-                if (result.HasParseError()) client.logger->Debug(LogTextColor::YELLOW + "[SHARD " + std::to_string(id) + "] A non-json payload was received and ignored: \"" + msg->str);
-                if (!result.IsNull()) OnWebSocketPacket(result);
+            case ix::WebSocketMessageType::Message:
+                if (client.config->gateway_recorder) {
+                    uint8_t flags = (msg->binary ? GatewayFrame::BINARY : 0) | (client.config->zlib_compress ? GatewayFrame::ZLIB_STREAM : 0) |
+                        (client.config->gateway_encoding == GatewayEncoding::ETF ? GatewayFrame::ETF : 0);
+                    client.config->gateway_recorder->Record(id, flags, msg->str);
+                }
+
+                OnWebSocketFrame(msg->str, client.config->zlib_compress);
                 break;
-            } default:
+            default:
                 client.logger->Warn(LogTextColor::YELLOW + "[SHARD " + std::to_string(id) + "] Unknown message sent");
                 break;
         }
     }
 
-    void Shard::OnWebSocketPacket(rapidjson::Document& result) {
-        client.logger->Debug("[SHARD " + std::to_string(id) + "] Received payload: " + DumpJson(result));
+    void Shard::OnWebSocketFrame(const std::string& frame, bool compressed) {
+        if (compressed) {
+            try {
+                // Wait until the rest of the payload has been received.
+                if (!zlib_stream.Feed(frame, inflate_buffer)) return;
+            } catch (const exceptions::DecompressionException& e) {
+                client.logger->Error(LogTextColor::RED + "[SHARD " + std::to_string(id) + "] " + e.what() + "! Attempting reconnect...");
+                if (!replaying) client.DoFunctionLater(&Shard::ReconnectToWebsocket, this);
+                return;
+            }
+        }
+
+        const std::string& payload = compressed ? inflate_buffer : frame;
+
+        // Drop ignored events before decoding them, only the sequence number has to be kept.
+        PayloadHeader header;
+        if (ignored_events.any() && codec->PeekHeader(payload, header) && header.op == Opcode::DISPATCH &&
+            IsIgnoredEvent(ParseGatewayEvent(header.event_name))) {
+
+            if (header.sequence != -1) last_sequence_number = header.sequence;
+            packet_counter++;
+            return;
+        }
+
+        std::unique_ptr<rapidjson::Document> result;
+        try {
+            result = codec->Decode(payload);
+        } catch (const exceptions::PayloadDecodeException& e) {
+            client.logger->Debug(LogTextColor::YELLOW + "[SHARD " + std::to_string(id) + "] " + e.what() + ", it was ignored.");
+            return;
+        }
+
+        if (!result->IsNull()) OnWebSocketPacket(std::move(result));
+    }
+
+    void Shard::OnWebSocketPacket(std::shared_ptr<rapidjson::Document> packet) {
+        rapidjson::Document& result = *packet;
+
+        if (client.logger->IsDebugEnabled()) {
+            client.logger->Debug("[SHARD " + std::to_string(id) + "] Received payload: " + DumpJson(result));
+        }
+
+        // Without a connection there is nothing to answer the other opcodes with.
+        if (replaying && result["op"].GetInt() != Opcode::DISPATCH) {
+            packet_counter++;
+            return;
+        }
 
         switch (result["op"].GetInt()) {
             case (Opcode::HELLO): {
@@ -196,18 +398,7 @@ namespace discpp {
                     std::this_thread::sleep_for(std::chrono::milliseconds(1200));
                     client.logger->Info(LogTextColor::GREEN + "[SHARD " + std::to_string(id) + "] Reconnected!");
 
-                    // Send the resume payload
-                    rapidjson::Document resume(rapidjson::kObjectType);
-                    resume.AddMember("op", 6, resume.GetAllocator());
-
-                    rapidjson::Value resume_d(rapidjson::kObjectType);
-                    resume_d.AddMember("token", client.token, resume.GetAllocator());
-                    resume_d.AddMember("session_id", session_id, resume.GetAllocator());
-                    resume_d.AddMember("seq", last_sequence_number, resume.GetAllocator());
-
-                    resume.AddMember("d", resume_d, resume.GetAllocator());
-
-                    CreateWebsocketRequest(resume);
+                    Resume();
 
                     heartbeat_acked = true;
                     reconnecting = false;
@@ -217,7 +408,19 @@ namespace discpp {
                     hello_packet.SetObject();
                     hello_packet.CopyFrom(result, hello_packet.GetAllocator());
 
-                    CreateWebsocketRequest(*GetIdentifyPacket());
+                    // Discord expects heartbeats from HELLO on, including while the shard waits for its turn to identify.
+                    if (!heartbeat_thread.joinable()) {
+                        heartbeat_thread = std::thread([this] {
+                            HandleHeartbeat();
+                        });
+                    }
+
+                    // A session that was saved before the process restarted.
+                    if (!GetSessionId().empty()) {
+                        Resume();
+                    } else {
+                        Identify();
+                    }
                 }
                 break;
             }
@@ -230,36 +433,95 @@ namespace discpp {
             case Opcode::INVALID_SESSION:
                 // Check if the session is resumable
                 if (result["d"].GetBool()) {
-                    // Send resume payload
-                    rapidjson::Document resume(rapidjson::kObjectType);
-
-                    rapidjson::Document::AllocatorType& allocator = resume.GetAllocator();
-                    resume.AddMember("op", 6, allocator);
-
-                    rapidjson::Value d(rapidjson::kObjectType);
-                    d.AddMember("token", client.token, allocator);
-                    d.AddMember("session_id", session_id, allocator);
-                    d.AddMember("seq", last_sequence_number, resume.GetAllocator());
-
-                    resume.AddMember("d", d, allocator);
-
-                    CreateWebsocketRequest(resume);
+                    Resume();
                 } else {
+                    SetSessionId("");
                     client.logger->Debug("[SHARD " + std::to_string(id) + "] Waiting 2 seconds before sending an identify packet for invalid session.");
                     std::this_thread::sleep_for(std::chrono::milliseconds(200));
 
-                    CreateWebsocketRequest(*GetIdentifyPacket());
+                    Identify();
                 }
 
                 break;
             default:
-                EventDispatcher::HandleDiscordEvent(*this, result, result["t"].GetString());
+                EventDispatcher::HandleDiscordEvent(*this, std::move(packet));
                 break;
         }
 
         packet_counter++;
     }
 
+    void Shard::Identify() {
+        client.logger->Debug("[SHARD " + std::to_string(id) + "] Waiting for the identify scheduler...");
+
+        // This runs on the thread that receives the shard's messages, so it can't wait for its turn here.
+        std::optional<std::chrono::steady_clock::time_point> identify_at = client.config->identify_scheduler->ReserveIdentify(id);
+        if (identify_at) {
+            auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(*identify_at - std::chrono::steady_clock::now());
+            client.DoFunctionAfter(std::max(delay, std::chrono::milliseconds(0)), &Shard::SendIdentify, this);
+        } else {
+            if (identify_thread.joinable()) identify_thread.join();
+            identify_thread = std::thread([this] {
+                client.config->identify_scheduler->AwaitIdentify(id);
+                SendIdentify();
+            });
+        }
+    }
+
+    void Shard::SendIdentify() {
+        CreateWebsocketRequest(*GetIdentifyPacket());
+    }
+
+    void Shard::Resume() {
+        std::string resumed_session = GetSessionId();
+        int sequence = last_sequence_number;
+        client.logger->Debug("[SHARD " + std::to_string(id) + "] Resuming session " + resumed_session + " at sequence " + std::to_string(sequence));
+
+        rapidjson::Document resume(rapidjson::kObjectType);
+        rapidjson::Document::AllocatorType& allocator = resume.GetAllocator();
+        resume.AddMember("op", Opcode::RESUME, allocator);
+
+        rapidjson::Value d(rapidjson::kObjectType);
+        d.AddMember("token", client.token, allocator);
+        d.AddMember("session_id", resumed_session, allocator);
+        d.AddMember("seq", sequence, allocator);
+
+        resume.AddMember("d", d, allocator);
+
+        CreateWebsocketRequest(resume);
+    }
+
+    void Shard::SaveSession() {
+        if (!client.config->session_store || replaying) return;
+
+        ShardSession session;
+        session.shard_id = id;
+        session.session_id = GetSessionId();
+        session.sequence = last_sequence_number;
+        session.gateway_url = gateway_endpoint;
+        if (session.session_id.empty()) return;
+
+        try {
+            client.config->session_store->Save(session);
+        } catch (const std::exception& e) {
+            client.logger->Warn(LogTextColor::YELLOW + "[SHARD " + std::to_string(id) + "] Failed to save session: " + e.what());
+        }
+    }
+
+    std::string Shard::GetSessionId() const {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        return session_id;
+    }
+
+    void Shard::SetSessionId(std::string session_id) {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        this->session_id = std::move(session_id);
+    }
+
+    std::chrono::milliseconds Shard::GetStartupTime() const {
+        return startup_time;
+    }
+
     void Shard::HandleHeartbeat() {
         try {
             while (client.run) {
@@ -269,8 +531,9 @@ namespace discpp {
                 rapidjson::Document data(rapidjson::kObjectType);
                 data.AddMember("op", Opcode::HEARTBEAT, data.GetAllocator());
                 data.AddMember("d", NULL, data.GetAllocator());
-                if (last_sequence_number != -1) {
-                    data["d"] = last_sequence_number;
+                int sequence = last_sequence_number;
+                if (sequence != -1) {
+                    data["d"] = sequence;
                 }
 
                 std::string json_payload = DumpJson(data);
@@ -278,6 +541,8 @@ namespace discpp {
 
                 heartbeat_acked = false;
 
+                SaveSession();
+
                 int heartbeat_interval = hello_packet["d"]["heartbeat_interval"].GetInt();
                 client.logger->Debug("[SHARD " + std::to_string(id) + "] Waiting for next heartbeat (" + std::to_string(heartbeat_interval / 1000.0 - 10) + " seconds)...");
 
@@ -316,14 +581,20 @@ namespace discpp {
         properties.AddMember("$device", "DISCPP", allocator);
 
         d.AddMember("properties", properties, allocator);
+        // This is payload compression, zlib-stream transport compression is requested in the gateway url instead.
         d.AddMember("compress", false, allocator);
         d.AddMember("large_threshold", 250, allocator);
 
+        // Resuming doesn't send intents, Discord keeps the ones the session was identified with.
+        if (client.config->intents) {
+            d.AddMember("intents", static_cast<uint32_t>(*client.config->intents), allocator);
+        }
+
         // We only want to add this if sharding is enabled.
-        if (client.config->shard_amount > 1) {
+        if (client.total_shards > 1) {
             rapidjson::Value shard(rapidjson::kArrayType);
             shard.PushBack(id, allocator);
-            shard.PushBack(client.config->shard_amount, allocator);
+            shard.PushBack(client.total_shards, allocator);
 
             d.AddMember("shard", shard, allocator);
         }
@@ -345,17 +616,88 @@ namespace discpp {
     void Client::StopClient() {
         stay_disconnected = true;
 
+        // Shards waiting for room in a queue have to be let go before they can disconnect.
+        event_queues->Stop();
+
         for (auto& shard : shards) {
-            shard->DisconnectWebsocket();
+            // Closing with a normal closure code invalidates the session, so use a different one if it's saved to be resumed.
+            if (config->session_store) {
+                shard->SaveSession();
+                shard->DisconnectWebsocket(4000);
+            } else {
+                shard->DisconnectWebsocket();
+            }
+            shard->send_queue.Stop();
         }
 
-        run = false;
+        if (config->session_store) {
+            config->session_store->Flush();
+        }
+
+        if (config->gateway_recorder) {
+            config->gateway_recorder->Flush();
+        }
+
+        {
+            std::lock_guard<std::mutex> run_lock(run_mutex);
+            run = false;
+        }
+        run_condition.notify_all();
 
         for (auto& shard : shards) {
             if (shard->heartbeat_thread.joinable()) shard->heartbeat_thread.join();
+            if (shard->identify_thread.joinable()) shard->identify_thread.join();
         }
     }
 
+    uint64_t Client::Replay(const std::string& path, ReplayPacing pacing) {
+        GatewayRecordingReader reader(path);
+
+        EventDispatcher::BindEvents();
+
+        std::unordered_map<int, Shard*> replay_shards;
+        for (Shard* shard : shards) {
+            replay_shards[shard->id] = shard;
+        }
+
+        uint64_t frame_count = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        GatewayFrame frame;
+        while (run && reader.Next(frame)) {
+            auto itr = replay_shards.find(frame.shard_id);
+            if (itr == replay_shards.end()) {
+                auto* shard = new Shard(*this, frame.shard_id, std::string());
+                shard->replaying = true;
+                shard->codec = GatewayCodec::Create(frame.flags & GatewayFrame::ETF ? GatewayEncoding::ETF : GatewayEncoding::JSON);
+                shards.emplace_back(shard);
+
+                itr = replay_shards.emplace(frame.shard_id, shard).first;
+
+                // Guilds have to be routed to the same shards they were recorded on.
+                total_shards = std::max(config->total_shards > 0 ? config->total_shards : config->shard_amount, frame.shard_id + 1);
+            }
+
+            if (pacing == ReplayPacing::ORIGINAL) {
+                std::this_thread::sleep_until(start + frame.timestamp);
+            }
+
+            Shard* shard = itr->second;
+            if (frame.flags & GatewayFrame::CONNECTED) {
+                shard->zlib_stream.Reset();
+            } else {
+                shard->OnWebSocketFrame(frame.data, frame.flags & GatewayFrame::ZLIB_STREAM);
+            }
+
+            frame_count++;
+        }
+
+        // Listeners run asynchronously, wait for them so the caller can look at what they did.
+        executor->WaitIdle();
+
+        return frame_count;
+    }
+
     std::unordered_map<discpp::Snowflake, discpp::Channel> Client::GetUserDMs() {
 
         if (!discpp::globals::client_instance->client_user.IsBot()) {
@@ -365,10 +707,7 @@ namespace discpp {
 
             std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("users/@me/channels"), DefaultHeaders(), 0, RateLimitBucketType::GLOBAL);
             for (auto const& channel : result->GetArray()) {
-                rapidjson::Document channel_json(rapidjson::kObjectType);
-                channel_json.CopyFrom(channel, channel_json.GetAllocator());
-
-                discpp::Channel tmp(channel_json);
+                discpp::Channel tmp(channel);
                 dm_channels.emplace(tmp.id, tmp);
             }
 
@@ -381,15 +720,13 @@ namespace discpp {
 
         std::vector<Connection> connections;
         for (auto const& connection : result->GetArray()) {
-            rapidjson::Document connection_json;
-            connection_json.CopyFrom(connection, connection_json.GetAllocator());
-            connections.emplace_back(connection_json);
+            connections.emplace_back(connection);
         }
 
         return connections;
     }
 
-    ClientUser::ClientUser(rapidjson::Document& json) : User(json) {
+    ClientUser::ClientUser(const rapidjson::Value& json) : User(json) {
         mfa_enabled = GetDataSafely<bool>(json, "mfa_enabled");
         locale = GetDataSafely<std::string>(json, "locale");
         verified = GetDataSafely<bool>(json, "verified");
@@ -485,10 +822,7 @@ namespace discpp {
 
             std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("users/@me/relationships/"), DefaultHeaders(), 0, RateLimitBucketType::GLOBAL);
             for (auto const& relationship : result->GetArray()) {
-                rapidjson::Document relationship_json(rapidjson::kObjectType);
-                relationship_json.CopyFrom(relationship, relationship_json.GetAllocator());
-
-                discpp::UserRelationship tmp(relationship_json);
+                discpp::UserRelationship tmp(relationship);
                 relationships.emplace(tmp.id, tmp);
             }
             return relationships;
@@ -515,7 +849,55 @@ namespace discpp {
         payload.AddMember("op", Shard::Opcode::STATUS_UPDATE, payload.GetAllocator());
         payload.AddMember("d", *activity_json, payload.GetAllocator());
 
-        shards.front()->CreateWebsocketRequest(payload);
+        // Presences are per shard, so every shard this process runs has to send it.
+        for (auto& shard : shards) {
+            shard->CreateWebsocketRequest(payload);
+        }
+    }
+
+    Shard* Client::GetShardForGuild(const discpp::Snowflake& guild_id) {
+        int shard_id = static_cast<int>((static_cast<uint64_t>(guild_id) >> 22) % total_shards);
+
+        for (auto& shard : shards) {
+            if (shard->id == shard_id) {
+                return shard;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Client::Schedule(ThreadPool::Task task) {
+        // Only the dispatcher's handling of an event runs on its strand. Listeners and other tasks go to the pool,
+        // a listener waiting for a later event of the same guild would otherwise wait forever.
+        executor->Submit(std::move(task));
+    }
+
+    void Client::ScheduleCacheExpiry() {
+        DoFunctionAfter(std::chrono::seconds(1), [this] {
+            if (!run) return;
+
+            cache.ExpireEntries();
+            ScheduleCacheExpiry();
+        });
+    }
+
+    void Client::ScheduleAfter(std::chrono::milliseconds delay, ThreadPool::Task task) {
+        timers->Add(delay, [this, task = std::move(task)]() mutable {
+            executor->Submit(std::move(task));
+        });
+    }
+
+    ThreadPoolStats Client::GetExecutorStats() const {
+        return executor->GetStats();
+    }
+
+    EventQueueStats Client::GetEventQueueStats(GatewayEvent event) const {
+        return event_queues->GetStats(event);
+    }
+
+    int Client::GetTotalShards() const {
+        return total_shards;
     }
 
     discpp::User Client::ReqestUserIfNotCached(const discpp::Snowflake& id) {
@@ -532,16 +914,14 @@ namespace discpp {
         std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/users/@me/connections"), DefaultHeaders(), 0, RateLimitBucketType::GLOBAL);
         std::vector<discpp::User::Connection> connections;
         for (auto const& connection : result->GetArray()) {
-            rapidjson::Document connection_json;
-            connection_json.CopyFrom(connection, connection_json.GetAllocator());
-            connections.emplace_back(connection_json);
+            connections.emplace_back(connection);
         }
 
         return connections;
     }
 
-    UserRelationship::UserRelationship(rapidjson::Document& json) {
-        id = discpp::Snowflake(json["id"].GetString());
+    UserRelationship::UserRelationship(const rapidjson::Value& json) {
+        id = discpp::GetSnowflake(json["id"]);
         nickname = GetDataSafely<std::string>(json, "nickname");
         type = json["type"].GetInt();
         user = ConstructDiscppObjectFromJson(json, "user", discpp::User());
@@ -0,0 +1,27 @@
+#ifdef DISCPP_COROUTINES
+
+#include "coroutine.h"
+
+namespace discpp {
+    Task<std::unique_ptr<rapidjson::Document>> SendGetRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body) {
+        co_return co_await RunOnExecutor([&] { return SendGetRequest(url, headers, object, ratelimit_bucket, body); });
+    }
+
+    Task<std::unique_ptr<rapidjson::Document>> SendPostRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body) {
+        co_return co_await RunOnExecutor([&] { return SendPostRequest(url, headers, object, ratelimit_bucket, body); });
+    }
+
+    Task<std::unique_ptr<rapidjson::Document>> SendPutRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body) {
+        co_return co_await RunOnExecutor([&] { return SendPutRequest(url, headers, object, ratelimit_bucket, body); });
+    }
+
+    Task<std::unique_ptr<rapidjson::Document>> SendPatchRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket, cpr::Body body) {
+        co_return co_await RunOnExecutor([&] { return SendPatchRequest(url, headers, object, ratelimit_bucket, body); });
+    }
+
+    Task<std::unique_ptr<rapidjson::Document>> SendDeleteRequestAsync(std::string url, cpr::Header headers, Snowflake object, RateLimitBucketType ratelimit_bucket) {
+        co_return co_await RunOnExecutor([&] { return SendDeleteRequest(url, headers, object, ratelimit_bucket); });
+    }
+}
+
+#endif
@@ -16,7 +16,7 @@ namespace discpp {
 		SetColor(color);
 	}
 
-	EmbedBuilder::EmbedBuilder(rapidjson::Document& json) {
+	EmbedBuilder::EmbedBuilder(const rapidjson::Value& json) {
         embed_json.SetObject();
 		embed_json.CopyFrom(json, embed_json.GetAllocator());
 	}
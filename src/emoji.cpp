@@ -10,19 +10,16 @@ namespace discpp {
 		}
 	}
 
-	Emoji::Emoji(rapidjson::Document& json) {
+	Emoji::Emoji(const rapidjson::Value& json) {
 		id = GetIDSafely(json, "id");
 		name = GetDataSafely<std::string>(json, "name");
 		if (ContainsNotNull(json, "roles")) {
 			for (auto& role : json["roles"].GetArray()) {
-				rapidjson::Document role_json;
-				role_json.CopyFrom(role, role_json.GetAllocator());
-				roles.emplace_back(discpp::Snowflake(role.GetString()));
+				roles.emplace_back(discpp::GetSnowflake(role));
 			}
 		}
 		if (ContainsNotNull(json, "user")) {
-			rapidjson::Document user_json;
-			user_json.CopyFrom(json["user"], user_json.GetAllocator());
+			const rapidjson::Value& user_json = json["user"];
 			creator = std::make_shared<discpp::User>(discpp::User(user_json));
 		}
 		require_colons = GetDataSafely<bool>(json, "require_colons");
@@ -2,261 +2,453 @@
 #include "event_handler.h"
 #include "events/all_discord_events.h"
 #include "client_config.h"
+#include "command_handler.h"
 
 namespace discpp {
-    void EventDispatcher::ReadyEvent(Shard& shard, rapidjson::Document& result) {
-        // Check if we're just resuming, and if we are dont try to create a new thread.
-        if (!shard.heartbeat_thread.joinable()) {
-            Shard* sh = &shard;
-            shard.heartbeat_thread = std::thread([sh] {
-                sh->HandleHeartbeat();
-            });
+    // Looks up the cached channel, and guild if there is one, of a message event. Returns false if the channel isn't cached.
+    static bool GetMessageChannel(const rapidjson::Value& result, discpp::Channel& channel, std::shared_ptr<discpp::Guild>& guild) {
+        Snowflake channel_id = discpp::GetSnowflake(result["channel_id"]);
+
+        if (ContainsNotNull(result, "guild_id")) {
+            guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
+
+            auto channel_it = guild->channels.find(channel_id);
+            if (channel_it == guild->channels.end()) return false;
+
+            channel = channel_it->second;
+            return true;
         }
 
-        shard.ready = true;
-        // @TODO: This for some reason causes an exception.
-        shard.session_id = result["session_id"].GetString();
+        std::optional<discpp::Channel> dm_channel = globals::client_instance->cache.private_channels.Get(channel_id);
+        if (!dm_channel) return false;
 
-        if (discpp::globals::client_instance->config->type == discpp::TokenType::USER) {
-            rapidjson::Document user_json;
-            user_json.CopyFrom(result["user"], user_json.GetAllocator());
+        channel = std::move(*dm_channel);
+        return true;
+    }
 
-            discpp::ClientUser client_user(user_json);
-            discpp::globals::client_instance->client_user = client_user;
+    // Caches a DM channel if its policy allows it, a cached channel the policy doesn't allow anymore is removed.
+    static void CacheDMChannel(const discpp::Channel& channel) {
+        Cache& cache = globals::client_instance->cache;
+        const CachePolicy<discpp::Channel>& policy = cache.policies.dm_channels;
 
-            for (const auto& guild : result["guilds"].GetArray()) {
-                rapidjson::Document guild_json(rapidjson::kObjectType);
-                guild_json.CopyFrom(guild, guild_json.GetAllocator());
+        bool cached = cache.private_channels.Contains(channel.id);
+        size_t count = !cached && policy.type == CachePolicyType::BOUNDED ? cache.private_channels.Size() : 0;
+        if (policy.Allows(channel, count)) {
+            cache.private_channels.InsertOrAssign(channel.id, channel);
+            cache.channel_guilds.InsertOrAssign(channel.id, 0);
+            cache.dm_channel_expiry.Touch(0, channel.id);
+        } else if (cached) {
+            cache.private_channels.Erase(channel.id);
+            cache.channel_guilds.Erase(channel.id);
+            cache.dm_channel_expiry.Forget(0, channel.id);
+        }
+    }
+
+    bool EventDispatcher::WantsCommand(const rapidjson::Value& message) {
+        Client* client = globals::client_instance;
+        if (client->config->type != TokenType::BOT) return false;
+        if (client->custom_command_handler) return true;
+        if (registered_commands.empty() || !ContainsNotNull(message, "content")) return false;
+
+        std::string_view content(message["content"].GetString(), message["content"].GetStringLength());
+        for (const std::string& prefix : client->config->prefixes) {
+            if (content.compare(0, prefix.size(), prefix) == 0) return true;
+        }
+
+        return false;
+    }
+
+    void EventDispatcher::MarkShardReady(Shard& shard) {
+        // The heartbeat thread was already started by HELLO, see Shard::OnWebSocketPacket.
+        shard.ready = true;
+
+        // Only measure the first time, later ones come from the shard reconnecting.
+        if (shard.startup_time.count() == 0) {
+            shard.startup_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - shard.start_time);
+            shard.client.logger->Info(LogTextColor::GREEN + "[SHARD " + std::to_string(shard.id) + "] Ready after " + std::to_string(shard.startup_time.count()) + "ms");
+        }
+
+        // A resumed session doesn't get READY, so bots have to request the user.
+        if (discpp::globals::client_instance->config->type == discpp::TokenType::BOT) {
+            SetClientUser(nullptr);
+        }
+    }
 
-                GuildCreateEvent(shard, guild_json);
+    void EventDispatcher::SetClientUser(const rapidjson::Value* user) {
+        // Every shard gets the same user, so only the first one to be ready sets it instead of shards overwriting
+        // it while others read it.
+        Client* client = globals::client_instance;
+        std::call_once(client->client_user_set, [client, user] {
+            if (user) {
+                client->client_user = discpp::ClientUser(*user);
+            } else {
+                std::unique_ptr<rapidjson::Document> user_json = SendGetRequest(Endpoint("/users/@me"), DefaultHeaders(), {}, {});
+                client->client_user = discpp::ClientUser(*user_json);
             }
+        });
+    }
 
-            for (const auto& private_channel : result["private_channels"].GetArray()) {
-                rapidjson::Document private_channel_json(rapidjson::kObjectType);
-                private_channel_json.CopyFrom(private_channel, private_channel_json.GetAllocator());
+    void EventDispatcher::ReadyEvent(Shard& shard, const rapidjson::Value& result) {
+        // @TODO: This for some reason causes an exception.
+        shard.SetSessionId(result["session_id"].GetString());
+        shard.SaveSession();
+
+        // READY has the current user, so bots don't have to request it.
+        if (ContainsNotNull(result, "user")) {
+            SetClientUser(&result["user"]);
+        }
 
-                discpp::Channel dm_channel(private_channel_json);
+        MarkShardReady(shard);
 
-                discpp::globals::client_instance->cache.private_channels.insert({ dm_channel.id, dm_channel });
+        if (discpp::globals::client_instance->config->type == discpp::TokenType::USER) {
+            for (const auto& guild : result["guilds"].GetArray()) {
+                GuildCreateEvent(shard, guild);
             }
-        } else {
-            if (globals::client_instance->client_user.id == 0) {
-                // Get the bot user
-                std::unique_ptr<rapidjson::Document> user_json = SendGetRequest(Endpoint("/users/@me"), DefaultHeaders(), {}, {});
 
-                discpp::globals::client_instance->client_user = discpp::ClientUser(*user_json);
+            for (const auto& private_channel : result["private_channels"].GetArray()) {
+                CacheDMChannel(discpp::Channel(private_channel));
             }
         }
 
         discpp::DispatchEvent(discpp::ReadyEvent(result));
     }
 
-    void EventDispatcher::ResumedEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::DispatchEvent(discpp::ResumedEvent());
+    void EventDispatcher::ResumedEvent(Shard& shard, const rapidjson::Value& result) {
+        // Shards that resumed a saved session never receive READY.
+        MarkShardReady(shard);
+
+        if (HasListeners<discpp::ResumedEvent>()) discpp::DispatchEvent(discpp::ResumedEvent());
     }
 
-    void EventDispatcher::ReconnectEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::ReconnectEvent(Shard& shard, const rapidjson::Value& result) {
         discpp::DispatchEvent(discpp::ReconnectEvent());
     }
 
-    void EventDispatcher::InvalidSessionEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::InvalidSessionEvent(Shard& shard, const rapidjson::Value& result) {
         discpp::DispatchEvent(discpp::InvalidSessionEvent());
     }
 
-    void EventDispatcher::ChannelCreateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::ChannelCreateEvent(Shard& shard, const rapidjson::Value& result) {
         if (ContainsNotNull(result, "guild_id")) {
             discpp::Channel new_channel(result);
-            std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
+            Snowflake guild_id = discpp::GetSnowflake(result["guild_id"]);
+            bool cached = globals::client_instance->cache.UpdateGuild(guild_id, [&](discpp::Guild& guild) {
+                guild.channels.insert({ new_channel.id, new_channel });
+            }) != nullptr;
+            if (cached) globals::client_instance->cache.channel_guilds.InsertOrAssign(new_channel.id, guild_id);
 
-            guild->channels.insert({ new_channel.id, new_channel });
             discpp::DispatchEvent(discpp::ChannelCreateEvent(new_channel));
         } else {
             discpp::Channel new_channel(result);
 
-            globals::client_instance->cache.private_channels.insert({ new_channel.id, new_channel });
+            CacheDMChannel(new_channel);
             discpp::DispatchEvent(discpp::ChannelCreateEvent(new_channel));
         }
     }
 
-    void EventDispatcher::ChannelUpdateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::ChannelUpdateEvent(Shard& shard, const rapidjson::Value& result) {
         if (ContainsNotNull(result, "guild_id")) {
             discpp::Channel updated_channel(result);
-            std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
-
-            auto guild_chan_it = guild->channels.find(updated_channel.id);
-            if (guild_chan_it != guild->channels.end()) {
-                guild_chan_it->second = updated_channel;
-            }
+            Snowflake guild_id = discpp::GetSnowflake(result["guild_id"]);
+            bool cached = false;
+            globals::client_instance->cache.UpdateGuild(guild_id, [&](discpp::Guild& guild) {
+                auto guild_chan_it = guild.channels.find(updated_channel.id);
+                if (guild_chan_it != guild.channels.end()) {
+                    guild_chan_it->second = updated_channel;
+                    cached = true;
+                }
+            });
+            if (cached) globals::client_instance->cache.channel_guilds.InsertOrAssign(updated_channel.id, guild_id);
 
             discpp::DispatchEvent(discpp::ChannelUpdateEvent(updated_channel));
         } else {
             discpp::Channel updated_channel(result);
 
-            auto client_chan_it = discpp::globals::client_instance->cache.private_channels.find(updated_channel.id);
-            client_chan_it->second = updated_channel;
+            CacheDMChannel(updated_channel);
 
             discpp::DispatchEvent(discpp::ChannelUpdateEvent(updated_channel));
         }
     }
 
-    void EventDispatcher::ChannelDeleteEvent(Shard& shard, rapidjson::Document& result) {
-        if (ContainsNotNull(result, "guild_id")) {
-            discpp::Channel updated_channel(result);
-            std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
+    void EventDispatcher::ChannelDeleteEvent(Shard& shard, const rapidjson::Value& result) {
+        Cache& cache = globals::client_instance->cache;
+        discpp::Channel deleted_channel(result);
 
-            discpp::DispatchEvent(discpp::ChannelUpdateEvent(updated_channel));
+        if (ContainsNotNull(result, "guild_id")) {
+            cache.UpdateGuild(discpp::GetSnowflake(result["guild_id"]), [&](discpp::Guild& guild) {
+                guild.channels.erase(deleted_channel.id);
+            });
         } else {
-            discpp::Channel updated_channel(result);
-
-            discpp::DispatchEvent(discpp::ChannelUpdateEvent(updated_channel));
+            cache.private_channels.Erase(deleted_channel.id);
+            cache.dm_channel_expiry.Forget(0, deleted_channel.id);
         }
+        cache.channel_guilds.Erase(deleted_channel.id);
+
+        if (HasListeners<discpp::ChannelDeleteEvent>()) discpp::DispatchEvent(discpp::ChannelDeleteEvent(deleted_channel));
     }
 
-    void EventDispatcher::ChannelPinsUpdateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::ChannelPinsUpdateEvent(Shard& shard, const rapidjson::Value& result) {
         if (ContainsNotNull(result, "guild_id")) {
-            discpp::Channel pin_update_channel = discpp::Channel(discpp::Snowflake(result["channel_id"].GetString()));
-            discpp::Guild guild(pin_update_channel.guild_id);
-
-            auto it = guild.channels.find(pin_update_channel.id);
-            if (it != guild.channels.end()) {
-                it->second.last_pin_timestamp = TimeFromDiscord(result["last_pin_timestamp"].GetString());
-            }
+            discpp::Channel pin_update_channel = discpp::Channel(discpp::GetSnowflake(result["channel_id"]));
+            globals::client_instance->cache.UpdateGuild(discpp::GetSnowflake(result["guild_id"]), [&](discpp::Guild& guild) {
+                auto it = guild.channels.find(pin_update_channel.id);
+                if (it != guild.channels.end()) {
+                    it->second.last_pin_timestamp = TimeFromDiscord(result["last_pin_timestamp"].GetString());
+                }
+            });
 
             discpp::DispatchEvent(discpp::ChannelPinsUpdateEvent(pin_update_channel));
         } else {
-            discpp::Channel pin_update_channel = discpp::Channel(discpp::Snowflake(result["channel_id"].GetString()));
+            discpp::Channel pin_update_channel = discpp::Channel(discpp::GetSnowflake(result["channel_id"]));
 
-            auto it = globals::client_instance->cache.private_channels.find(pin_update_channel.id);
-            if (it != globals::client_instance->cache.private_channels.end()) {
-                it->second.last_pin_timestamp = TimeFromDiscord(result["last_pin_timestamp"].GetString());
-            }
+            globals::client_instance->cache.private_channels.Update(pin_update_channel.id, [&](discpp::Channel& channel) {
+                channel.last_pin_timestamp = TimeFromDiscord(result["last_pin_timestamp"].GetString());
+            });
 
             discpp::DispatchEvent(discpp::ChannelPinsUpdateEvent(pin_update_channel));
         }
     }
 
-    void EventDispatcher::GuildCreateEvent(Shard& shard, rapidjson::Document& result) {
-        Snowflake guild_id = discpp::Snowflake(result["id"].GetString());
+    void EventDispatcher::GuildCreateEvent(Shard& shard, const rapidjson::Value& result) {
+        Snowflake guild_id = discpp::GetSnowflake(result["id"]);
 
+        Cache& cache = globals::client_instance->cache;
         std::shared_ptr<discpp::Guild> guild = std::make_shared<discpp::Guild>(result);
-        globals::client_instance->cache.guilds.emplace(guild_id, guild);
-        globals::client_instance->cache.members.insert(guild->members.begin(), guild->members.end());
+        std::optional<std::shared_ptr<discpp::Guild>> replaced = cache.guilds.Get(guild_id);
+        cache.guilds.InsertOrAssign(guild_id, guild);
+        guild->members->ForEach([&](const Snowflake& user_id, const std::shared_ptr<discpp::Member>& member) {
+            cache.members.InsertOrAssign(user_id, member);
+        });
+
+        // A guild is created again after an outage, channels that were deleted meanwhile aren't in the payload.
+        if (replaced) {
+            for (const auto& channel : (*replaced)->channels) {
+                if (!guild->channels.contains(channel.first)) cache.channel_guilds.Erase(channel.first);
+            }
+        }
+        for (const auto& channel : guild->channels) {
+            cache.channel_guilds.InsertOrAssign(channel.first, guild_id);
+        }
+        cache.TouchGuild(*guild);
 
         discpp::DispatchEvent(discpp::GuildCreateEvent(guild));
     }
 
-    void EventDispatcher::GuildUpdateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::GuildUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        Cache& cache = globals::client_instance->cache;
         std::shared_ptr<discpp::Guild> guild = std::make_shared<discpp::Guild>(result);
 
-        auto it = globals::client_instance->cache.guilds.find(guild->id);
-        if (it != globals::client_instance->cache.guilds.end()) {
-            it->second = guild;
+        // The payload has no channels or members, so the new guild keeps the ones of the cached guild.
+        bool cached_guild = cache.guilds.Update(guild->id, [&](std::shared_ptr<discpp::Guild>& cached) {
+            guild->KeepCachedObjects(*cached);
+
+            if (ContainsNotNull(result, "public_updates_channel_id")) {
+                auto channel = guild->channels.find(discpp::GetSnowflake(result["public_updates_channel_id"]));
+                if (channel != guild->channels.end()) guild->public_updates_channel = channel->second;
+            }
+
+            cached = guild;
+        });
+
+        // The emojis come from the payload, they were counted against their policy when the guild was parsed.
+        if (cached_guild && cache.policies.emojis.Expires()) {
+            for (const auto& emoji : guild->emojis) {
+                cache.emoji_expiry.Touch(guild->id, emoji.first);
+            }
         }
 
         discpp::DispatchEvent(discpp::GuildUpdateEvent(guild));
     }
 
-    void EventDispatcher::GuildDeleteEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Guild> guild = std::make_shared<discpp::Guild>(discpp::Snowflake(result["id"].GetString()));
+    void EventDispatcher::GuildDeleteEvent(Shard& shard, const rapidjson::Value& result) {
+        Cache& cache = globals::client_instance->cache;
+        Snowflake guild_id = discpp::GetSnowflake(result["id"]);
+
+        std::optional<std::shared_ptr<discpp::Guild>> cached = cache.guilds.Erase(guild_id);
+        std::shared_ptr<discpp::Guild> guild;
+        if (cached) {
+            guild = *cached;
+
+            // A channel's guild never changes, so only the guild's own channels can point at it.
+            for (const auto& channel : guild->channels) {
+                cache.channel_guilds.Erase(channel.first);
+            }
+        } else {
+            guild = std::make_shared<discpp::Guild>();
+            guild->id = guild_id;
+        }
 
-        globals::client_instance->cache.guilds.erase(guild->id);
         discpp::DispatchEvent(discpp::GuildDeleteEvent(guild));
     }
 
-    void EventDispatcher::GuildBanAddEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::Guild guild(discpp::Snowflake(result["guild_id"].GetString()));
-        rapidjson::Document user_json;
-        user_json.CopyFrom(result["user"], user_json.GetAllocator());
+    void EventDispatcher::GuildBanAddEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::GuildBanAddEvent>()) return;
+
+        discpp::Guild guild(discpp::GetSnowflake(result["guild_id"]));
+        const rapidjson::Value& user_json = result["user"];
         discpp::User user(user_json);
 
         discpp::DispatchEvent(discpp::GuildBanAddEvent(guild, user));
     }
 
-    void EventDispatcher::GuildBanRemoveEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::Guild guild(discpp::Snowflake(result["guild_id"].GetString()));
-        rapidjson::Document user_json;
-        user_json.CopyFrom(result["user"], user_json.GetAllocator());
+    void EventDispatcher::GuildBanRemoveEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::GuildBanRemoveEvent>()) return;
+
+        discpp::Guild guild(discpp::GetSnowflake(result["guild_id"]));
+        const rapidjson::Value& user_json = result["user"];
         discpp::User user(user_json);
 
         discpp::DispatchEvent(discpp::GuildBanRemoveEvent(guild, user));
     }
 
-    void EventDispatcher::GuildEmojisUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
+    void EventDispatcher::GuildEmojisUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        Cache& cache = globals::client_instance->cache;
+        Snowflake guild_id = discpp::GetSnowflake(result["guild_id"]);
 
-        std::unordered_map<Snowflake, Emoji> emojis;
+        SnowflakeMap<Emoji> emojis;
         for (auto& emoji : result["emojis"].GetArray()) {
-            rapidjson::Document emoji_json;
-            emoji_json.CopyFrom(emoji, emoji_json.GetAllocator());
-
-            discpp::Emoji tmp = discpp::Emoji(emoji_json);
-            emojis.insert({ tmp.id, tmp });
+            discpp::Emoji tmp = discpp::Emoji(emoji);
+            if (cache.policies.emojis.Allows(tmp, emojis.size())) emojis.insert({ tmp.id, tmp });
         }
 
-        guild->emojis = emojis;
-        auto it = globals::client_instance->cache.guilds.find(guild->id);
-        if (it != globals::client_instance->cache.guilds.end()) {
-            it->second = guild;
+        std::shared_ptr<discpp::Guild> guild = cache.UpdateGuild(guild_id, [&](discpp::Guild& guild) {
+            guild.emojis = std::move(emojis);
+        });
+        if (!guild) return;
+
+        if (cache.policies.emojis.Expires()) {
+            for (const auto& emoji : guild->emojis) {
+                cache.emoji_expiry.Touch(guild_id, emoji.first);
+            }
         }
 
         discpp::DispatchEvent(discpp::GuildEmojisUpdateEvent(guild));
     }
 
-    void EventDispatcher::GuildIntegrationsUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::DispatchEvent(discpp::GuildIntegrationsUpdateEvent(discpp::Guild(discpp::Snowflake(result["guild_id"].GetString()))));
+    void EventDispatcher::GuildIntegrationsUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::GuildIntegrationsUpdateEvent>()) return;
+
+        discpp::DispatchEvent(discpp::GuildIntegrationsUpdateEvent(discpp::Guild(discpp::GetSnowflake(result["guild_id"]))));
     }
 
-    void EventDispatcher::GuildMemberAddEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
+    void EventDispatcher::GuildMemberAddEvent(Shard& shard, const rapidjson::Value& result) {
+        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
         std::shared_ptr<discpp::Member> member = std::make_shared<discpp::Member>(result, *guild);
-        globals::client_instance->cache.members.insert({ member->user.id, member });
+
+        // The bound counts the guild's members, so the member goes into the guild along with the members map.
+        Cache& cache = globals::client_instance->cache;
+        if (member->user.id == globals::client_instance->client_user.id || cache.policies.members.Allows(*member, guild->members->Size())) {
+            guild->members->InsertOrAssign(member->user.id, member);
+            cache.members.InsertOrAssign(member->user.id, member);
+            cache.member_expiry.Touch(guild->id, member->user.id);
+        }
 
         discpp::DispatchEvent(discpp::GuildMemberAddEvent(guild, member));
     }
 
-    void EventDispatcher::GuildMemberRemoveEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
-        std::shared_ptr<discpp::Member> member = std::make_shared<discpp::Member>(discpp::Snowflake(result["user"]["id"].GetString()), *guild);
-        globals::client_instance->cache.members.erase(member->user.id);
+    void EventDispatcher::GuildMemberRemoveEvent(Shard& shard, const rapidjson::Value& result) {
+        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
+        Snowflake user_id = discpp::GetSnowflake(result["user"]["id"]);
+
+        // Members that weren't cached, which every member is when members aren't cached, are made from the payload.
+        Cache& cache = globals::client_instance->cache;
+        std::shared_ptr<discpp::Member> member;
+        std::optional<std::shared_ptr<discpp::Member>> cached = guild->members->Erase(user_id);
+
+        // The members map holds the member of the guild a user was last seen in, which may be another one.
+        std::optional<std::shared_ptr<discpp::Member>> last_seen = cache.members.Get(user_id);
+        if (last_seen && (*last_seen)->guild_id == guild->id) {
+            if (!cached) cached = last_seen;
+            cache.members.Erase(user_id);
+        }
+
+        if (cached) {
+            member = *cached;
+        } else {
+            member = std::make_shared<discpp::Member>();
+            member->user = discpp::User(result["user"]);
+            member->guild_id = guild->id;
+        }
+        cache.member_expiry.Forget(guild->id, user_id);
+        cache.presence_expiry.Forget(guild->id, user_id);
 
         discpp::DispatchEvent(discpp::GuildMemberRemoveEvent(guild, member));
     }
 
-    void EventDispatcher::GuildMemberUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Guild> guild = std::make_shared<discpp::Guild>(discpp::Snowflake(result["guild_id"].GetString()));
-        auto it = guild->members.find(static_cast<Snowflake>(discpp::Snowflake(result["user"]["id"].GetString())));
+    void EventDispatcher::GuildMemberUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        Snowflake user_id = discpp::GetSnowflake(result["user"]["id"]);
 
-        std::shared_ptr<discpp::Member> member;
-        if (it != guild->members.end()) {
-            member = it->second;
-        } else {
-            member = std::make_shared<discpp::Member>(discpp::Snowflake(result["user"]["id"].GetString()), *guild);
-            guild->members.insert({ member->user.id, member });
+        Snowflake guild_id = discpp::GetSnowflake(result["guild_id"]);
+        Cache& cache = globals::client_instance->cache;
+        bool is_bot = user_id == globals::client_instance->client_user.id;
+
+        // Replacing the guild copies it, which isn't worth it when the member won't be cached.
+        if (!is_bot && cache.policies.members.type == CachePolicyType::OFF) {
+            std::optional<std::shared_ptr<discpp::Guild>> guild = cache.guilds.Get(guild_id);
+            if (!guild) return;
+
+            if (HasListeners<discpp::GuildMemberUpdateEvent>()) {
+                discpp::DispatchEvent(discpp::GuildMemberUpdateEvent(*guild, std::make_shared<discpp::Member>(result, **guild)));
+            }
+            return;
         }
 
-        member->roles.clear();
-        for (auto& role : result["roles"].GetArray()) {
-            rapidjson::Document role_json;
-            role_json.CopyFrom(role, role_json.GetAllocator());
+        std::optional<std::shared_ptr<discpp::Guild>> cached_guild = cache.guilds.Get(guild_id);
+        if (!cached_guild) return;
+        std::shared_ptr<discpp::Guild> guild = *cached_guild;
+
+        auto update_member = [&](discpp::Member& member) {
+            member.roles.clear();
+            for (auto& role : result["roles"].GetArray()) {
+                member.roles.emplace_back(discpp::GetSnowflake(role));
+            }
+            if (discpp::ContainsNotNull(result, "nick")) {
+                member.nick = result["nick"].GetString();
+            }
+        };
 
-            member->roles.emplace_back(discpp::Snowflake(role_json.GetString()));
+        // The cached member is shared, so a changed copy replaces it. A member that is cached can stay if its
+        // policy allows it, one that isn't cached yet counts against the bound.
+        std::shared_ptr<discpp::Member> member;
+        bool keep = false;
+        bool cached = guild->members->Update(user_id, [&](std::shared_ptr<discpp::Member>& cached_member) {
+            member = std::make_shared<discpp::Member>(*cached_member);
+            update_member(*member);
+
+            keep = is_bot || cache.policies.members.Allows(*member, 0);
+            if (keep) cached_member = member;
+        });
+
+        if (!cached) {
+            member = std::make_shared<discpp::Member>(result, *guild);
+            update_member(*member);
+
+            keep = is_bot || cache.policies.members.Allows(*member, guild->members->Size());
+            if (keep) guild->members->InsertOrAssign(user_id, member);
+        } else if (!keep) {
+            guild->members->Erase(user_id);
         }
-        rapidjson::Value::ConstMemberIterator itr = result.FindMember("nick");
-        if (discpp::ContainsNotNull(result, "nick")) {
-            member->nick = result["nick"].GetString();
+
+        if (keep) {
+            cache.members.InsertOrAssign(user_id, member);
+            cache.member_expiry.Touch(guild_id, user_id);
+        } else {
+            std::optional<std::shared_ptr<discpp::Member>> cached = cache.members.Get(user_id);
+            if (cached && (*cached)->guild_id == guild_id) cache.members.Erase(user_id);
+            cache.member_expiry.Forget(guild_id, user_id);
         }
 
         discpp::DispatchEvent(discpp::GuildMemberUpdateEvent(guild, member));
     }
 
-    void EventDispatcher::GuildMembersChunkEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
+    void EventDispatcher::GuildMembersChunkEvent(Shard& shard, const rapidjson::Value& result) {
+        // The chunk's members only go to the listeners.
+        if (!HasListeners<discpp::GuildMembersChunkEvent>()) return;
+
+        std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
         std::unordered_map<discpp::Snowflake, discpp::Member> members;
         for (auto const& member : result["members"].GetArray()) {
-            rapidjson::Document member_json(rapidjson::kObjectType);
-            member_json.CopyFrom(member, member_json.GetAllocator());
-
-            discpp::Member tmp(member_json, *guild);
+            discpp::Member tmp(member, *guild);
             members.emplace(tmp.user.id, tmp);
         }
 
@@ -266,10 +458,7 @@ namespace discpp {
         std::vector<discpp::Presence> presences;
         if (ContainsNotNull(result, "presences")) {
             for (auto const &presence : result["presences"].GetArray()) {
-                rapidjson::Document presence_json(rapidjson::kObjectType);
-                presence_json.CopyFrom(presence, presence_json.GetAllocator());
-
-                discpp::Presence tmp(presence_json);
+                discpp::Presence tmp(presence);
                 presences.push_back(tmp);
             }
         }
@@ -278,279 +467,324 @@ namespace discpp {
         discpp::DispatchEvent(discpp::GuildMembersChunkEvent(guild, members, chunk_index, chunk_count, presences, nonce));
     }
 
-    void EventDispatcher::GuildRoleCreateEvent(Shard& shard, rapidjson::Document& result) {
-        std::unique_ptr<rapidjson::Document> role_json = GetDocumentInsideJson(result, "role");
-        discpp::Role role(*role_json);
+    void EventDispatcher::GuildRoleCreateEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::GuildRoleCreateEvent>()) return;
+
+        discpp::Role role(result["role"]);
 
         discpp::DispatchEvent(discpp::GuildRoleCreateEvent(role));
     }
 
-    void EventDispatcher::GuildRoleUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        std::unique_ptr<rapidjson::Document> role_json = GetDocumentInsideJson(result, "role");
-        discpp::Role role(*role_json);
+    void EventDispatcher::GuildRoleUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::GuildRoleUpdateEvent>()) return;
+
+        discpp::Role role(result["role"]);
 
         discpp::DispatchEvent(discpp::GuildRoleUpdateEvent(role));
     }
 
-    void EventDispatcher::GuildRoleDeleteEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::Guild guild(discpp::Snowflake((result["guild_id"].GetString())));
-        discpp::Role role(discpp::Snowflake(result["role_id"].GetString()), guild);
+    void EventDispatcher::GuildRoleDeleteEvent(Shard& shard, const rapidjson::Value& result) {
+        discpp::Guild guild(discpp::GetSnowflake(result["guild_id"]));
+        discpp::Role role(discpp::GetSnowflake(result["role_id"]), guild);
 
         guild.roles.erase(role.id);
 
         discpp::DispatchEvent(discpp::GuildRoleDeleteEvent(role));
     }
 
-    void EventDispatcher::MessageCreateEvent(Shard& shard, rapidjson::Document& result) {
-        std::shared_ptr<discpp::Message> message = std::make_shared<discpp::Message>(result);
-        if (!globals::client_instance->cache.messages.empty()) {
-            if (globals::client_instance->cache.messages.size() >= discpp::globals::client_instance->message_cache_count) {
-                globals::client_instance->cache.messages.erase(globals::client_instance->cache.messages.begin());
-            }
+    void EventDispatcher::MessageCreateEvent(Shard& shard, const rapidjson::Value& result) {
+        bool cache_message = globals::client_instance->message_cache_count > 0;
+        bool fire_command = WantsCommand(result);
+        bool has_listeners = HasListeners<discpp::MessageCreateEvent>();
+
+        // Building a message can look up the channel, guild and author, so don't if nothing would use it.
+        if (!cache_message && !fire_command && !has_listeners) return;
 
-            globals::client_instance->cache.messages.insert({message->id, message});
+        std::shared_ptr<discpp::Message> message = std::make_shared<discpp::Message>(result);
+        Cache& cache = globals::client_instance->cache;
+        if (cache_message && cache.policies.messages.Allows(*message)) {
+            cache.messages.Insert(message);
+            cache.message_expiry.Touch(message->channel.id, message->id);
         }
 
-        if (discpp::globals::client_instance->config->type == discpp::TokenType::BOT) {
+        if (fire_command) {
             discpp::globals::client_instance->DoFunctionLater(discpp::globals::client_instance->fire_command_method, discpp::globals::client_instance, *message);
         }
 
-        discpp::DispatchEvent(discpp::MessageCreateEvent(*message));
+        if (has_listeners) discpp::DispatchEvent(discpp::MessageCreateEvent(*message));
     }
 
-    void EventDispatcher::MessageUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        auto message_it = globals::client_instance->cache.messages.find(discpp::Snowflake(result["id"].GetString()));
+    void EventDispatcher::MessageUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        discpp::Snowflake message_id = discpp::GetSnowflake(result["id"]);
+        std::shared_ptr<discpp::Message> cached_message = globals::client_instance->cache.messages.Get(message_id);
+        bool has_listeners = HasListeners<discpp::MessageUpdateEvent>();
+        if (!cached_message && !has_listeners) return;
 
         discpp::Message old_message;
         discpp::Message edited_message = discpp::Message(result);
         bool is_edited = ContainsNotNull(result, "edited_timestamp");
-        if (message_it != globals::client_instance->cache.messages.end()) {
-            if (globals::client_instance->cache.messages.size() >= discpp::globals::client_instance->message_cache_count) {
-                globals::client_instance->cache.messages.erase(globals::client_instance->cache.messages.begin());
-            }
-
-            old_message = *message_it->second;
+        if (cached_message) {
+            old_message = *cached_message;
+
+            // Updates only have the fields that changed, so only those replace the cached ones.
+            globals::client_instance->cache.messages.Update(message_id, [&](discpp::Message& message) {
+                if (ContainsNotNull(result, "content")) message.content = edited_message.content;
+                if (is_edited) message.edited_timestamp = edited_message.edited_timestamp;
+                if (ContainsNotNull(result, "mentions")) message.mentions = edited_message.mentions;
+                if (ContainsNotNull(result, "mention_roles")) message.mentioned_roles = edited_message.mentioned_roles;
+                if (ContainsNotNull(result, "attachments")) message.attachments = edited_message.attachments;
+                if (ContainsNotNull(result, "embeds")) message.embeds = edited_message.embeds;
+            });
         }
 
+        if (!has_listeners) return;
+
         discpp::DispatchEvent(discpp::MessageUpdateEvent(edited_message, old_message, is_edited));
     }
 
-    void EventDispatcher::MessageDeleteEvent(Shard& shard, rapidjson::Document& result) {
-        auto message = globals::client_instance->cache.messages.find(discpp::Snowflake(result["id"].GetString()));
+    void EventDispatcher::MessageDeleteEvent(Shard& shard, const rapidjson::Value& result) {
+        std::shared_ptr<discpp::Message> message = globals::client_instance->cache.messages.Erase(discpp::GetSnowflake(result["id"]));
 
-        if (message != globals::client_instance->cache.messages.end()) {
-            discpp::DispatchEvent(discpp::MessageDeleteEvent(*message->second));
-
-            globals::client_instance->cache.messages.erase(message);
+        if (message && HasListeners<discpp::MessageDeleteEvent>()) {
+            discpp::DispatchEvent(discpp::MessageDeleteEvent(*message));
         }
     }
 
-    void EventDispatcher::MessageDeleteBulkEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::MessageDeleteBulkEvent(Shard& shard, const rapidjson::Value& result) {
+        // Without listeners the messages only have to be removed from the cache.
+        if (!HasListeners<discpp::MessageBulkDeleteEvent>()) {
+            for (auto& id : result["ids"].GetArray()) {
+                globals::client_instance->cache.messages.Erase(discpp::GetSnowflake(id));
+            }
+            return;
+        }
+
+        // Make sure the messages values are up to date.
+        discpp::Channel channel;
+        std::shared_ptr<discpp::Guild> guild;
+        bool has_channel = GetMessageChannel(result, channel, guild);
+
         std::vector<discpp::Message> msgs;
         for (auto& id : result["ids"].GetArray()) {
-            rapidjson::Document id_json;
-            id_json.CopyFrom(id, id_json.GetAllocator());
-            auto message = globals::client_instance->cache.messages.find(discpp::Snowflake(id_json.GetString()));
-
-            if (message != globals::client_instance->cache.messages.end()) {
-                // Make sure the messages values are up to date.
-                if (ContainsNotNull(result, "guild_id")) {
-                    std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));;
-                    message->second->guild = guild;
-
-                    auto channel_it = guild->channels.find(discpp::Snowflake(result["channel_id"].GetString()));
-                    if (channel_it != guild->channels.end()) {
-                        message->second->channel = channel_it->second;
-                    }
-                } else {
-                    auto channel_it = globals::client_instance->cache.private_channels.find(discpp::Snowflake(result["channel_id"].GetString()));
+            std::shared_ptr<discpp::Message> cached_message = globals::client_instance->cache.messages.Erase(discpp::GetSnowflake(id));
 
-                    if (channel_it != globals::client_instance->cache.private_channels.end()) {
-                        message->second->channel = channel_it->second;
-                    }
-                }
+            if (cached_message) {
+                discpp::Message message = *cached_message;
+                if (guild) message.guild = guild;
+                if (has_channel) message.channel = channel;
 
-                msgs.push_back(*message->second);
+                msgs.push_back(std::move(message));
             }
         }
 
-        for (discpp::Message message : msgs) {
-            globals::client_instance->cache.messages.erase(message.id);
-        }
-
         discpp::DispatchEvent(discpp::MessageBulkDeleteEvent(msgs));
     }
 
-    void EventDispatcher::MessageReactionAddEvent(Shard& shard, rapidjson::Document& result) {
-        auto message = globals::client_instance->cache.messages.find(discpp::Snowflake(result["message_id"].GetString()));
+    void EventDispatcher::MessageReactionAddEvent(Shard& shard, const rapidjson::Value& result) {
+        discpp::Snowflake message_id = discpp::GetSnowflake(result["message_id"]);
 
-        if (message != globals::client_instance->cache.messages.end()) {
+        if (globals::client_instance->cache.messages.Contains(message_id)) {
             // Make sure the messages values are up to date.
             discpp::Channel channel;
-            if (ContainsNotNull(result, "guild_id")) {
-                std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
+            std::shared_ptr<discpp::Guild> guild;
+            bool has_channel = GetMessageChannel(result, channel, guild);
 
-                message->second->channel.guild_id = guild->id;
-                message->second->guild = guild;
-                channel = guild->GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
-            } else {
-                auto it = globals::client_instance->cache.private_channels.find(discpp::Snowflake(result["channel_id"].GetString()));
-
-                if (it != globals::client_instance->cache.private_channels.end()) {
-                    channel = it->second;
-                }
-            }
-            message->second->channel = channel;
-
-            rapidjson::Document emoji_json;
-            emoji_json.CopyFrom(result["emoji"], emoji_json.GetAllocator());
+            const rapidjson::Value& emoji_json = result["emoji"];
             discpp::Emoji emoji(emoji_json);
 
-            discpp::User user(discpp::Snowflake(result["user_id"].GetString()));
+            discpp::User user(discpp::GetSnowflake(result["user_id"]));
 
-            auto reaction = std::find_if(message->second->reactions.begin(), message->second->reactions.end(),
-            [&emoji](discpp::Reaction react) {
-                return react.emoji == emoji;
-            });
+            std::shared_ptr<discpp::Message> message = globals::client_instance->cache.messages.Update(message_id, [&](discpp::Message& message) {
+                if (guild) message.guild = guild;
+                if (has_channel) message.channel = channel;
+
+                auto reaction = std::find_if(message.reactions.begin(), message.reactions.end(),
+                [&emoji](discpp::Reaction react) {
+                    return react.emoji == emoji;
+                });
 
-            if (reaction != message->second->reactions.end()) {
-                reaction->count++;
+                if (reaction != message.reactions.end()) {
+                    reaction->count++;
 
-                if (user.IsBot()) {
-                    reaction->from_bot = true;
+                    if (user.IsBot()) {
+                        reaction->from_bot = true;
+                    }
+                } else {
+                    discpp::Reaction r = discpp::Reaction(1, user.IsBot(), emoji);
+                    message.reactions.push_back(r);
                 }
-            } else {
-                discpp::Reaction r = discpp::Reaction(1, user.IsBot(), emoji);
-                message->second->reactions.push_back(r);
-            }
+            });
 
-            discpp::DispatchEvent(discpp::MessageReactionAddEvent(*message->second, emoji, user));
-        } else {
-            discpp::Channel channel = globals::client_instance->cache.GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
-            discpp::Message message = channel.RequestMessage(discpp::Snowflake(result["message_id"].GetString()));
+            if (message && HasListeners<discpp::MessageReactionAddEvent>()) discpp::DispatchEvent(discpp::MessageReactionAddEvent(*message, emoji, user));
+        } else if (HasListeners<discpp::MessageReactionAddEvent>()) {
+            // The message isn't cached so it has to be requested, only do that for listeners.
+            discpp::Channel channel = globals::client_instance->cache.GetChannel(discpp::GetSnowflake(result["channel_id"]));
+            discpp::Message message = channel.RequestMessage(message_id);
 
             if (ContainsNotNull(result, "guild_id")) {
-                channel.guild_id = Snowflake(result["guild_id"].GetString());
-                message.guild = globals::client_instance->cache.GetGuild(Snowflake(result["guild_id"].GetString()));
+                channel.guild_id = discpp::GetSnowflake(result["guild_id"]);
+                message.guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
             }
 
-            rapidjson::Document emoji_json;
-            emoji_json.CopyFrom(result["emoji"], emoji_json.GetAllocator());
+            const rapidjson::Value& emoji_json = result["emoji"];
             discpp::Emoji emoji(emoji_json);
 
-            discpp::User user(discpp::Snowflake(result["user_id"].GetString()));
+            discpp::User user(discpp::GetSnowflake(result["user_id"]));
             discpp::DispatchEvent(discpp::MessageReactionAddEvent(message, emoji, user));
         }
     }
 
-    void EventDispatcher::MessageReactionRemoveEvent(Shard& shard, rapidjson::Document& result) {
-        auto message = globals::client_instance->cache.messages.find(discpp::Snowflake(result["message_id"].GetString()));
+    void EventDispatcher::MessageReactionRemoveEvent(Shard& shard, const rapidjson::Value& result) {
+        discpp::Snowflake message_id = discpp::GetSnowflake(result["message_id"]);
 
-        if (message != globals::client_instance->cache.messages.end()) {
+        if (globals::client_instance->cache.messages.Contains(message_id)) {
             // Make sure the messages values are up to date.
             discpp::Channel channel;
-            if (ContainsNotNull(result, "guild_id")) {
-                std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
-
-                message->second->guild = guild;
-                channel = guild->GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
-            } else {
-                auto it = globals::client_instance->cache.private_channels.find(discpp::Snowflake(result["channel_id"].GetString()));
+            std::shared_ptr<discpp::Guild> guild;
+            bool has_channel = GetMessageChannel(result, channel, guild);
 
-                if (it != globals::client_instance->cache.private_channels.end()) {
-                    channel = it->second;
-                }
-            }
-            message->second->channel = channel;
-
-            rapidjson::Document emoji_json;
-            emoji_json.CopyFrom(result["emoji"], emoji_json.GetAllocator());
+            const rapidjson::Value& emoji_json = result["emoji"];
             discpp::Emoji emoji(emoji_json);
 
-            discpp::User user(discpp::Snowflake(result["user_id"].GetString()));
+            discpp::User user(discpp::GetSnowflake(result["user_id"]));
 
-            auto reaction = std::find_if(message->second->reactions.begin(), message->second->reactions.end(),
-                 [&emoji](discpp::Reaction react) {
-                     return react.emoji == emoji;
-                 });
+            std::shared_ptr<discpp::Message> message = globals::client_instance->cache.messages.Update(message_id, [&](discpp::Message& message) {
+                if (guild) message.guild = guild;
+                if (has_channel) message.channel = channel;
 
-            if (reaction != message->second->reactions.end()) {
-                if (reaction->count == 1) {
-                    message->second->reactions.erase(reaction);
-                } else {
-                    reaction->count--;
+                auto reaction = std::find_if(message.reactions.begin(), message.reactions.end(),
+                     [&emoji](discpp::Reaction react) {
+                         return react.emoji == emoji;
+                     });
+
+                if (reaction != message.reactions.end()) {
+                    if (reaction->count == 1) {
+                        message.reactions.erase(reaction);
+                    } else {
+                        reaction->count--;
 
-                    // @TODO: Add a way to change reaction::from_bot
+                        // @TODO: Add a way to change reaction::from_bot
+                    }
                 }
-            }
+            });
 
-            discpp::DispatchEvent(discpp::MessageReactionRemoveEvent(*message->second, emoji, user));
-        } else {
-            discpp::Channel channel = globals::client_instance->cache.GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
-            discpp::Message message = channel.RequestMessage(discpp::Snowflake(result["message_id"].GetString()));
+            if (message && HasListeners<discpp::MessageReactionRemoveEvent>()) discpp::DispatchEvent(discpp::MessageReactionRemoveEvent(*message, emoji, user));
+        } else if (HasListeners<discpp::MessageReactionRemoveEvent>()) {
+            // The message isn't cached so it has to be requested, only do that for listeners.
+            discpp::Channel channel = globals::client_instance->cache.GetChannel(discpp::GetSnowflake(result["channel_id"]));
+            discpp::Message message = channel.RequestMessage(message_id);
 
             if (ContainsNotNull(result, "guild_id")) {
-                channel.guild_id = Snowflake(result["guild_id"].GetString());
-                message.guild = globals::client_instance->cache.GetGuild(Snowflake(result["guild_id"].GetString()));
+                channel.guild_id = discpp::GetSnowflake(result["guild_id"]);
+                message.guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
             }
 
-            rapidjson::Document emoji_json;
-            emoji_json.CopyFrom(result["emoji"], emoji_json.GetAllocator());
+            const rapidjson::Value& emoji_json = result["emoji"];
             discpp::Emoji emoji(emoji_json);
 
-            discpp::User user(discpp::Snowflake(result["user_id"].GetString()));
+            discpp::User user(discpp::GetSnowflake(result["user_id"]));
             discpp::DispatchEvent(discpp::MessageReactionRemoveEvent(message, emoji, user));
         }
     }
 
-    void EventDispatcher::MessageReactionRemoveAllEvent(Shard& shard, rapidjson::Document& result) {
-        auto message = globals::client_instance->cache.messages.find(discpp::Snowflake(result["message_id"].GetString()));
+    void EventDispatcher::MessageReactionRemoveAllEvent(Shard& shard, const rapidjson::Value& result) {
+        discpp::Snowflake message_id = discpp::GetSnowflake(result["message_id"]);
 
-        if (message != globals::client_instance->cache.messages.end()) {
+        if (globals::client_instance->cache.messages.Contains(message_id)) {
             discpp::Channel channel;
-            if (ContainsNotNull(result, "guild_id")) {
-                std::shared_ptr<discpp::Guild> guild = globals::client_instance->cache.GetGuild(discpp::Snowflake(result["guild_id"].GetString()));
-
-                message->second->guild = guild;
-                channel = guild->GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
-            } else {
-                auto it = globals::client_instance->cache.private_channels.find(discpp::Snowflake(result["channel_id"].GetString()));
+            std::shared_ptr<discpp::Guild> guild;
+            bool has_channel = GetMessageChannel(result, channel, guild);
 
-                if (it != globals::client_instance->cache.private_channels.end()) {
-                    channel = it->second;
-                }
-            }
-            message->second->channel = channel;
+            std::shared_ptr<discpp::Message> message = globals::client_instance->cache.messages.Update(message_id, [&](discpp::Message& message) {
+                if (guild) message.guild = guild;
+                if (has_channel) message.channel = channel;
+            });
 
-            discpp::DispatchEvent(discpp::MessageReactionRemoveAllEvent(*message->second));
-        } else {
-            discpp::Channel channel = globals::client_instance->cache.GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
-            discpp::Message message = channel.RequestMessage(discpp::Snowflake(result["message_id"].GetString()));
+            if (message && HasListeners<discpp::MessageReactionRemoveAllEvent>()) discpp::DispatchEvent(discpp::MessageReactionRemoveAllEvent(*message));
+        } else if (HasListeners<discpp::MessageReactionRemoveAllEvent>()) {
+            // The message isn't cached so it has to be requested, only do that for listeners.
+            discpp::Channel channel = globals::client_instance->cache.GetChannel(discpp::GetSnowflake(result["channel_id"]));
+            discpp::Message message = channel.RequestMessage(message_id);
 
             if (ContainsNotNull(result, "guild_id")) {
-                channel.guild_id = Snowflake(result["guild_id"].GetString());
-                message.guild = globals::client_instance->cache.GetGuild(Snowflake(result["guild_id"].GetString()));
+                channel.guild_id = discpp::GetSnowflake(result["guild_id"]);
+                message.guild = globals::client_instance->cache.GetGuild(discpp::GetSnowflake(result["guild_id"]));
             }
 
             discpp::DispatchEvent(discpp::MessageReactionRemoveAllEvent(message));
         }
     }
 
-    void EventDispatcher::PresenceUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        rapidjson::Document user_json;
-        user_json.CopyFrom(result["user"], user_json.GetAllocator());
+    void EventDispatcher::PresenceUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        Cache& cache = globals::client_instance->cache;
+        Snowflake user_id = discpp::GetSnowflake(result["user"]["id"]);
+
+        std::optional<std::shared_ptr<discpp::Guild>> guild;
+        if (ContainsNotNull(result, "guild_id")) guild = cache.guilds.Get(discpp::GetSnowflake(result["guild_id"]));
+
+        // Only cached members keep a presence. The cached member is shared, so a copy with the new presence, or
+        // without one when the policy doesn't allow it anymore, replaces it.
+        std::optional<std::shared_ptr<discpp::Member>> cached = guild ? (*guild)->members->Get(user_id) : std::nullopt;
+        if (cached) {
+            discpp::Guild& cached_guild = **guild;
+            auto presence = std::make_unique<discpp::Presence>(result);
+
+            bool keep;
+            if ((*cached)->presence) {
+                keep = cache.policies.presences.Allows(*presence);
+            } else if (cache.policies.presences.type == CachePolicyType::BOUNDED) {
+                // Counting the guild's presences walks its members, so it's only done when the bound matters.
+                size_t presences = 0;
+                cached_guild.members->ForEach([&](const discpp::Snowflake&, const std::shared_ptr<discpp::Member>& member) {
+                    if (member->presence) presences++;
+                });
+                keep = cache.policies.presences.Allows(*presence, presences);
+            } else {
+                keep = cache.policies.presences.Allows(*presence);
+            }
+
+            std::shared_ptr<discpp::Member> old_member;
+            std::shared_ptr<discpp::Member> member;
+            if (keep || (*cached)->presence) {
+                cached_guild.members->Update(user_id, [&](std::shared_ptr<discpp::Member>& cached_member) {
+                    member = std::make_shared<discpp::Member>(*cached_member);
+                    member->presence = keep ? std::move(presence) : nullptr;
+
+                    old_member = cached_member;
+                    cached_member = member;
+                });
+            }
+
+            if (member) {
+                cache.members.Update(user_id, [&](std::shared_ptr<discpp::Member>& cached_member) {
+                    if (cached_member == old_member) cached_member = member;
+                });
+            }
+
+            if (keep) {
+                cache.presence_expiry.Touch(cached_guild.id, user_id);
+            } else {
+                cache.presence_expiry.Forget(cached_guild.id, user_id);
+            }
+        }
+
+        if (!HasListeners<discpp::PresenseUpdateEvent>()) return;
+
+        const rapidjson::Value& user_json = result["user"];
         discpp::DispatchEvent(discpp::PresenseUpdateEvent(discpp::User(user_json)));
     }
 
-    void EventDispatcher::TypingStartEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::User user(discpp::Snowflake(result["user_id"].GetString()));
+    void EventDispatcher::TypingStartEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::TypingStartEvent>()) return;
+
+        discpp::User user(discpp::GetSnowflake(result["user_id"]));
 
         discpp::Channel channel;
         if (ContainsNotNull(result, "guild_id")) {
-            discpp::Guild guild(discpp::Snowflake(result["guild_id"].GetString()));
-            channel = guild.GetChannel(discpp::Snowflake(result["channel_id"].GetString()));
+            discpp::Guild guild(discpp::GetSnowflake(result["guild_id"]));
+            channel = guild.GetChannel(discpp::GetSnowflake(result["channel_id"]));
         } else {
-            channel = discpp::Channel(discpp::Snowflake(result["channel_id"].GetString()));
+            channel = discpp::Channel(discpp::GetSnowflake(result["channel_id"]));
         }
 
         int timestamp = result["timestamp"].GetInt();
@@ -558,88 +792,172 @@ namespace discpp {
         discpp::DispatchEvent(discpp::TypingStartEvent(user, channel, timestamp));
     }
 
-    void EventDispatcher::UserUpdateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::UserUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::UserUpdateEvent>()) return;
+
         discpp::User user(result);
 
         discpp::DispatchEvent(discpp::UserUpdateEvent(user));
     }
 
-    void EventDispatcher::VoiceStateUpdateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::VoiceStateUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        // The event copies the payload, so only make it for listeners.
+        if (!HasListeners<discpp::VoiceStateUpdateEvent>()) return;
+
         discpp::DispatchEvent(discpp::VoiceStateUpdateEvent(result));
     }
 
-    void EventDispatcher::VoiceServerUpdateEvent(Shard& shard, rapidjson::Document& result) {
+    void EventDispatcher::VoiceServerUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::VoiceServerUpdateEvent>()) return;
+
         discpp::DispatchEvent(discpp::VoiceServerUpdateEvent(result));
     }
 
-    void EventDispatcher::WebhooksUpdateEvent(Shard& shard, rapidjson::Document& result) {
-        discpp::Channel channel(discpp::Snowflake(result["channel_id"].GetString()));
-        channel.guild_id = discpp::Snowflake(result["guild_id"].GetString());
+    void EventDispatcher::WebhooksUpdateEvent(Shard& shard, const rapidjson::Value& result) {
+        if (!HasListeners<discpp::WebhooksUpdateEvent>()) return;
+
+        discpp::Channel channel(discpp::GetSnowflake(result["channel_id"]));
+        channel.guild_id = discpp::GetSnowflake(result["guild_id"]);
 
         discpp::DispatchEvent(discpp::WebhooksUpdateEvent(channel));
     }
 
     void EventDispatcher::BindEvents() {
-        internal_event_map["READY"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::ReadyEvent(shard, result); };
-        internal_event_map["RESUMED"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::ResumedEvent(shard, result); };
-        internal_event_map["INVALID_SESSION"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::InvalidSessionEvent(shard, result); };
-        internal_event_map["CHANNEL_CREATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::ChannelCreateEvent(shard, result); };
-        internal_event_map["CHANNEL_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::ChannelUpdateEvent(shard, result); };
-        internal_event_map["CHANNEL_DELETE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::ChannelDeleteEvent(shard, result); };
-        internal_event_map["CHANNEL_PINS_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::ChannelPinsUpdateEvent(shard, result); };
-        internal_event_map["GUILD_CREATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildCreateEvent(shard, result); };
-        internal_event_map["GUILD_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildUpdateEvent(shard, result); };
-        internal_event_map["GUILD_DELETE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildDeleteEvent(shard, result); };
-        internal_event_map["GUILD_BAN_ADD"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildBanAddEvent(shard, result); };
-        internal_event_map["GUILD_BAN_REMOVE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildBanRemoveEvent(shard, result); };
-        internal_event_map["GUILD_EMOJIS_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildEmojisUpdateEvent(shard, result); };
-        internal_event_map["GUILD_INTEGRATIONS_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildIntegrationsUpdateEvent(shard, result); };
-        internal_event_map["GUILD_MEMBER_ADD"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildMemberAddEvent(shard, result); };
-        internal_event_map["GUILD_MEMBER_REMOVE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildMemberRemoveEvent(shard, result); };
-        internal_event_map["GUILD_MEMBER_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildMemberUpdateEvent(shard, result); };
-        internal_event_map["GUILD_MEMBERS_CHUNK"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildMembersChunkEvent(shard, result); };
-        internal_event_map["GUILD_ROLE_CREATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildRoleCreateEvent(shard, result); };
-        internal_event_map["GUILD_ROLE_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildRoleUpdateEvent(shard, result); };
-        internal_event_map["GUILD_ROLE_DELETE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::GuildRoleDeleteEvent(shard, result); };
-        internal_event_map["MESSAGE_CREATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageCreateEvent(shard, result); };
-        internal_event_map["MESSAGE_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageUpdateEvent(shard, result); };
-        internal_event_map["MESSAGE_DELETE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageDeleteEvent(shard, result); };
-        internal_event_map["MESSAGE_DELETE_BULK"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageDeleteBulkEvent(shard, result); };
-        internal_event_map["MESSAGE_REACTION_ADD"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageReactionAddEvent(shard, result); };
-        internal_event_map["MESSAGE_REACTION_REMOVE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageReactionRemoveEvent(shard, result); };
-        internal_event_map["MESSAGE_REACTION_REMOVE_ALL"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::MessageReactionRemoveAllEvent(shard, result); };
-        internal_event_map["PRESENCE_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::PresenceUpdateEvent(shard, result); };
-        internal_event_map["TYPING_START"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::TypingStartEvent(shard, result); };
-        internal_event_map["USER_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::UserUpdateEvent(shard, result); };
-        internal_event_map["VOICE_STATE_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::VoiceStateUpdateEvent(shard, result); };
-        internal_event_map["VOICE_SERVER_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::VoiceServerUpdateEvent(shard, result); };
-        internal_event_map["WEBHOOKS_UPDATE"] = [&](Shard& shard, rapidjson::Document& result) { discpp::EventDispatcher::WebhooksUpdateEvent(shard, result); };
-    }
-
-    void EventDispatcher::RegisterGatewayCustomEvent(const char* event_name, const std::function<void(Shard& shard, const rapidjson::Document&)>& func) {
-        internal_event_map[event_name] = func;
-    }
-
-    void EventDispatcher::HandleDiscordEvent(Shard& shard, rapidjson::Document& j, const std::string& event_name) {
-        //std::shared_ptr<rapidjson::Document> data_ptr;
-
-        rapidjson::Document data(rapidjson::kObjectType);
-        data.CopyFrom(j["d"], data.GetAllocator());
-
-        // This shows an error for intellisense but compiles fine.
-        std::shared_ptr<rapidjson::Document> data_ptr = std::make_shared<rapidjson::Document>(data.GetType());
-        data_ptr->CopyFrom(data, data_ptr->GetAllocator());
-
-        if (ContainsNotNull(j, "s")) {
-            shard.last_sequence_number = j["s"].GetInt();
+        std::unique_lock<std::shared_mutex> lock(handlers_mutex);
+        event_handlers[static_cast<size_t>(GatewayEvent::READY)] = &EventDispatcher::ReadyEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::RESUMED)] = &EventDispatcher::ResumedEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::INVALID_SESSION)] = &EventDispatcher::InvalidSessionEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::CHANNEL_CREATE)] = &EventDispatcher::ChannelCreateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::CHANNEL_UPDATE)] = &EventDispatcher::ChannelUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::CHANNEL_DELETE)] = &EventDispatcher::ChannelDeleteEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::CHANNEL_PINS_UPDATE)] = &EventDispatcher::ChannelPinsUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_CREATE)] = &EventDispatcher::GuildCreateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_UPDATE)] = &EventDispatcher::GuildUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_DELETE)] = &EventDispatcher::GuildDeleteEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_BAN_ADD)] = &EventDispatcher::GuildBanAddEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_BAN_REMOVE)] = &EventDispatcher::GuildBanRemoveEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_EMOJIS_UPDATE)] = &EventDispatcher::GuildEmojisUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_INTEGRATIONS_UPDATE)] = &EventDispatcher::GuildIntegrationsUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_MEMBER_ADD)] = &EventDispatcher::GuildMemberAddEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_MEMBER_REMOVE)] = &EventDispatcher::GuildMemberRemoveEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_MEMBER_UPDATE)] = &EventDispatcher::GuildMemberUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_MEMBERS_CHUNK)] = &EventDispatcher::GuildMembersChunkEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_ROLE_CREATE)] = &EventDispatcher::GuildRoleCreateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_ROLE_UPDATE)] = &EventDispatcher::GuildRoleUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::GUILD_ROLE_DELETE)] = &EventDispatcher::GuildRoleDeleteEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_CREATE)] = &EventDispatcher::MessageCreateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_UPDATE)] = &EventDispatcher::MessageUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_DELETE)] = &EventDispatcher::MessageDeleteEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_DELETE_BULK)] = &EventDispatcher::MessageDeleteBulkEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_REACTION_ADD)] = &EventDispatcher::MessageReactionAddEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_REACTION_REMOVE)] = &EventDispatcher::MessageReactionRemoveEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::MESSAGE_REACTION_REMOVE_ALL)] = &EventDispatcher::MessageReactionRemoveAllEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::PRESENCE_UPDATE)] = &EventDispatcher::PresenceUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::TYPING_START)] = &EventDispatcher::TypingStartEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::USER_UPDATE)] = &EventDispatcher::UserUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::VOICE_STATE_UPDATE)] = &EventDispatcher::VoiceStateUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::VOICE_SERVER_UPDATE)] = &EventDispatcher::VoiceServerUpdateEvent;
+        event_handlers[static_cast<size_t>(GatewayEvent::WEBHOOKS_UPDATE)] = &EventDispatcher::WebhooksUpdateEvent;
+    }
+
+    void EventDispatcher::RegisterGatewayCustomEvent(const char* event_name, const std::function<void(Shard& shard, const rapidjson::Value&)>& func) {
+        // Events discpp knows replace its handler, others are looked up by name.
+        GatewayEvent event = ParseGatewayEvent(event_name);
+
+        std::unique_lock<std::shared_mutex> lock(handlers_mutex);
+        if (event != GatewayEvent::UNKNOWN) {
+            event_handlers[static_cast<size_t>(event)] = func;
+        } else {
+            custom_event_map[event_name] = func;
+        }
+    }
+
+    uint64_t EventDispatcher::GetEventCount(GatewayEvent event) {
+        return event_counts[static_cast<size_t>(event)];
+    }
+
+    uint64_t EventDispatcher::GetStrandKey(const rapidjson::Value& data, GatewayEvent event) {
+        if (!data.IsObject()) return 0;
+
+        if (ContainsNotNull(data, "guild_id")) return GetSnowflake(data["guild_id"]);
+        if (ContainsNotNull(data, "channel_id")) return GetSnowflake(data["channel_id"]);
+
+        // These events are the guild or channel object itself.
+        switch (event) {
+            case GatewayEvent::GUILD_CREATE:
+            case GatewayEvent::GUILD_UPDATE:
+            case GatewayEvent::GUILD_DELETE:
+            case GatewayEvent::CHANNEL_CREATE:
+            case GatewayEvent::CHANNEL_UPDATE:
+            case GatewayEvent::CHANNEL_DELETE:
+                return GetIDSafely(data, "id");
+            default:
+                break;
+        }
+
+        // Events that aren't about a guild or channel, like READY and USER_UPDATE, share a strand.
+        return 0;
+    }
+
+    uint64_t EventDispatcher::GetObjectKey(const rapidjson::Value& data) {
+        if (!data.IsObject()) return 0;
+
+        if (ContainsNotNull(data, "id")) return GetSnowflake(data["id"]);
+        if (ContainsNotNull(data, "user_id")) return GetSnowflake(data["user_id"]);
+        if (ContainsNotNull(data, "user") && data["user"].IsObject()) return GetIDSafely(data["user"], "id");
+
+        return 0;
+    }
+
+    void EventDispatcher::HandleDiscordEvent(Shard& shard, std::shared_ptr<rapidjson::Document> frame) {
+        if (ContainsNotNull(*frame, "s")) {
+            shard.last_sequence_number = (*frame)["s"].GetInt();
         } else {
             shard.last_sequence_number = 0;
         }
 
-        Shard* sh = &shard;
-        if (internal_event_map.find(event_name) != internal_event_map.end()) {
-            globals::client_instance->DoFunctionLater([sh, data = std::move(data_ptr), event_name] {
-                internal_event_map[event_name](*sh, *data);
+        const rapidjson::Value& t = (*frame)["t"];
+        std::string_view event_name(t.GetString(), t.GetStringLength());
+        GatewayEvent event = ParseGatewayEvent(event_name);
+
+        // Codecs that can't peek at the event name leave ignored events to be dropped here.
+        if (shard.IsIgnoredEvent(event)) return;
+
+        event_counts[static_cast<size_t>(event)]++;
+
+        // The task gets its own copy of the handler, since it can be replaced before the task runs.
+        std::function<void(Shard& shard, const rapidjson::Value&)> handler;
+        {
+            std::shared_lock<std::shared_mutex> lock(handlers_mutex);
+            if (event != GatewayEvent::UNKNOWN) {
+                handler = event_handlers[static_cast<size_t>(event)];
+            } else {
+                auto it = custom_event_map.find(std::string(event_name));
+                if (it != custom_event_map.end()) handler = it->second;
+            }
+        }
+
+        if (handler) {
+            // The parsed frame is moved into the task and the handler reads `d` straight out of it, so the
+            // payload is never copied.
+            Shard* sh = &shard;
+            EventQueues& queues = *globals::client_instance->event_queues;
+            uint64_t strand_key = GetStrandKey((*frame)["d"], event);
+            uint64_t object_key = queues.Coalesces(event) ? GetObjectKey((*frame)["d"]) : 0;
+            queues.Post(event, strand_key, object_key, [sh, handler = std::move(handler), frame = std::move(frame)] {
+                struct CurrentShard {
+                    Shard* previous = Shard::current;
+
+                    explicit CurrentShard(Shard* shard) {
+                        Shard::current = shard;
+                    }
+
+                    ~CurrentShard() {
+                        Shard::current = previous;
+                    }
+                } current_shard(sh);
+
+                handler(*sh, (*frame)["d"]);
             });
         }
     }
@@ -0,0 +1,127 @@
+#include "event_queue.h"
+
+namespace discpp {
+    EventQueues::EventQueues(StrandExecutor& strands) : strands(strands) {
+
+    }
+
+    void EventQueues::SetLimit(GatewayEvent event, EventQueueLimit limit) {
+        queues[static_cast<size_t>(event)].limit = limit;
+    }
+
+    bool EventQueues::Coalesces(GatewayEvent event) const {
+        return queues[static_cast<size_t>(event)].limit.policy == OverflowPolicy::COALESCE;
+    }
+
+    bool EventQueues::Post(GatewayEvent event, uint64_t strand_key, uint64_t object_key, ThreadPool::Task task) {
+        Queue& queue = queues[static_cast<size_t>(event)];
+
+        // Unlimited queues only keep count, the strand holds the event.
+        if ((queue.limit.capacity == 0 && queue.limit.policy != OverflowPolicy::COALESCE) || stopping) {
+            queue.depth++;
+            strands.Post(strand_key, [&queue, task = std::move(task)] {
+                queue.depth--;
+                task();
+            });
+            return true;
+        }
+
+        auto key = std::make_pair(strand_key, object_key);
+        std::shared_ptr<Slot> slot;
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+
+            if (queue.limit.policy == OverflowPolicy::COALESCE && object_key != 0) {
+                auto itr = queue.by_key.find(key);
+                if (itr != queue.by_key.end()) {
+                    // The queued event hasn't started, so it can be handled with the newer data instead.
+                    itr->second->task = std::move(task);
+                    queue.coalesced++;
+                    return true;
+                }
+            }
+
+            bool full = queue.limit.capacity != 0 && queue.pending.size() >= queue.limit.capacity;
+            if (full) {
+                switch (queue.limit.policy) {
+                    case OverflowPolicy::BLOCK:
+                        queue.blocked++;
+                        queue.room.wait(lock, [&] { return queue.pending.size() < queue.limit.capacity || stopping; });
+                        break;
+                    case OverflowPolicy::DROP_OLDEST: {
+                        // Its strand task is still queued, it finds the slot empty and does nothing.
+                        std::shared_ptr<Slot> oldest = queue.pending.front();
+                        oldest->task = nullptr;
+                        Remove(queue, *oldest);
+                        queue.dropped++;
+                        break;
+                    }
+                    case OverflowPolicy::DROP_NEWEST:
+                    case OverflowPolicy::COALESCE:
+                        queue.dropped++;
+                        return false;
+                }
+            }
+
+            slot = std::make_shared<Slot>();
+            slot->task = std::move(task);
+            slot->key = key;
+            slot->position = queue.pending.insert(queue.pending.end(), slot);
+            if (queue.limit.policy == OverflowPolicy::COALESCE && object_key != 0) {
+                queue.by_key.emplace(key, slot);
+            }
+            queue.depth++;
+        }
+
+        strands.Post(strand_key, [this, &queue, slot] { Run(queue, slot); });
+        return true;
+    }
+
+    void EventQueues::Stop() {
+        stopping = true;
+
+        for (Queue& queue : queues) {
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+            }
+            queue.room.notify_all();
+        }
+    }
+
+    EventQueueStats EventQueues::GetStats(GatewayEvent event) const {
+        const Queue& queue = queues[static_cast<size_t>(event)];
+
+        EventQueueStats stats;
+        stats.depth = queue.depth;
+        stats.dropped = queue.dropped;
+        stats.coalesced = queue.coalesced;
+        stats.blocked = queue.blocked;
+
+        return stats;
+    }
+
+    void EventQueues::Remove(Queue& queue, Slot& slot) {
+        if (queue.limit.policy == OverflowPolicy::COALESCE) {
+            auto itr = queue.by_key.find(slot.key);
+            if (itr != queue.by_key.end() && itr->second.get() == &slot) queue.by_key.erase(itr);
+        }
+
+        queue.pending.erase(slot.position);
+        queue.depth--;
+    }
+
+    void EventQueues::Run(Queue& queue, const std::shared_ptr<Slot>& slot) {
+        ThreadPool::Task task;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!slot->task) return;
+
+            task = std::move(slot->task);
+            slot->task = nullptr;
+            Remove(queue, *slot);
+        }
+        queue.room.notify_one();
+
+        task();
+    }
+}
@@ -0,0 +1,526 @@
+#include "gateway_codec.h"
+#include "exceptions.h"
+#include "utils.h"
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+namespace discpp {
+    std::unique_ptr<GatewayCodec> GatewayCodec::Create(GatewayEncoding encoding) {
+        switch (encoding) {
+            case GatewayEncoding::ETF:
+                return std::make_unique<EtfCodec>();
+            case GatewayEncoding::JSON:
+            default:
+                return std::make_unique<JsonCodec>();
+        }
+    }
+
+    std::unique_ptr<rapidjson::Document> JsonCodec::Decode(const std::string& payload) {
+        auto document = std::make_unique<rapidjson::Document>();
+        document->Parse(payload.data(), payload.size());
+
+        if (document->HasParseError()) {
+            throw exceptions::PayloadDecodeException("A non-json payload was received: \"" + payload + "\"");
+        }
+
+        return document;
+    }
+
+    std::string JsonCodec::Encode(const rapidjson::Value& payload) {
+        return DumpJson(payload);
+    }
+
+    // A small scanner over the top level of a json object, it only understands enough json to step over values.
+    class JsonPeeker {
+    public:
+        explicit JsonPeeker(const std::string& payload) : pos(payload.data()), end(payload.data() + payload.size()) {}
+
+        bool Peek(PayloadHeader& header) {
+            SkipWhitespace();
+            if (!Consume('{')) return false;
+
+            bool has_op = false, has_sequence = false, has_event_name = false;
+            while (!(has_op && has_sequence && has_event_name)) {
+                SkipWhitespace();
+                if (Consume('}')) break;
+                if (Consume(',')) continue;
+
+                std::string_view key;
+                if (!ReadString(key)) return false;
+
+                SkipWhitespace();
+                if (!Consume(':')) return false;
+                SkipWhitespace();
+
+                if (key == "op") {
+                    if (!ReadInt(header.op)) return false;
+                    has_op = true;
+                } else if (key == "s") {
+                    if (!ConsumeNull() && !ReadInt(header.sequence)) return false;
+                    has_sequence = true;
+                } else if (key == "t") {
+                    if (!ConsumeNull() && !ReadString(header.event_name)) return false;
+                    has_event_name = true;
+                } else if (!SkipValue()) {
+                    return false;
+                }
+            }
+
+            return has_op;
+        }
+    private:
+        const char* pos;
+        const char* end;
+
+        void SkipWhitespace() {
+            while (pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) pos++;
+        }
+
+        bool Consume(char c) {
+            if (pos == end || *pos != c) return false;
+            pos++;
+            return true;
+        }
+
+        bool ConsumeNull() {
+            if (end - pos < 4 || std::memcmp(pos, "null", 4) != 0) return false;
+            pos += 4;
+            return true;
+        }
+
+        // Event names and keys never have escapes, so a string with one is treated as something this can't read.
+        bool ReadString(std::string_view& str) {
+            if (!Consume('"')) return false;
+
+            const char* start = pos;
+            while (pos != end && *pos != '"') {
+                if (*pos == '\\') return false;
+                pos++;
+            }
+            if (pos == end) return false;
+
+            str = std::string_view(start, pos - start);
+            pos++;
+            return true;
+        }
+
+        bool ReadInt(int& value) {
+            bool negative = Consume('-');
+            if (pos == end || *pos < '0' || *pos > '9') return false;
+
+            long long result = 0;
+            while (pos != end && *pos >= '0' && *pos <= '9') {
+                result = result * 10 + (*pos - '0');
+                if (result > INT32_MAX) return false;
+                pos++;
+            }
+
+            value = static_cast<int>(negative ? -result : result);
+            return true;
+        }
+
+        bool SkipString() {
+            if (!Consume('"')) return false;
+
+            while (pos != end && *pos != '"') {
+                // Skip whatever is escaped, it could be a quote.
+                if (*pos == '\\' && ++pos == end) return false;
+                pos++;
+            }
+
+            return Consume('"');
+        }
+
+        bool SkipValue() {
+            if (pos == end) return false;
+
+            if (*pos == '"') return SkipString();
+
+            if (*pos == '{' || *pos == '[') {
+                // Brackets only have to be counted, the strings inside are skipped so brackets in them are ignored.
+                int depth = 0;
+                while (pos != end) {
+                    char c = *pos;
+                    if (c == '"') {
+                        if (!SkipString()) return false;
+                        continue;
+                    }
+
+                    pos++;
+                    if (c == '{' || c == '[') {
+                        depth++;
+                    } else if ((c == '}' || c == ']') && --depth == 0) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            // Numbers, booleans and null.
+            const char* start = pos;
+            while (pos != end && *pos != ',' && *pos != '}' && *pos != ']' && *pos != ' ' && *pos != '\n' && *pos != '\r' && *pos != '\t') pos++;
+            return pos != start;
+        }
+    };
+
+    bool JsonCodec::PeekHeader(const std::string& payload, PayloadHeader& header) {
+        header = PayloadHeader();
+        return JsonPeeker(payload).Peek(header);
+    }
+
+    // Erlang external term format tags that Discord will send or accept.
+    enum EtfTag : uint8_t {
+        NEW_FLOAT_EXT = 70,
+        SMALL_INTEGER_EXT = 97,
+        INTEGER_EXT = 98,
+        FLOAT_EXT = 99,
+        ATOM_EXT = 100,
+        SMALL_TUPLE_EXT = 104,
+        LARGE_TUPLE_EXT = 105,
+        NIL_EXT = 106,
+        STRING_EXT = 107,
+        LIST_EXT = 108,
+        BINARY_EXT = 109,
+        SMALL_BIG_EXT = 110,
+        LARGE_BIG_EXT = 111,
+        SMALL_ATOM_EXT = 115,
+        MAP_EXT = 116,
+        ATOM_UTF8_EXT = 118,
+        SMALL_ATOM_UTF8_EXT = 119,
+        FORMAT_VERSION = 131
+    };
+
+    // Protects against stack overflows from malicious payloads, Discord doesn't nest anywhere near this deep.
+    static constexpr int etf_max_depth = 256;
+
+    class EtfReader {
+    public:
+        EtfReader(const std::string& data, rapidjson::Document::AllocatorType& allocator) : data(data), allocator(allocator) {}
+
+        void ReadVersion() {
+            if (Read8() != FORMAT_VERSION) {
+                throw exceptions::PayloadDecodeException("ETF payload has an unsupported format version");
+            }
+        }
+
+        void ReadTerm(rapidjson::Value& out, int depth = 0) {
+            if (depth > etf_max_depth) {
+                throw exceptions::PayloadDecodeException("ETF payload is nested too deep");
+            }
+
+            uint8_t tag = Read8();
+            switch (tag) {
+                case SMALL_INTEGER_EXT:
+                    out.SetInt(Read8());
+                    break;
+                case INTEGER_EXT:
+                    out.SetInt(static_cast<int32_t>(Read32()));
+                    break;
+                case NEW_FLOAT_EXT: {
+                    uint64_t bits = Read64();
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    out.SetDouble(value);
+                    break;
+                } case FLOAT_EXT: {
+                    const char* bytes = ReadBytes(31);
+                    out.SetDouble(std::strtod(std::string(bytes, 31).c_str(), nullptr));
+                    break;
+                } case ATOM_EXT:
+                case ATOM_UTF8_EXT:
+                    ReadAtom(out, Read16());
+                    break;
+                case SMALL_ATOM_EXT:
+                case SMALL_ATOM_UTF8_EXT:
+                    ReadAtom(out, Read8());
+                    break;
+                case BINARY_EXT: {
+                    uint32_t length = Read32();
+                    out.SetString(ReadBytes(length), length, allocator);
+                    break;
+                } case STRING_EXT: {
+                    // Erlang strings are just lists of bytes, treat them like binaries.
+                    uint16_t length = Read16();
+                    out.SetString(ReadBytes(length), length, allocator);
+                    break;
+                } case NIL_EXT:
+                    out.SetArray();
+                    break;
+                case LIST_EXT: {
+                    ReadArray(out, Read32(), depth);
+
+                    // Proper lists end with an empty list, which we don't need to keep.
+                    rapidjson::Value tail;
+                    ReadTerm(tail, depth + 1);
+                    break;
+                } case SMALL_TUPLE_EXT:
+                    ReadArray(out, Read8(), depth);
+                    break;
+                case LARGE_TUPLE_EXT:
+                    ReadArray(out, Read32(), depth);
+                    break;
+                case SMALL_BIG_EXT:
+                    ReadBig(out, Read8());
+                    break;
+                case LARGE_BIG_EXT:
+                    ReadBig(out, Read32());
+                    break;
+                case MAP_EXT: {
+                    uint32_t arity = Read32();
+                    out.SetObject();
+
+                    for (uint32_t i = 0; i < arity; i++) {
+                        rapidjson::Value key;
+                        ReadTerm(key, depth + 1);
+                        if (!key.IsString()) {
+                            throw exceptions::PayloadDecodeException("ETF payload has a map key that isn't a string or atom");
+                        }
+
+                        rapidjson::Value value;
+                        ReadTerm(value, depth + 1);
+
+                        out.AddMember(key, value, allocator);
+                    }
+                    break;
+                } default:
+                    throw exceptions::PayloadDecodeException("ETF payload has an unsupported term: " + std::to_string(tag));
+            }
+        }
+
+        bool AtEnd() const {
+            return offset == data.size();
+        }
+    private:
+        const std::string& data;
+        size_t offset = 0;
+        rapidjson::Document::AllocatorType& allocator;
+
+        const char* ReadBytes(size_t length) {
+            if (data.size() - offset < length) {
+                throw exceptions::PayloadDecodeException("ETF payload ended unexpectedly");
+            }
+
+            const char* bytes = data.data() + offset;
+            offset += length;
+            return bytes;
+        }
+
+        uint8_t Read8() {
+            return static_cast<uint8_t>(*ReadBytes(1));
+        }
+
+        uint16_t Read16() {
+            auto bytes = reinterpret_cast<const uint8_t*>(ReadBytes(2));
+            return static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+        }
+
+        uint32_t Read32() {
+            auto bytes = reinterpret_cast<const uint8_t*>(ReadBytes(4));
+            return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+                (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+        }
+
+        uint64_t Read64() {
+            uint64_t high = Read32();
+            return (high << 32) | Read32();
+        }
+
+        void ReadAtom(rapidjson::Value& out, size_t length) {
+            const char* atom = ReadBytes(length);
+
+            if ((length == 3 && std::memcmp(atom, "nil", 3) == 0) || (length == 4 && std::memcmp(atom, "null", 4) == 0)) {
+                out.SetNull();
+            } else if (length == 4 && std::memcmp(atom, "true", 4) == 0) {
+                out.SetBool(true);
+            } else if (length == 5 && std::memcmp(atom, "false", 5) == 0) {
+                out.SetBool(false);
+            } else {
+                out.SetString(atom, static_cast<rapidjson::SizeType>(length), allocator);
+            }
+        }
+
+        void ReadArray(rapidjson::Value& out, uint32_t length, int depth) {
+            // Every element takes at least a byte, a longer length can only come from a broken payload and must not
+            // decide how much is allocated.
+            if (length > data.size() - offset) {
+                throw exceptions::PayloadDecodeException("ETF payload has a list longer than the payload");
+            }
+
+            out.SetArray();
+            out.Reserve(length, allocator);
+
+            for (uint32_t i = 0; i < length; i++) {
+                rapidjson::Value element;
+                ReadTerm(element, depth + 1);
+                out.PushBack(element, allocator);
+            }
+        }
+
+        void ReadBig(rapidjson::Value& out, uint32_t digits) {
+            uint8_t sign = Read8();
+            const auto* bytes = reinterpret_cast<const uint8_t*>(ReadBytes(digits));
+
+            if (digits > sizeof(uint64_t)) {
+                throw exceptions::PayloadDecodeException("ETF payload has an integer larger than 64 bits");
+            }
+
+            // Big integers are stored little endian.
+            uint64_t value = 0;
+            for (uint32_t i = 0; i < digits; i++) {
+                value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+            }
+
+            if (sign == 0) {
+                out.SetUint64(value);
+            } else if (value <= static_cast<uint64_t>(INT64_MAX) + 1) {
+                out.SetInt64(static_cast<int64_t>(0 - value));
+            } else {
+                throw exceptions::PayloadDecodeException("ETF payload has an integer smaller than 64 bits");
+            }
+        }
+    };
+
+    class EtfWriter {
+    public:
+        explicit EtfWriter(std::string& out) : out(out) {}
+
+        void WriteTerm(const rapidjson::Value& value) {
+            switch (value.GetType()) {
+                case rapidjson::kNullType:
+                    WriteAtom("nil", 3);
+                    break;
+                case rapidjson::kFalseType:
+                    WriteAtom("false", 5);
+                    break;
+                case rapidjson::kTrueType:
+                    WriteAtom("true", 4);
+                    break;
+                case rapidjson::kStringType:
+                    WriteBinary(value.GetString(), value.GetStringLength());
+                    break;
+                case rapidjson::kNumberType:
+                    WriteNumber(value);
+                    break;
+                case rapidjson::kArrayType:
+                    if (value.Empty()) {
+                        Write8(NIL_EXT);
+                        break;
+                    }
+
+                    Write8(LIST_EXT);
+                    Write32(value.Size());
+                    for (auto const& element : value.GetArray()) {
+                        WriteTerm(element);
+                    }
+                    Write8(NIL_EXT);
+                    break;
+                case rapidjson::kObjectType:
+                    Write8(MAP_EXT);
+                    Write32(value.MemberCount());
+                    for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+                        WriteBinary(it->name.GetString(), it->name.GetStringLength());
+                        WriteTerm(it->value);
+                    }
+                    break;
+            }
+        }
+    private:
+        std::string& out;
+
+        void Write8(uint8_t value) {
+            out.push_back(static_cast<char>(value));
+        }
+
+        void Write16(uint16_t value) {
+            Write8(static_cast<uint8_t>(value >> 8));
+            Write8(static_cast<uint8_t>(value));
+        }
+
+        void Write32(uint32_t value) {
+            Write16(static_cast<uint16_t>(value >> 16));
+            Write16(static_cast<uint16_t>(value));
+        }
+
+        void Write64(uint64_t value) {
+            Write32(static_cast<uint32_t>(value >> 32));
+            Write32(static_cast<uint32_t>(value));
+        }
+
+        void WriteAtom(const char* atom, uint8_t length) {
+            Write8(SMALL_ATOM_UTF8_EXT);
+            Write8(length);
+            out.append(atom, length);
+        }
+
+        void WriteBinary(const char* str, uint32_t length) {
+            Write8(BINARY_EXT);
+            Write32(length);
+            out.append(str, length);
+        }
+
+        void WriteBig(uint64_t value, bool negative) {
+            uint8_t digits[sizeof(uint64_t)];
+            uint8_t count = 0;
+            while (value > 0) {
+                digits[count++] = static_cast<uint8_t>(value & 0xff);
+                value >>= 8;
+            }
+
+            Write8(SMALL_BIG_EXT);
+            Write8(count);
+            Write8(negative ? 1 : 0);
+            out.append(reinterpret_cast<const char*>(digits), count);
+        }
+
+        void WriteNumber(const rapidjson::Value& value) {
+            if (value.IsInt()) {
+                int number = value.GetInt();
+                if (number >= 0 && number <= 255) {
+                    Write8(SMALL_INTEGER_EXT);
+                    Write8(static_cast<uint8_t>(number));
+                } else {
+                    Write8(INTEGER_EXT);
+                    Write32(static_cast<uint32_t>(number));
+                }
+            } else if (value.IsUint64()) {
+                WriteBig(value.GetUint64(), false);
+            } else if (value.IsInt64()) {
+                WriteBig(0 - static_cast<uint64_t>(value.GetInt64()), true);
+            } else {
+                double number = value.GetDouble();
+                uint64_t bits;
+                std::memcpy(&bits, &number, sizeof(bits));
+
+                Write8(NEW_FLOAT_EXT);
+                Write64(bits);
+            }
+        }
+    };
+
+    std::unique_ptr<rapidjson::Document> EtfCodec::Decode(const std::string& payload) {
+        auto document = std::make_unique<rapidjson::Document>();
+
+        EtfReader reader(payload, document->GetAllocator());
+        reader.ReadVersion();
+        reader.ReadTerm(*document);
+
+        if (!reader.AtEnd()) {
+            throw exceptions::PayloadDecodeException("ETF payload has trailing data");
+        }
+
+        return document;
+    }
+
+    std::string EtfCodec::Encode(const rapidjson::Value& payload) {
+        std::string out;
+        out.push_back(static_cast<char>(FORMAT_VERSION));
+
+        EtfWriter writer(out);
+        writer.WriteTerm(payload);
+
+        return out;
+    }
+}
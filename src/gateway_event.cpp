@@ -0,0 +1,99 @@
+#include "gateway_event.h"
+
+#include <initializer_list>
+
+namespace discpp {
+    // In the same order as discpp::GatewayEvent.
+    static const char* const kGatewayEventNames[kGatewayEventCount] = {
+        "UNKNOWN",
+        "READY",
+        "RESUMED",
+        "INVALID_SESSION",
+        "CHANNEL_CREATE",
+        "CHANNEL_UPDATE",
+        "CHANNEL_DELETE",
+        "CHANNEL_PINS_UPDATE",
+        "GUILD_CREATE",
+        "GUILD_UPDATE",
+        "GUILD_DELETE",
+        "GUILD_BAN_ADD",
+        "GUILD_BAN_REMOVE",
+        "GUILD_EMOJIS_UPDATE",
+        "GUILD_INTEGRATIONS_UPDATE",
+        "GUILD_MEMBER_ADD",
+        "GUILD_MEMBER_REMOVE",
+        "GUILD_MEMBER_UPDATE",
+        "GUILD_MEMBERS_CHUNK",
+        "GUILD_ROLE_CREATE",
+        "GUILD_ROLE_UPDATE",
+        "GUILD_ROLE_DELETE",
+        "MESSAGE_CREATE",
+        "MESSAGE_UPDATE",
+        "MESSAGE_DELETE",
+        "MESSAGE_DELETE_BULK",
+        "MESSAGE_REACTION_ADD",
+        "MESSAGE_REACTION_REMOVE",
+        "MESSAGE_REACTION_REMOVE_ALL",
+        "PRESENCE_UPDATE",
+        "TYPING_START",
+        "USER_UPDATE",
+        "VOICE_STATE_UPDATE",
+        "VOICE_SERVER_UPDATE",
+        "WEBHOOKS_UPDATE"
+    };
+
+    // Compares the name against the few events the switch below narrowed it down to.
+    static GatewayEvent Match(std::string_view name, std::initializer_list<GatewayEvent> candidates) {
+        for (GatewayEvent candidate : candidates) {
+            if (name == kGatewayEventNames[static_cast<size_t>(candidate)]) return candidate;
+        }
+
+        return GatewayEvent::UNKNOWN;
+    }
+
+    GatewayEvent ParseGatewayEvent(std::string_view name) {
+        using E = GatewayEvent;
+
+        // The length and first character leave at most four names to compare.
+        switch (name.size()) {
+            case 5: return Match(name, { E::READY });
+            case 7: return Match(name, { E::RESUMED });
+            case 11: return Match(name, { E::USER_UPDATE });
+            case 12:
+                if (name[0] == 'T') return Match(name, { E::TYPING_START });
+                return Match(name, { E::GUILD_CREATE, E::GUILD_UPDATE, E::GUILD_DELETE });
+            case 13: return Match(name, { E::GUILD_BAN_ADD });
+            case 14:
+                if (name[0] == 'M') return Match(name, { E::MESSAGE_CREATE, E::MESSAGE_UPDATE, E::MESSAGE_DELETE });
+                return Match(name, { E::CHANNEL_CREATE, E::CHANNEL_UPDATE, E::CHANNEL_DELETE });
+            case 15:
+                switch (name[0]) {
+                    case 'I': return Match(name, { E::INVALID_SESSION });
+                    case 'P': return Match(name, { E::PRESENCE_UPDATE });
+                    case 'W': return Match(name, { E::WEBHOOKS_UPDATE });
+                    default: return E::UNKNOWN;
+                }
+            case 16: return Match(name, { E::GUILD_BAN_REMOVE, E::GUILD_MEMBER_ADD });
+            case 17: return Match(name, { E::GUILD_ROLE_CREATE, E::GUILD_ROLE_UPDATE, E::GUILD_ROLE_DELETE });
+            case 18: return Match(name, { E::VOICE_STATE_UPDATE });
+            case 19:
+                switch (name[0]) {
+                    case 'C': return Match(name, { E::CHANNEL_PINS_UPDATE });
+                    case 'M': return Match(name, { E::MESSAGE_DELETE_BULK });
+                    case 'V': return Match(name, { E::VOICE_SERVER_UPDATE });
+                    case 'G': return Match(name, { E::GUILD_MEMBER_UPDATE, E::GUILD_MEMBER_REMOVE, E::GUILD_MEMBERS_CHUNK, E::GUILD_EMOJIS_UPDATE });
+                    default: return E::UNKNOWN;
+                }
+            case 20: return Match(name, { E::MESSAGE_REACTION_ADD });
+            case 23: return Match(name, { E::MESSAGE_REACTION_REMOVE });
+            case 25: return Match(name, { E::GUILD_INTEGRATIONS_UPDATE });
+            case 27: return Match(name, { E::MESSAGE_REACTION_REMOVE_ALL });
+            default: return E::UNKNOWN;
+        }
+    }
+
+    const char* GetGatewayEventName(GatewayEvent event) {
+        size_t index = static_cast<size_t>(event);
+        return index < kGatewayEventCount ? kGatewayEventNames[index] : kGatewayEventNames[0];
+    }
+}
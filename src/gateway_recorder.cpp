@@ -0,0 +1,113 @@
+#include "gateway_recorder.h"
+#include "exceptions.h"
+
+#include <algorithm>
+
+namespace discpp {
+    static const char kRecordingMagic[8] = { 'D', 'P', 'P', 'G', 'W', 'L', 'O', 'G' };
+    static const uint8_t kRecordingVersion = 1;
+
+    static void WriteVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static bool ReadVarint(std::istream& in, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = in.get();
+            if (byte == std::char_traits<char>::eof()) return false;
+
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+
+        return false;
+    }
+
+    GatewayRecorder::GatewayRecorder(const std::string& path) : file(path, std::ios::out | std::ios::binary | std::ios::trunc), start_time(std::chrono::steady_clock::now()) {
+        if (!file.is_open()) {
+            throw exceptions::RecordingException("Failed to open gateway recording \"" + path + "\" for writing");
+        }
+
+        file.write(kRecordingMagic, sizeof(kRecordingMagic));
+        file.put(static_cast<char>(kRecordingVersion));
+    }
+
+    void GatewayRecorder::Record(int shard_id, uint8_t flags, const std::string& data) {
+        std::string header;
+        header.reserve(24);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // The timestamp is taken while locked so the deltas can't go backwards.
+        auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+        WriteVarint(header, static_cast<uint64_t>((timestamp - last_timestamp).count()));
+        WriteVarint(header, static_cast<uint64_t>(shard_id));
+        header.push_back(static_cast<char>(flags));
+        WriteVarint(header, data.size());
+
+        file.write(header.data(), header.size());
+        file.write(data.data(), data.size());
+
+        last_timestamp = timestamp;
+        frame_count++;
+    }
+
+    void GatewayRecorder::Flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        file.flush();
+    }
+
+    uint64_t GatewayRecorder::GetFrameCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frame_count;
+    }
+
+    GatewayRecordingReader::GatewayRecordingReader(const std::string& path) : file(path, std::ios::in | std::ios::binary) {
+        if (!file.is_open()) {
+            throw exceptions::RecordingException("Failed to open gateway recording \"" + path + "\"");
+        }
+
+        char magic[sizeof(kRecordingMagic)];
+        if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kRecordingMagic)) {
+            throw exceptions::RecordingException("\"" + path + "\" isn't a gateway recording");
+        }
+
+        int version = file.get();
+        if (version != kRecordingVersion) {
+            throw exceptions::RecordingException("Gateway recording \"" + path + "\" has unsupported version " + std::to_string(version));
+        }
+
+        std::streampos frames_start = file.tellg();
+        file.seekg(0, std::ios::end);
+        file_size = file.tellg();
+        file.seekg(frames_start);
+    }
+
+    bool GatewayRecordingReader::Next(GatewayFrame& frame) {
+        uint64_t delta, shard_id, size;
+        if (!ReadVarint(file, delta) || !ReadVarint(file, shard_id)) return false;
+
+        int flags = file.get();
+        if (flags == std::char_traits<char>::eof() || !ReadVarint(file, size)) return false;
+
+        // A size larger than the rest of the file means the log was cut off or is corrupt, so it ends here.
+        std::streamoff position = file.tellg();
+        if (position < 0 || size > static_cast<uint64_t>(file_size - position)) return false;
+
+        frame.data.resize(size);
+        if (!file.read(&frame.data[0], size)) return false;
+
+        timestamp += std::chrono::nanoseconds(delta);
+
+        frame.shard_id = static_cast<int>(shard_id);
+        frame.timestamp = timestamp;
+        frame.flags = static_cast<uint8_t>(flags);
+
+        return true;
+    }
+}
@@ -0,0 +1,125 @@
+#include "gateway_send_queue.h"
+
+#include <algorithm>
+
+namespace discpp {
+    GatewaySendQueue::GatewaySendQueue(SendFunction send, int commands_per_window, std::chrono::milliseconds window, int reserved_commands)
+        : send(std::move(send)), commands_per_window(std::max(commands_per_window, 1)), window(window),
+        reserved(std::max(std::min(reserved_commands, commands_per_window - 1), 0)) {
+
+        thread = std::thread(&GatewaySendQueue::Run, this);
+    }
+
+    GatewaySendQueue::~GatewaySendQueue() {
+        Stop();
+    }
+
+    void GatewaySendQueue::Push(std::string payload, GatewaySendLane lane, bool coalesce) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopped) return;
+
+            std::deque<QueuedPayload>& queue = lane == GatewaySendLane::PRIORITY ? priority_queue : normal_queue;
+            if (coalesce) {
+                // Only the newest one matters, so overwrite the old one and keep its place in the queue.
+                auto it = std::find_if(queue.begin(), queue.end(), [](const QueuedPayload& queued) { return queued.coalesce; });
+                if (it != queue.end()) {
+                    it->payload = std::move(payload);
+                    coalesced++;
+                    return;
+                }
+            }
+
+            queue.push_back({ std::move(payload), coalesce, std::chrono::steady_clock::now() });
+        }
+
+        cv.notify_one();
+    }
+
+    void GatewaySendQueue::Reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        priority_queue.clear();
+        normal_queue.clear();
+        sent_at.clear();
+    }
+
+    void GatewaySendQueue::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+            priority_queue.clear();
+            normal_queue.clear();
+        }
+
+        cv.notify_one();
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+            thread.join();
+        }
+    }
+
+    GatewaySendQueueStats GatewaySendQueue::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        GatewaySendQueueStats stats;
+        stats.depth = priority_queue.size() + normal_queue.size();
+        stats.sent = sent;
+        stats.coalesced = coalesced;
+        stats.average_wait = sent == 0 ? std::chrono::microseconds(0) : std::chrono::microseconds(total_wait.count() / static_cast<int64_t>(sent));
+        stats.max_wait = max_wait;
+
+        return stats;
+    }
+
+    void GatewaySendQueue::ForgetExpired(std::chrono::steady_clock::time_point now) {
+        while (!sent_at.empty() && sent_at.front() + window <= now) {
+            sent_at.pop_front();
+        }
+    }
+
+    void GatewaySendQueue::Run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopped) {
+            if (priority_queue.empty() && normal_queue.empty()) {
+                cv.wait(lock, [&] { return stopped || !priority_queue.empty() || !normal_queue.empty(); });
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            ForgetExpired(now);
+
+            // The normal lane has to leave the reserved commands for the priority lane.
+            std::deque<QueuedPayload>* queue = nullptr;
+            size_t limit = commands_per_window;
+            if (!priority_queue.empty()) {
+                queue = &priority_queue;
+            } else {
+                queue = &normal_queue;
+                limit -= reserved;
+            }
+
+            if (sent_at.size() >= limit) {
+                // The oldest command that has to leave the window before this one can go, wake up early if a
+                // priority payload is pushed since it might be able to go right away.
+                cv.wait_until(lock, sent_at[sent_at.size() - limit] + window);
+                continue;
+            }
+
+            QueuedPayload queued = std::move(queue->front());
+            queue->pop_front();
+
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(now - queued.queued_at);
+            total_wait += wait;
+            max_wait = std::max(max_wait, wait);
+            sent++;
+
+            lock.unlock();
+            send(queued.payload);
+            lock.lock();
+
+            // Counted from when the send finished, so no window can fit more commands than the limit no matter how
+            // long sending took.
+            sent_at.push_back(std::chrono::steady_clock::now());
+        }
+    }
+}
@@ -15,8 +15,11 @@ namespace discpp {
         *this = *globals::client_instance->cache.GetGuild(id, can_request);
 	}
 
-	Guild::Guild(rapidjson::Document& json) {
-		id = discpp::Snowflake(json["id"].GetString());
+	Guild::Guild(const rapidjson::Value& json) {
+        static const CachePolicies default_policies;
+        const CachePolicies& policies = globals::client_instance ? globals::client_instance->cache.policies : default_policies;
+
+		id = discpp::GetSnowflake(json["id"]);
         name = json["name"].GetString();
 
         if (ContainsNotNull(json, "icon")) {
@@ -51,30 +54,23 @@ namespace discpp {
 
 		if (ContainsNotNull(json, "roles")) {
 			for (auto const& role : json["roles"].GetArray()) {
-                rapidjson::Document role_json;
-                role_json.CopyFrom(role, role_json.GetAllocator());
-
-				discpp::Role tmp = discpp::Role(role_json);
+				discpp::Role tmp = discpp::Role(role);
 				roles.insert({ tmp.id, std::make_shared<discpp::Role>(tmp) });
 			}
 		}
 
         if (ContainsNotNull(json, "emojis")) {
-            for (auto const& emoji : json["emojis"].GetArray()) {
-                rapidjson::Document emoji_json;
-                emoji_json.CopyFrom(emoji, emoji_json.GetAllocator());
-
-                discpp::Emoji tmp = discpp::Emoji(emoji_json);
-                emojis.insert({ tmp.id, tmp });
+            if (policies.emojis.type != CachePolicyType::OFF) {
+                for (auto const& emoji : json["emojis"].GetArray()) {
+                    discpp::Emoji tmp = discpp::Emoji(emoji);
+                    if (policies.emojis.Allows(tmp, emojis.size())) emojis.insert({ tmp.id, tmp });
+                }
             }
         }
 
         if (ContainsNotNull(json, "features")) {
             for (auto const& feature : json["features"].GetArray()) {
-                rapidjson::Document feature_json;
-                feature_json.CopyFrom(feature, feature_json.GetAllocator());
-
-                features.push_back(feature_json.GetString());
+                features.push_back(feature.GetString());
             }
         }
 
@@ -95,21 +91,17 @@ namespace discpp {
 		member_count = GetDataSafely<int>(json, "member_count");
 
         if (ContainsNotNull(json, "voice_states")) {
-            for (auto const& voice_state : json["voice_states"].GetArray()) {
-                rapidjson::Document voice_state_json;
-                voice_state_json.CopyFrom(voice_state, voice_state_json.GetAllocator());
-
-                discpp::VoiceState tmp(voice_state_json);
-                voice_states.push_back(tmp);
+            if (policies.voice_states.type != CachePolicyType::OFF) {
+                for (auto const& voice_state : json["voice_states"].GetArray()) {
+                    discpp::VoiceState tmp(voice_state);
+                    if (policies.voice_states.Allows(tmp, voice_states.size())) voice_states.push_back(tmp);
+                }
             }
         }
 
         if (ContainsNotNull(json, "channels")) {
             for (auto const& channel : json["channels"].GetArray()) {
-                rapidjson::Document channel_json;
-                channel_json.CopyFrom(channel, channel_json.GetAllocator());
-
-                discpp::Channel tmp(channel_json);
+                discpp::Channel tmp(channel);
                 tmp.guild_id = id;
                 channels.insert({ tmp.id, tmp });
             }
@@ -135,36 +127,50 @@ namespace discpp {
 		preferred_locale = json["preferred_locale"].GetString();
 
 		if (ContainsNotNull(json, "public_updates_channel_id")) {
-		    auto channel = channels.find(Snowflake(json["public_updates_channel_id"].GetString()));
+		    auto channel = channels.find(discpp::GetSnowflake(json["public_updates_channel_id"]));
 		    if (channel != channels.end()) {
                 public_updates_channel = channel->second;
 		    }
         }
 
         if (ContainsNotNull(json, "members")) {
+            Snowflake bot_id = globals::client_instance ? globals::client_instance->client_user.id : Snowflake();
+            size_t member_presences = 0;
+
             for (auto const& member : json["members"].GetArray()) {
-                rapidjson::Document member_json;
-                member_json.CopyFrom(member, member_json.GetAllocator());
+                // Permission checks need the bot's own member, so it's cached no matter the policy. Other members
+                // aren't even parsed when members aren't cached, they're most of a large guild's payload.
+                bool is_bot = discpp::GetSnowflake(member["user"]["id"]) == bot_id;
+                if (!is_bot && policies.members.type == CachePolicyType::OFF) continue;
+
+                discpp::Member tmp(member, *this);
+                if (!is_bot && !policies.members.Allows(tmp, members->Size())) continue;
+
+                if (tmp.presence) {
+                    if (policies.presences.Allows(*tmp.presence, member_presences)) {
+                        member_presences++;
+                    } else {
+                        tmp.presence = nullptr;
+                    }
+                }
 
-                discpp::Member tmp(member_json, *this);
-                members.insert({ tmp.user.id, std::make_shared<discpp::Member>(tmp)});
+                members->Insert(tmp.user.id, std::make_shared<discpp::Member>(tmp));
             }
-        }
-
-		if (ContainsNotNull(json, "presences") && ContainsNotNull(json, "members")) {
-            for (auto const& presence : json["presences"].GetArray()) {
-                rapidjson::Document presence_json;
-                presence_json.CopyFrom(presence, presence_json.GetAllocator());
-
-                auto it = members.find(discpp::Snowflake(presence_json["user"]["id"].GetString()));
 
-                if (it != members.end()) {
-                    rapidjson::Document activity_json;
-                    if (ContainsNotNull(json, "game")) {
-                        activity_json.CopyFrom(json["game"], activity_json.GetAllocator());
-                    }
-
-                    it->second->presence = std::make_unique<discpp::Presence>(presence_json);
+            if (ContainsNotNull(json, "presences") && policies.presences.type != CachePolicyType::OFF) {
+                for (auto const& presence : json["presences"].GetArray()) {
+                    // The guild is still being made, so nothing else has its members yet.
+                    members->Update(discpp::GetSnowflake(presence["user"]["id"]), [&](std::shared_ptr<discpp::Member>& member) {
+                        auto tmp = std::make_unique<discpp::Presence>(presence);
+                        if (!member->presence) {
+                            if (!policies.presences.Allows(*tmp, member_presences)) return;
+                            member_presences++;
+                        } else if (!policies.presences.Allows(*tmp)) {
+                            return;
+                        }
+
+                        member->presence = std::move(tmp);
+                    });
                 }
             }
 		}
@@ -184,10 +190,7 @@ namespace discpp {
 
         for (auto const &channel : result->GetArray()) {
             if (!channel.IsNull()) {
-                rapidjson::Document channel_json;
-                channel_json.CopyFrom(channel, channel_json.GetAllocator());
-
-                discpp::Channel guild_channel(channel_json);
+                discpp::Channel guild_channel(channel);
                 channels.insert({guild_channel.id, guild_channel});
             }
         }
@@ -295,15 +298,14 @@ namespace discpp {
 	    if (id == 0) {
 			throw exceptions::DiscordObjectNotFound("Member id: " + std::to_string(id) + " is not valid!");
 		} else {
-            auto it = members.find(id);
-            if (it != members.end()) {
-                member = it->second;
+            if (std::optional<std::shared_ptr<discpp::Member>> cached = members->Get(id)) {
+                member = *cached;
             } else {
                 if (can_request) {
                     std::unique_ptr<rapidjson::Document> result = SendGetRequest(Endpoint("/guilds/" + std::to_string(this->id) + "/members/"+ std::to_string(id)), DefaultHeaders(), id, RateLimitBucketType::CHANNEL);
 
                     member = std::make_shared<discpp::Member>(*result, this->id);
-                    members.emplace(member->user.id, member);
+                    members->Insert(member->user.id, member);
                 } else {
                     throw exceptions::DiscordObjectNotFound("Member not found of id: " + std::to_string(id));
                 }
@@ -350,16 +352,12 @@ namespace discpp {
 		std::vector<discpp::GuildBan> guild_bans;
         for (auto const& guild_ban : result->GetArray()) {
             if (!guild_ban.IsNull()) {
-                rapidjson::Document guild_ban_json(rapidjson::kObjectType);
-                guild_ban_json.CopyFrom(guild_ban, guild_ban_json.GetAllocator());
-
                 std::string reason;
-                if (ContainsNotNull(guild_ban_json, "reason")) {
-                    reason = guild_ban_json["reason"].GetString();
+                if (ContainsNotNull(guild_ban, "reason")) {
+                    reason = guild_ban["reason"].GetString();
                 }
 
-                rapidjson::Document user_json(rapidjson::kObjectType);
-                user_json.CopyFrom(guild_ban_json["user"], user_json.GetAllocator());
+                const rapidjson::Value& user_json = guild_ban["user"];
                 std::shared_ptr<discpp::User> user = std::make_shared<discpp::User>(user_json);
 
                 guild_bans.push_back(discpp::GuildBan(reason, user));
@@ -506,10 +504,7 @@ namespace discpp {
         std::vector<discpp::GuildInvite> guild_invites;
         for (auto const& guild_invite : result->GetArray()) {
             if (!guild_invite.IsNull()) {
-                rapidjson::Document guild_invite_json;
-                guild_invite_json.CopyFrom(guild_invite, guild_invite_json.GetAllocator());
-
-                guild_invites.push_back(discpp::GuildInvite(guild_invite_json));
+                guild_invites.push_back(discpp::GuildInvite(guild_invite));
             }
         }
         return guild_invites;
@@ -521,10 +516,7 @@ namespace discpp {
         std::vector<discpp::Integration> guild_integrations;
         for (auto const& guild_integration : result->GetArray()) {
             if (!guild_integration.IsNull()) {
-                rapidjson::Document guild_integration_json;
-                guild_integration_json.CopyFrom(guild_integration, guild_integration_json.GetAllocator());
-
-                guild_integrations.push_back(discpp::Integration(guild_integration_json));
+                guild_integrations.push_back(discpp::Integration(guild_integration));
             }
         }
         return guild_integrations;
@@ -596,15 +588,13 @@ namespace discpp {
         std::unordered_map<Snowflake, Emoji> emojis;
         for (auto const& emoji : result->GetArray()) {
             if (!emoji.IsNull()) {
-                rapidjson::Document emoji_json;
-                emoji_json.CopyFrom(emoji, emoji_json.GetAllocator());
-
-                discpp::Emoji tmp = discpp::Emoji(emoji_json);
+                discpp::Emoji tmp = discpp::Emoji(emoji);
                 emojis.insert({ tmp.id, tmp });
             }
         }
 
-        this->emojis = emojis;
+        this->emojis.clear();
+        this->emojis.insert(emojis.begin(), emojis.end());
 	    return emojis;
 	}
 
@@ -811,6 +801,15 @@ namespace discpp {
         return (flags & 0b10000) == 0b10000;
     }
 
+    void Guild::KeepCachedObjects(const discpp::Guild& cached) {
+        channels = cached.channels;
+        members = cached.members;
+        voice_states = cached.voice_states;
+        joined_at = cached.joined_at;
+        member_count = cached.member_count;
+        flags = (flags & ~0b11000) | (cached.flags & 0b11000);
+    }
+
     std::string Guild::GetBannerURL(const ImageType &img_type) const {
         std::string banner_str = CombineAvatarHash(banner_hex);
 
@@ -890,20 +889,18 @@ namespace discpp {
         return std::chrono::system_clock::from_time_t(TimeFromSnowflake(id));
     }
 
-    GuildInvite::GuildInvite(rapidjson::Document &json) {
+    GuildInvite::GuildInvite(const rapidjson::Value& json) {
         code = json["code"].GetString();
         if (ContainsNotNull(json, "guild")) {
-            guild = discpp::globals::client_instance->cache.GetGuild(discpp::Snowflake(json["guild"]["id"].GetString()));
+            guild = discpp::globals::client_instance->cache.GetGuild(discpp::GetSnowflake(json["guild"]["id"]));
         }
-        channel = discpp::Channel(guild->GetChannel(Snowflake(json["channel"]["id"].GetString())));
+        channel = discpp::Channel(guild->GetChannel(discpp::GetSnowflake(json["channel"]["id"])));
         if (ContainsNotNull(json, "inviter")) {
-            rapidjson::Document inviter_json;
-            inviter_json.CopyFrom(json["inviter"], inviter_json.GetAllocator());
+            const rapidjson::Value& inviter_json = json["inviter"];
             inviter = std::make_shared<discpp::User>(inviter_json);
         }
         if (ContainsNotNull(json, "target_user")) {
-            rapidjson::Document target_json;
-            target_json.CopyFrom(json["target_user"], target_json.GetAllocator());
+            const rapidjson::Value& target_json = json["target_user"];
             target_user = std::make_shared<discpp::User>(target_json);
         }
         target_user_type = static_cast<TargetUserType>(GetDataSafely<int>(json, "target_user_type"));
@@ -911,13 +908,12 @@ namespace discpp {
         approximate_member_count = GetDataSafely<int>(json, "approximate_member_count");
     }
 
-    VoiceState::VoiceState(rapidjson::Document &json) {
+    VoiceState::VoiceState(const rapidjson::Value& json) {
 		guild_id = GetIDSafely(json, "guild_id");
 		channel_id = GetIDSafely(json, "channel_id");
-		user_id = discpp::Snowflake(json["user_id"].GetString());
+		user_id = discpp::GetSnowflake(json["user_id"]);
 		if (ContainsNotNull(json, "member")) {
-			rapidjson::Document member_json;
-			member_json.CopyFrom(json["member"], member_json.GetAllocator());
+			const rapidjson::Value& member_json = json["member"];
 
 			discpp::Guild guild(guild_id);
 			member = std::make_shared<discpp::Member>(member_json, guild);
@@ -931,19 +927,18 @@ namespace discpp {
 		suppress = json["suppress"].GetBool();
     }
 
-    Integration::Integration(rapidjson::Document &json) {
-        id = Snowflake(json["id"].GetString());
+    Integration::Integration(const rapidjson::Value& json) {
+        id = discpp::GetSnowflake(json["id"]);
         name = json["name"].GetString();
         type = json["type"].GetString();
         enabled = json["enabled"].GetBool();
         syncing = json["syncing"].GetBool();
-        role_id = Snowflake(json["role_id"].GetString());
+        role_id = discpp::GetSnowflake(json["role_id"]);
         enable_emoticons = GetDataSafely<bool>(json, "enable_emoticons");
         expire_behavior = static_cast<IntegrationExpireBehavior>(json["expire_behavior"].GetInt());
         expire_grace_period = json["expire_grace_period"].GetInt();
         if (ContainsNotNull(json, "user")) {
-            rapidjson::Document user_json;
-            user_json.CopyFrom(json["user"], user_json.GetAllocator());
+            const rapidjson::Value& user_json = json["user"];
 
             user = std::make_shared<discpp::User>(user_json);
         }
@@ -0,0 +1,30 @@
+#include "identify_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace discpp {
+    BucketIdentifyScheduler::BucketIdentifyScheduler(std::chrono::milliseconds interval) : interval(interval), next_identify(1) {
+
+    }
+
+    void BucketIdentifyScheduler::SetMaxConcurrency(int max_concurrency) {
+        std::lock_guard<std::mutex> lock(mutex);
+        next_identify.assign(std::max(max_concurrency, 1), std::chrono::steady_clock::time_point());
+    }
+
+    void BucketIdentifyScheduler::AwaitIdentify(int shard_id) {
+        std::this_thread::sleep_until(*ReserveIdentify(shard_id));
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> BucketIdentifyScheduler::ReserveIdentify(int shard_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Reserve the bucket's next slot so shards waiting on the same bucket queue up behind each other.
+        auto& bucket = next_identify[shard_id % next_identify.size()];
+        std::chrono::steady_clock::time_point identify_at = std::max(bucket, std::chrono::steady_clock::now());
+        bucket = identify_at + interval;
+
+        return identify_at;
+    }
+}
@@ -0,0 +1,47 @@
+#include "intents.h"
+#include "event_handler.h"
+#include "events/all_discord_events.h"
+
+namespace discpp {
+    GatewayIntents SuggestIntents() {
+        GatewayIntents intents = GatewayIntents::GUILDS | GatewayIntents::GUILD_MESSAGES | GatewayIntents::DIRECT_MESSAGES;
+
+        if (HasListeners<GuildMemberAddEvent, GuildMemberUpdateEvent, GuildMemberRemoveEvent>()) {
+            intents |= GatewayIntents::GUILD_MEMBERS;
+        }
+
+        if (HasListeners<GuildBanAddEvent, GuildBanRemoveEvent>()) {
+            intents |= GatewayIntents::GUILD_BANS;
+        }
+
+        if (HasListeners<GuildEmojisUpdateEvent>()) {
+            intents |= GatewayIntents::GUILD_EMOJIS;
+        }
+
+        if (HasListeners<GuildIntegrationsUpdateEvent>()) {
+            intents |= GatewayIntents::GUILD_INTEGRATIONS;
+        }
+
+        if (HasListeners<WebhooksUpdateEvent>()) {
+            intents |= GatewayIntents::GUILD_WEBHOOKS;
+        }
+
+        if (HasListeners<VoiceStateUpdateEvent>()) {
+            intents |= GatewayIntents::GUILD_VOICE_STATES;
+        }
+
+        if (HasListeners<PresenseUpdateEvent>()) {
+            intents |= GatewayIntents::GUILD_PRESENCES;
+        }
+
+        if (HasListeners<MessageReactionAddEvent, MessageReactionRemoveEvent, MessageReactionRemoveAllEvent>()) {
+            intents |= GatewayIntents::GUILD_MESSAGE_REACTIONS | GatewayIntents::DIRECT_MESSAGE_REACTIONS;
+        }
+
+        if (HasListeners<TypingStartEvent>()) {
+            intents |= GatewayIntents::GUILD_MESSAGE_TYPING | GatewayIntents::DIRECT_MESSAGE_TYPING;
+        }
+
+        return intents;
+    }
+}
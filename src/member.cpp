@@ -10,17 +10,14 @@ namespace discpp {
 		*this = *guild.GetMember(id, can_request);
 	}
 
-	Member::Member(rapidjson::Document& json, const discpp::Guild& guild) : guild_id(guild.id) {
+	Member::Member(const rapidjson::Value& json, const discpp::Guild& guild) : guild_id(guild.id) {
 		user = ConstructDiscppObjectFromJson(json, "user", discpp::User());
 		nick = GetDataSafely<std::string>(json, "nick");
 
         int highest_hiearchy = 0;
 		if (ContainsNotNull(json, "roles")) {
 			for (auto& role : json["roles"].GetArray()) {
-				rapidjson::Document role_json;
-				role_json.CopyFrom(role, role_json.GetAllocator());
-
-				auto tmp = guild.GetRole(discpp::Snowflake(role_json.GetString()));
+				auto tmp = guild.GetRole(discpp::GetSnowflake(role));
 				if (tmp) {
                     std::shared_ptr<discpp::Role> r = tmp;
                     if (r->position > highest_hiearchy) {
@@ -40,8 +37,7 @@ namespace discpp {
             flags |= 0b10;
 		}
 		if (discpp::ContainsNotNull(json, "presence")) {
-            rapidjson::Document json_presence;
-            json_presence.CopyFrom(json["presence"], json_presence.GetAllocator());
+            const rapidjson::Value& json_presence = json["presence"];
 
             presence = std::make_unique<discpp::Presence>(json_presence);
 		}
@@ -11,9 +11,16 @@ namespace discpp {
         *this = globals::client_instance->cache.GetDiscordMessage(channel_id, id, can_request);
 	}
 
-	Message::Message(rapidjson::Document& json) {
+	Message::Message(const rapidjson::Value& json) {
 		id = GetIDSafely(json, "id");
-        channel = globals::client_instance->cache.GetChannel(discpp::Snowflake(json["channel_id"].GetString()));
+        Snowflake channel_id = discpp::GetSnowflake(json["channel_id"]);
+        if (std::optional<discpp::Channel> cached_channel = globals::client_instance->cache.FindChannel(channel_id)) {
+            channel = std::move(*cached_channel);
+        } else {
+            // Messages in channels that aren't cached, like DMs when they aren't cached, still get the channel's ids.
+            channel.id = channel_id;
+            channel.guild_id = GetIDSafely(json, "guild_id");
+        }
 		try {
             guild = channel.GetGuild();
         } catch (const exceptions::DiscordObjectNotFound&) {
@@ -26,16 +33,19 @@ namespace discpp {
                     auto mbr = guild->GetMember(author.id);
                     member = mbr;
                 } catch (const exceptions::DiscordObjectNotFound&) {
-                    rapidjson::Document doc(rapidjson::kObjectType);
-                    doc.CopyFrom(json["member"], doc.GetAllocator());
+                    const rapidjson::Value& doc = json["member"];
 
                     // Since the member isn't cached, create it.
                     auto mbr = std::make_shared<discpp::Member>(discpp::Member(doc, *guild));
                     mbr->user = author;
                     member = mbr;
 
-                    // Add the new member into cache since it isn't already.
-                    guild->members.emplace(id, mbr);
+                    // Add the new member into cache since it isn't already, the bound counts the guild's members.
+                    Cache& cache = globals::client_instance->cache;
+                    if (cache.policies.members.Allows(*mbr, guild->members->Size()) && guild->members->Insert(author.id, mbr)) {
+                        cache.members.Insert(author.id, mbr);
+                        cache.member_expiry.Touch(guild->id, author.id);
+                    }
                 }
             }
         }
@@ -54,57 +64,39 @@ namespace discpp {
 		}
 		if (ContainsNotNull(json, "mentions")) {
             for (auto const& mention : json["mentions"].GetArray()) {
-                rapidjson::Document mention_json(rapidjson::kObjectType);
-                mention_json.CopyFrom(mention, mention_json.GetAllocator());
-
-                discpp::User tmp = discpp::User(mention_json);
+                discpp::User tmp = discpp::User(mention);
                 mentions.insert({ tmp.id, tmp });
             }
         }
 
         if (ContainsNotNull(json, "mention_roles")) {
             for (auto const& mentioned_role : json["mention_roles"].GetArray()) {
-                rapidjson::Document mentioned_role_json;
-                mentioned_role_json.CopyFrom(mentioned_role, mentioned_role_json.GetAllocator());
-
-                mentioned_roles.push_back(discpp::Snowflake(mentioned_role_json.GetString()));
+                mentioned_roles.push_back(discpp::GetSnowflake(mentioned_role));
             }
         }
 
         if (ContainsNotNull(json, "mention_channels")) {
             for (auto const& mention_channel : json["mention_channels"].GetArray()) {
-                rapidjson::Document mention_channel_json;
-                mention_channel_json.CopyFrom(mention_channel, mention_channel_json.GetAllocator());
-
-                discpp::Message::ChannelMention channel_mention(mention_channel_json);
-                mention_channels.emplace(channel_mention.id, mention_channel_json);
+                discpp::Message::ChannelMention channel_mention(mention_channel);
+                mention_channels.emplace(channel_mention.id, mention_channel);
             }
         }
 
         if (ContainsNotNull(json, "attachments")) {
             for (auto const& attachment : json["attachments"].GetArray()) {
-                rapidjson::Document attachment_json;
-                attachment_json.CopyFrom(attachment, attachment_json.GetAllocator());
-
-                attachments.push_back(discpp::Attachment(attachment_json));
+                attachments.push_back(discpp::Attachment(attachment));
             }
         }
 
         if (ContainsNotNull(json, "embeds")) {
             for (auto const& embed : json["embeds"].GetArray()) {
-                rapidjson::Document embed_json;
-                embed_json.CopyFrom(embed, embed_json.GetAllocator());
-
-                embeds.push_back(discpp::EmbedBuilder(embed_json));
+                embeds.push_back(discpp::EmbedBuilder(embed));
             }
         }
 
         if (ContainsNotNull(json, "reactions")) {
             for (auto const& reaction : json["reactions"].GetArray()) {
-                rapidjson::Document reaction_json;
-                reaction_json.CopyFrom(reaction, reaction_json.GetAllocator());
-
-                discpp::Reaction tmp(reaction_json);
+                discpp::Reaction tmp(reaction);
                 reactions.push_back(tmp);
             }
         }
@@ -157,7 +149,7 @@ namespace discpp {
 		std::unique_ptr<rapidjson::Document> result = SendGetRequest(endpoint, DefaultHeaders(), channel.id, RateLimitBucketType::CHANNEL, body);
 		
 		std::unordered_map<discpp::Snowflake, discpp::User> users;
-		IterateThroughNotNullJson(*result, [&](rapidjson::Document& user_json) {
+		IterateThroughNotNullJson(*result, [&](const rapidjson::Value& user_json) {
 		    discpp::User tmp(user_json);
 		    users.insert({ tmp.id, tmp });
 		});
@@ -173,7 +165,7 @@ namespace discpp {
 		std::unique_ptr<rapidjson::Document> result = SendGetRequest(endpoint, DefaultHeaders(), channel.id, RateLimitBucketType::CHANNEL, body);
 
         std::unordered_map<discpp::Snowflake, discpp::User> users;
-        IterateThroughNotNullJson(*result, [&](rapidjson::Document& user_json) {
+        IterateThroughNotNullJson(*result, [&](const rapidjson::Value& user_json) {
             discpp::User tmp(user_json);
             users.insert({ tmp.id, tmp });
         });
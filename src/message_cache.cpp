@@ -0,0 +1,186 @@
+#include "message_cache.h"
+#include "message.h"
+
+namespace discpp {
+    MessageCache::MessageCache(size_t capacity, size_t channel_capacity) : capacity(capacity), channel_capacity(channel_capacity) {
+
+    }
+
+    void MessageCache::SetCapacity(size_t capacity, size_t channel_capacity) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        this->capacity = capacity;
+        this->channel_capacity = channel_capacity;
+
+        std::vector<Snowflake> emptied;
+        for (auto& channel : channels) {
+            while (channel.second.messages.size() > channel_capacity) {
+                PopFront(channel.second);
+            }
+
+            if (channel.second.messages.empty()) emptied.push_back(channel.first);
+        }
+
+        for (const Snowflake& channel_id : emptied) {
+            RemoveIfEmpty(channel_id);
+        }
+
+        while (size > capacity) {
+            DropOldest();
+        }
+    }
+
+    void MessageCache::Insert(std::shared_ptr<Message> message) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (capacity == 0 || channel_capacity == 0) return;
+
+        if (std::shared_ptr<Message>* cached = Find(message->id)) {
+            *cached = std::move(message);
+            return;
+        }
+
+        Snowflake channel_id = message->channel.id;
+        auto result = channels.try_emplace(channel_id);
+        ChannelMessages& channel = result.first->second;
+        if (result.second) {
+            recent_channels.push_front(channel_id);
+            channel.recent = recent_channels.begin();
+        } else {
+            recent_channels.splice(recent_channels.begin(), recent_channels, channel.recent);
+        }
+
+        while (channel.messages.size() >= channel_capacity) {
+            PopFront(channel);
+        }
+
+        index[message->id] = Location{ channel_id, channel.first_position + channel.messages.size() };
+        channel.messages.push_back(std::move(message));
+        size++;
+
+        // The channel that just received a message is the most recent one, so it's only dropped from if it's the
+        // only channel, and then its new message isn't the oldest.
+        while (size > capacity) {
+            DropOldest();
+        }
+    }
+
+    std::shared_ptr<Message> MessageCache::Get(const Snowflake& id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        std::shared_ptr<Message>* cached = const_cast<MessageCache*>(this)->Find(id);
+        return cached ? *cached : nullptr;
+    }
+
+    bool MessageCache::Contains(const Snowflake& id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return index.find(id) != index.end();
+    }
+
+    std::shared_ptr<Message> MessageCache::Update(const Snowflake& id, const std::function<void(Message&)>& update) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        std::shared_ptr<Message>* cached = Find(id);
+        if (!cached) return nullptr;
+
+        auto updated = std::make_shared<Message>(**cached);
+        update(*updated);
+        *cached = updated;
+
+        return updated;
+    }
+
+    std::shared_ptr<Message> MessageCache::Erase(const Snowflake& id) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        auto location = index.find(id);
+        if (location == index.end()) return nullptr;
+
+        Snowflake channel_id = location->second.channel_id;
+        ChannelMessages& channel = channels.at(channel_id);
+        std::shared_ptr<Message>& slot = channel.messages[location->second.position - channel.first_position];
+
+        std::shared_ptr<Message> message = std::move(slot);
+        slot = nullptr;
+        index.erase(location);
+        size--;
+
+        // Only the ends can be trimmed, removed messages in between keep their place so positions stay valid.
+        while (!channel.messages.empty() && !channel.messages.front()) {
+            channel.messages.pop_front();
+            channel.first_position++;
+        }
+        while (!channel.messages.empty() && !channel.messages.back()) {
+            channel.messages.pop_back();
+        }
+        RemoveIfEmpty(channel_id);
+
+        return message;
+    }
+
+    std::vector<std::shared_ptr<Message>> MessageCache::GetChannelMessages(const Snowflake& channel_id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        std::vector<std::shared_ptr<Message>> messages;
+
+        auto channel = channels.find(channel_id);
+        if (channel == channels.end()) return messages;
+
+        for (const auto& message : channel->second.messages) {
+            if (message) messages.push_back(message);
+        }
+
+        return messages;
+    }
+
+    size_t MessageCache::Size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return size;
+    }
+
+    void MessageCache::Clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        channels.clear();
+        index.clear();
+        recent_channels.clear();
+        size = 0;
+    }
+
+    std::shared_ptr<Message>* MessageCache::Find(const Snowflake& id) {
+        auto location = index.find(id);
+        if (location == index.end()) return nullptr;
+
+        ChannelMessages& channel = channels.at(location->second.channel_id);
+        return &channel.messages[location->second.position - channel.first_position];
+    }
+
+    void MessageCache::PopFront(ChannelMessages& channel) {
+        if (const std::shared_ptr<Message>& front = channel.messages.front()) {
+            index.erase(front->id);
+            size--;
+        }
+        channel.messages.pop_front();
+        channel.first_position++;
+
+        // Keep a message at the front, so dropping the oldest message doesn't have to look for it.
+        while (!channel.messages.empty() && !channel.messages.front()) {
+            channel.messages.pop_front();
+            channel.first_position++;
+        }
+    }
+
+    void MessageCache::DropOldest() {
+        Snowflake channel_id = recent_channels.back();
+
+        PopFront(channels.at(channel_id));
+        RemoveIfEmpty(channel_id);
+    }
+
+    void MessageCache::RemoveIfEmpty(const Snowflake& channel_id) {
+        auto channel = channels.find(channel_id);
+        if (channel == channels.end() || !channel->second.messages.empty()) return;
+
+        recent_channels.erase(channel->second.recent);
+        channels.erase(channel);
+    }
+}
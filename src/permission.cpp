@@ -6,8 +6,8 @@ namespace discpp {
 		allow_perms = PermissionOverwrite(byte_set);
 	}
 
-	Permissions::Permissions(rapidjson::Document& json) {
-		role_user_id = discpp::Snowflake(json["id"].GetString());
+	Permissions::Permissions(const rapidjson::Value& json) {
+		role_user_id = discpp::GetSnowflake(json["id"]);
 		permission_type = (json["type"] == "role") ? PermissionType::ROLE : PermissionType::MEMBER;
 		allow_perms = PermissionOverwrite(json["allow"].GetInt());
 		deny_perms = PermissionOverwrite(json["deny"].GetInt());
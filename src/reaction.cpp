@@ -1,10 +1,10 @@
 #include "reaction.h"
 
 namespace discpp {
-	Reaction::Reaction(rapidjson::Document& json) {
+	Reaction::Reaction(const rapidjson::Value& json) {
 		count = json["count"].GetInt();
 		from_bot = json["me"].GetBool();
 
-		emoji = discpp::Emoji(*GetDocumentInsideJson(json, "emoji"));
+		emoji = discpp::Emoji(json["emoji"]);
 	}
 }
\ No newline at end of file
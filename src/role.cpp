@@ -9,8 +9,8 @@ namespace discpp {
 		}
 	}
 
-	Role::Role(rapidjson::Document& json) {
-		id = discpp::Snowflake(json["id"].GetString());
+	Role::Role(const rapidjson::Value& json) {
+		id = discpp::GetSnowflake(json["id"]);
 		name = json["name"].GetString();
 		color = json["color"].GetInt();
         if (GetDataSafely<bool>(json, "hoist")) {
@@ -0,0 +1,108 @@
+#include "session_store.h"
+#include "utils.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace discpp {
+    FileSessionStore::FileSessionStore(std::string path, std::chrono::milliseconds write_interval) : path(std::move(path)), write_interval(write_interval) {
+
+    }
+
+    // The file is a json object of shard id to session, a missing or corrupt file is treated as empty.
+    static rapidjson::Document ReadSessions(const std::string& path) {
+        rapidjson::Document sessions(rapidjson::kObjectType);
+
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (file.is_open()) {
+            std::stringstream contents;
+            contents << file.rdbuf();
+
+            sessions.Parse(contents.str());
+            if (sessions.HasParseError() || !sessions.IsObject()) {
+                sessions.SetObject();
+            }
+        }
+
+        return sessions;
+    }
+
+    std::optional<ShardSession> FileSessionStore::Load(int shard_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto unwritten_session = unwritten.find(shard_id);
+        if (unwritten_session != unwritten.end()) return unwritten_session->second;
+
+        rapidjson::Document sessions = ReadSessions(path);
+        std::string key = std::to_string(shard_id);
+
+        rapidjson::Value::ConstMemberIterator itr = sessions.FindMember(key);
+        if (itr == sessions.MemberEnd() || !itr->value.IsObject() || !ContainsNotNull(itr->value, "session_id")) {
+            return std::nullopt;
+        }
+
+        ShardSession session;
+        session.shard_id = shard_id;
+        session.session_id = itr->value["session_id"].GetString();
+        session.sequence = GetDataSafely<int>(itr->value, "seq");
+        session.gateway_url = GetDataSafely<std::string>(itr->value, "gateway_url");
+
+        return session;
+    }
+
+    void FileSessionStore::Save(const ShardSession& session) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        unwritten[session.shard_id] = session;
+        if (std::chrono::steady_clock::now() - last_write >= write_interval) {
+            Write();
+        }
+    }
+
+    void FileSessionStore::Flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!unwritten.empty()) {
+            Write();
+        }
+    }
+
+    void FileSessionStore::Write() {
+        // Sessions that aren't saved by this process are kept, other processes may run the other shards.
+        rapidjson::Document sessions = ReadSessions(path);
+        rapidjson::Document::AllocatorType& allocator = sessions.GetAllocator();
+
+        for (const auto& [shard_id, session] : unwritten) {
+            rapidjson::Value value(rapidjson::kObjectType);
+            value.AddMember("session_id", session.session_id, allocator);
+            value.AddMember("seq", session.sequence, allocator);
+            value.AddMember("gateway_url", session.gateway_url, allocator);
+
+            std::string key = std::to_string(shard_id);
+            rapidjson::Value::MemberIterator itr = sessions.FindMember(key);
+            if (itr != sessions.MemberEnd()) {
+                itr->value = value;
+            } else {
+                rapidjson::Value name(key, allocator);
+                sessions.AddMember(name, value, allocator);
+            }
+        }
+
+        // Write to a temporary file first so a crash while saving can't leave a half written file behind.
+        std::string temp_path = path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+            file << DumpJson(sessions);
+        }
+
+        // Windows won't rename over an existing file.
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            std::remove(path.c_str());
+            std::rename(temp_path.c_str(), path.c_str());
+        }
+
+        unwritten.clear();
+        last_write = std::chrono::steady_clock::now();
+    }
+}
@@ -1,7 +1,7 @@
 #include "settings.h"
 
 namespace discpp {
-	FriendSource::FriendSource(rapidjson::Document& json) {
+	FriendSource::FriendSource(const rapidjson::Value& json) {
 		if (GetDataSafely<bool>(json, "all")) flags |= (unsigned int) FriendSourceFlags::ALL;
 		if (GetDataSafely<bool>(json, "mutual_friends")) flags |= (unsigned int) FriendSourceFlags::MUTUAL_FRIENDS;
 		if (GetDataSafely<bool>(json, "mutual_guilds")) flags |= (unsigned int) FriendSourceFlags::MUTUAL_GUILDS;
@@ -43,7 +43,7 @@ namespace discpp {
 		return (this->flags & (unsigned int)FriendSourceFlags::MUTUAL_GUILDS) == (unsigned int)FriendSourceFlags::MUTUAL_GUILDS;
 	}
 
-	ClientUserSettings::ClientUserSettings(rapidjson::Document& json) {
+	ClientUserSettings::ClientUserSettings(const rapidjson::Value& json) {
 		locale = StringToLocale(GetDataSafely<std::string>(json, "locale"));
 		status = GetDataSafely<std::string>(json, "status");
 		custom_status = GetDataSafely<std::string>(json, "custom_status");
@@ -53,13 +53,12 @@ namespace discpp {
 
 		if (ContainsNotNull(json, "guild_positions")) {
 			for (auto const& guild : json["guild_positions"].GetArray()) {
-				guild_positions.push_back(discpp::Snowflake(guild.GetString()));
+				guild_positions.push_back(discpp::GetSnowflake(guild));
 			}
 		}
 
 		explicit_content_filter = static_cast<discpp::ExplicitContentFilter>(json["explicit_content_filter"].GetInt());
-		rapidjson::Document friend_source_flags_json;
-		friend_source_flags_json.CopyFrom(json["friend_source_flags"], friend_source_flags_json.GetAllocator());
+		const rapidjson::Value& friend_source_flags_json = json["friend_source_flags"];
 		friend_source_flags = FriendSource(friend_source_flags_json);
 
 		if (GetDataSafely<bool>(json, "show_current_game")) flags |= (unsigned int) ClientUserSettingsFlags::SHOW_CURRENT_GAME;
@@ -0,0 +1,58 @@
+#include "strand.h"
+
+namespace discpp {
+    StrandExecutor::StrandExecutor(ThreadPool& pool, size_t batch_size) : pool(pool), batch_size(batch_size) {
+
+    }
+
+    void StrandExecutor::Post(uint64_t key, ThreadPool::Task task) {
+        bool schedule;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // A strand is in the map while it's scheduled on the pool, so only the first task needs to schedule it.
+            auto result = strands.try_emplace(key);
+            result.first->second.tasks.push_back(std::move(task));
+            schedule = result.second;
+        }
+
+        if (schedule) {
+            pool.Submit([this, key] { Drain(key); });
+        }
+    }
+
+    size_t StrandExecutor::GetStrandCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return strands.size();
+    }
+
+    void StrandExecutor::Drain(uint64_t key) {
+        for (size_t ran = 0; ; ran++) {
+            ThreadPool::Task task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                auto itr = strands.find(key);
+                if (itr->second.tasks.empty()) {
+                    strands.erase(itr);
+                    return;
+                }
+
+                if (ran == batch_size) break;
+
+                task = std::move(itr->second.tasks.front());
+                itr->second.tasks.pop_front();
+            }
+
+            try {
+                task();
+            } catch (...) {
+                // Keep the strand going and let the pool report the exception.
+                pool.Submit([this, key] { Drain(key); });
+                throw;
+            }
+        }
+
+        pool.Submit([this, key] { Drain(key); });
+    }
+}
@@ -0,0 +1,149 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace discpp {
+    // Lets Submit put tasks on the queue of the worker that submitted them.
+    static thread_local const ThreadPool* current_pool = nullptr;
+    static thread_local size_t current_worker = 0;
+
+    ThreadPool::ThreadPool(size_t worker_count, ErrorHandler error_handler) : error_handler(std::move(error_handler)) {
+        if (worker_count == 0) {
+            worker_count = std::max(2u, std::thread::hardware_concurrency());
+        }
+
+        workers.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+
+        // Only start the threads once every worker exists, they look at each other's queues.
+        for (size_t i = 0; i < worker_count; i++) {
+            workers[i]->thread = std::thread(&ThreadPool::WorkerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        Stop();
+    }
+
+    void ThreadPool::Submit(Task task) {
+        size_t index = current_pool == this ? current_worker : next_worker++ % workers.size();
+
+        // Holding the wake lock makes sure a worker that just found nothing to do is waiting before it's notified,
+        // and that the workers can't exit between checking if the pool is stopping and queueing the task.
+        {
+            std::lock_guard<std::mutex> wake_lock(wake_mutex);
+            if (stopping) return;
+
+            pending++;
+
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            queued++;
+            workers[index]->tasks.push_back(std::move(task));
+        }
+        wake_condition.notify_one();
+    }
+
+    void ThreadPool::WaitIdle() {
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle_condition.wait(lock, [this] { return pending == 0; });
+    }
+
+    void ThreadPool::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake_condition.notify_all();
+
+        // Detaching the worker instead would leave it running after the pool is destroyed.
+        if (current_pool == this) return;
+
+        std::lock_guard<std::mutex> lock(join_mutex);
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) worker->thread.join();
+        }
+    }
+
+    size_t ThreadPool::GetWorkerCount() const {
+        return workers.size();
+    }
+
+    ThreadPoolStats ThreadPool::GetStats() const {
+        ThreadPoolStats stats;
+        stats.workers = workers.size();
+        stats.queued = queued;
+        stats.running = running;
+        stats.completed = completed;
+        stats.stolen = stolen;
+
+        return stats;
+    }
+
+    void ThreadPool::WorkerLoop(size_t index) {
+        current_pool = this;
+        current_worker = index;
+
+        Task task;
+        while (true) {
+            if (TryPop(index, task)) {
+                RunTask(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake_condition.wait(lock, [this] { return stopping || queued > 0; });
+
+            // Queued tasks are still run when stopping.
+            if (stopping && queued == 0) return;
+        }
+    }
+
+    bool ThreadPool::TryPop(size_t index, Task& task) {
+        {
+            Worker& worker = *workers[index];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty()) {
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+
+        // Steal the newest task, the owner is working through the oldest ones.
+        for (size_t i = 1; i < workers.size(); i++) {
+            Worker& victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                queued--;
+                stolen++;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::RunTask(Task& task) {
+        running++;
+        try {
+            task();
+        } catch (...) {
+            if (error_handler) error_handler(std::current_exception());
+        }
+        running--;
+
+        // Release whatever the task captured before reporting it as finished.
+        task = nullptr;
+        completed++;
+
+        if (--pending == 0) {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            idle_condition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include "timer_queue.h"
+
+namespace discpp {
+    TimerQueue::TimerQueue() : thread(&TimerQueue::Loop, this) {
+
+    }
+
+    TimerQueue::~TimerQueue() {
+        Stop();
+    }
+
+    void TimerQueue::Add(std::chrono::milliseconds delay, Function function) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+
+            timers.emplace(std::chrono::steady_clock::now() + delay, std::move(function));
+        }
+        condition.notify_one();
+    }
+
+    void TimerQueue::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_one();
+
+        {
+            std::lock_guard<std::mutex> lock(join_mutex);
+            if (thread.joinable()) thread.join();
+        }
+
+        // The thread waits on the first timer's time, so they're only dropped once it's gone.
+        std::lock_guard<std::mutex> lock(mutex);
+        timers.clear();
+    }
+
+    void TimerQueue::Loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (timers.empty()) {
+                condition.wait(lock);
+                continue;
+            }
+
+            auto next = timers.begin();
+            if (next->first > std::chrono::steady_clock::now()) {
+                condition.wait_until(lock, next->first);
+                continue;
+            }
+
+            Function function = std::move(next->second);
+            timers.erase(next);
+
+            lock.unlock();
+            function();
+            lock.lock();
+        }
+    }
+}
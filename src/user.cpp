@@ -7,13 +7,12 @@
 
 namespace discpp {
 	User::User(const Snowflake& id) : discpp::DiscordObject(id) {
-		auto it = discpp::globals::client_instance->cache.members.find(id);
-		if (it != discpp::globals::client_instance->cache.members.end()) {
-			*this = it->second->user;
+		if (std::optional<std::shared_ptr<Member>> member = discpp::globals::client_instance->cache.members.Get(id)) {
+			*this = (*member)->user;
 		}
 	}
 
-	User::User(rapidjson::Document& json) {
+	User::User(const rapidjson::Value& json) {
 		id = GetIDSafely(json, "id");
 		username = GetDataSafely<std::string>(json, "username");
 		discriminator = (unsigned short) strtoul(GetDataSafely<std::string>(json, "discriminator").c_str(), nullptr, 10);
@@ -32,7 +31,7 @@ namespace discpp {
 		//public_flags = GetDataSafely<int>(json, "public_flags");
 	}
 
-	User::Connection::Connection(rapidjson::Document& json) {
+	User::Connection::Connection(const rapidjson::Value& json) {
 
 		id = json["id"].GetString();
 		name = json["name"].GetString();
@@ -43,9 +42,7 @@ namespace discpp {
 
 		if (itr != json.MemberEnd()) {
 			for (auto& integration : json["integrations"].GetArray()) {
-				rapidjson::Document integration_json;
-				integration_json.CopyFrom(integration, integration_json.GetAllocator());
-				integrations.push_back(discpp::Integration(integration_json));
+				integrations.push_back(discpp::Integration(integration));
 			}
 		}
 		verified = json["verified"].GetBool();
@@ -429,34 +429,24 @@ std::string discpp::FormatTime(const time_t& time, const std::string& format) {
     return buffer;
 }
 
-bool discpp::ContainsNotNull(rapidjson::Document &json, const char *value_name) {
+bool discpp::ContainsNotNull(const rapidjson::Value& json, const char *value_name) {
     rapidjson::Value::ConstMemberIterator itr = json.FindMember(value_name);
     if (itr != json.MemberEnd()) {
-        return !json[value_name].IsNull();
+        return !itr->value.IsNull();
     }
 
     return false;
 }
 
-void discpp::IterateThroughNotNullJson(rapidjson::Document &json, const std::function<void(rapidjson::Document&)>& func) {
+void discpp::IterateThroughNotNullJson(const rapidjson::Value& json, const std::function<void(const rapidjson::Value&)>& func) {
     for (auto const& object : json.GetArray()) {
         if (!object.IsNull()) {
-            rapidjson::Document object_json;
-            object_json.CopyFrom(object, object_json.GetAllocator());
-
-            func(object_json);
+            func(object);
         }
     }
 }
 
-std::unique_ptr<rapidjson::Document> discpp::GetDocumentInsideJson(rapidjson::Document &json, const char* value_name) {
-    auto inside_json = std::make_unique<rapidjson::Document>(json.GetType());
-    inside_json->CopyFrom(json[value_name], inside_json->GetAllocator());
-
-	return inside_json;
-}
-
-std::string discpp::DumpJson(rapidjson::Document &json) {
+std::string discpp::DumpJson(const rapidjson::Document &json) {
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     json.Accept(writer);
@@ -465,7 +455,7 @@ std::string discpp::DumpJson(rapidjson::Document &json) {
     return tmp;
 }
 
-std::string discpp::DumpJson(rapidjson::Value &json) {
+std::string discpp::DumpJson(const rapidjson::Value &json) {
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     json.Accept(writer);
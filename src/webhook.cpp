@@ -7,11 +7,11 @@
 #include <fstream>
 
 namespace discpp {
-    Webhook::Webhook(rapidjson::Document& json) {
-        id = discpp::Snowflake(json["id"].GetString());
+    Webhook::Webhook(const rapidjson::Value& json) {
+        id = discpp::GetSnowflake(json["id"]);
         type = static_cast<WebhookType>(json["type"].GetInt());
         guild = std::make_shared<discpp::Guild>(ConstructDiscppObjectFromID(json, "guild_id", discpp::Guild()));
-        channel = std::make_shared<discpp::Channel>(globals::client_instance->cache.GetChannel(discpp::Snowflake(json["guild_id"].GetString())));
+        channel = std::make_shared<discpp::Channel>(globals::client_instance->cache.GetChannel(discpp::GetSnowflake(json["guild_id"])));
 		user = std::make_shared<discpp::User>(ConstructDiscppObjectFromJson(json, "user", discpp::User()));
         name = GetDataSafely<std::string>(json, "name");
         if (ContainsNotNull(json, "avatar")) {
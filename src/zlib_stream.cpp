@@ -0,0 +1,83 @@
+#include "zlib_stream.h"
+#include "exceptions.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace discpp {
+    // Every complete zlib-stream message ends with this Z_SYNC_FLUSH suffix.
+    static constexpr char zlib_suffix[] = { '\x00', '\x00', '\xff', '\xff' };
+    static constexpr size_t inflate_chunk_size = 16 * 1024;
+
+    ZlibStream::ZlibStream() {
+        Reset();
+    }
+
+    ZlibStream::~ZlibStream() {
+        if (initialized) {
+            inflateEnd(&stream);
+        }
+    }
+
+    void ZlibStream::Reset() {
+        if (initialized) {
+            inflateEnd(&stream);
+        }
+
+        std::memset(&stream, 0, sizeof(stream));
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+        stream.opaque = Z_NULL;
+
+        if (inflateInit(&stream) != Z_OK) {
+            initialized = false;
+            throw exceptions::DecompressionException("Failed to initialize zlib inflate stream: " + std::string(stream.msg ? stream.msg : "unknown error"));
+        }
+
+        initialized = true;
+        pending.clear();
+    }
+
+    bool ZlibStream::Feed(const std::string& frame, std::string& out) {
+        pending.append(frame);
+
+        // Wait until we have received the full message.
+        if (pending.size() < sizeof(zlib_suffix) || std::memcmp(pending.data() + pending.size() - sizeof(zlib_suffix), zlib_suffix, sizeof(zlib_suffix)) != 0) {
+            return false;
+        }
+
+        stream.next_in = reinterpret_cast<Bytef*>(&pending[0]);
+        stream.avail_in = static_cast<uInt>(pending.size());
+
+        // Keep the output buffer's capacity between messages, only grow it when its needed.
+        out.resize(std::max(out.capacity(), inflate_chunk_size));
+        size_t total = 0;
+        while (true) {
+            if (out.size() - total < inflate_chunk_size) {
+                out.resize(out.size() * 2);
+            }
+
+            stream.next_out = reinterpret_cast<Bytef*>(&out[total]);
+            stream.avail_out = static_cast<uInt>(out.size() - total);
+
+            int result = inflate(&stream, Z_SYNC_FLUSH);
+            total = out.size() - stream.avail_out;
+
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                pending.clear();
+                out.clear();
+                throw exceptions::DecompressionException("Failed to inflate gateway payload: " + std::string(stream.msg ? stream.msg : std::to_string(result)));
+            }
+
+            // Z_BUF_ERROR just means there wasn't anything left to do.
+            if (stream.avail_in == 0 && stream.avail_out != 0) {
+                break;
+            }
+        }
+
+        out.resize(total);
+        pending.clear();
+
+        return true;
+    }
+}
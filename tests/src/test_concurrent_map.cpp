@@ -0,0 +1,102 @@
+#include <discpp/concurrent_map.h>
+#include <discpp/snowflake_map.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentMap, InsertDoesNotReplace) {
+	discpp::ConcurrentMap<int, std::string> map;
+
+	EXPECT_TRUE(map.Insert(1, "a"));
+	EXPECT_FALSE(map.Insert(1, "b"));
+	EXPECT_EQ("a", map.Get(1).value());
+
+	map.InsertOrAssign(1, "c");
+	EXPECT_EQ("c", map.Get(1).value());
+	EXPECT_TRUE(map.Contains(1));
+	EXPECT_FALSE(map.Get(2).has_value());
+}
+
+TEST(ConcurrentMap, UpdateAndErase) {
+	discpp::ConcurrentMap<int, int> map;
+	map.Insert(1, 10);
+
+	EXPECT_TRUE(map.Update(1, [](int& value) { value++; }));
+	EXPECT_FALSE(map.Update(2, [](int& value) { value++; }));
+	EXPECT_EQ(11, map.Get(1).value());
+	EXPECT_FALSE(map.Contains(2));
+
+	EXPECT_EQ(11, map.Erase(1).value());
+	EXPECT_FALSE(map.Erase(1).has_value());
+	EXPECT_EQ(0u, map.Size());
+}
+
+TEST(ConcurrentMap, ForEachSeesEveryStripe) {
+	discpp::ConcurrentMap<discpp::Snowflake, int, discpp::SnowflakeMap<int>> map;
+	for (int i = 0; i < 1000; i++) {
+		map.Insert(discpp::Snowflake(static_cast<uint64_t>(i) << 22), i);
+	}
+	EXPECT_EQ(1000u, map.Size());
+
+	int sum = 0;
+	map.ForEach([&](const discpp::Snowflake& key, const int& value) {
+		EXPECT_EQ(static_cast<uint64_t>(value) << 22, static_cast<uint64_t>(key));
+		sum += value;
+	});
+	EXPECT_EQ(999 * 1000 / 2, sum);
+
+	std::vector<int> values = map.Values();
+	std::sort(values.begin(), values.end());
+	ASSERT_EQ(1000u, values.size());
+	EXPECT_EQ(0, values.front());
+	EXPECT_EQ(999, values.back());
+
+	map.Clear();
+	EXPECT_EQ(0u, map.Size());
+}
+
+TEST(ConcurrentMap, SingleStripe) {
+	discpp::ConcurrentMap<int, int, std::unordered_map<int, int>, 1> map;
+	for (int i = 0; i < 100; i++) {
+		map.Insert(i, i);
+	}
+
+	EXPECT_EQ(100u, map.Size());
+	EXPECT_EQ(42, map.Get(42).value());
+}
+
+TEST(ConcurrentMap, UpdatesFromManyThreads) {
+	discpp::ConcurrentMap<int, int> map;
+	const int key_count = 64;
+	const int thread_count = 8;
+	const int increments = 2000;
+
+	for (int key = 0; key < key_count; key++) {
+		map.Insert(key, 0);
+	}
+
+	// Every thread increments every key, while others read and add and remove keys of their own.
+	std::vector<std::thread> threads;
+	for (int t = 0; t < thread_count; t++) {
+		threads.emplace_back([&, t] {
+			for (int i = 0; i < increments; i++) {
+				map.Update(i % key_count, [](int& value) { value++; });
+
+				int own_key = key_count + t;
+				map.InsertOrAssign(own_key, i);
+				EXPECT_TRUE(map.Get(i % key_count).has_value());
+				map.Erase(own_key);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(static_cast<size_t>(key_count), map.Size());
+	int total = 0;
+	map.ForEach([&](const int&, const int& value) { total += value; });
+	EXPECT_EQ(thread_count * increments, total);
+}
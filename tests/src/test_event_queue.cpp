@@ -0,0 +1,166 @@
+#include <discpp/event_queue.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Every test posts to one strand whose first event is held until the test releases it, so the events after it stay queued.
+class EventQueueTest : public ::testing::Test {
+protected:
+	discpp::ThreadPool pool { 2 };
+	discpp::StrandExecutor strands { pool };
+	discpp::EventQueues queues { strands };
+
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::atomic<bool> holding { false };
+	bool finished = false;
+
+	std::mutex mutex;
+	std::vector<std::string> ran;
+
+	void TearDown() override {
+		if (!finished) release.set_value();
+		queues.Stop();
+		pool.WaitIdle();
+	}
+
+	void Hold(discpp::GatewayEvent event) {
+		queues.Post(event, 1, 0, [this] {
+			holding = true;
+			released.wait();
+		});
+
+		while (!holding) std::this_thread::yield();
+	}
+
+	bool Post(discpp::GatewayEvent event, uint64_t object_key, const std::string& name) {
+		return queues.Post(event, 1, object_key, [this, name] {
+			std::lock_guard<std::mutex> lock(mutex);
+			ran.push_back(name);
+		});
+	}
+
+	std::vector<std::string> Finish() {
+		finished = true;
+		release.set_value();
+		pool.WaitIdle();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		return ran;
+	}
+};
+
+TEST_F(EventQueueTest, BlockWaitsForRoom) {
+	const discpp::GatewayEvent event = discpp::GatewayEvent::MESSAGE_CREATE;
+	queues.SetLimit(event, { 1, discpp::OverflowPolicy::BLOCK });
+
+	Hold(event);
+	EXPECT_TRUE(Post(event, 0, "a"));
+
+	std::atomic<bool> posted { false };
+	std::thread shard([&] {
+		Post(event, 0, "b");
+		posted = true;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_FALSE(posted);
+	EXPECT_EQ(1u, queues.GetStats(event).blocked);
+	EXPECT_EQ(1u, queues.GetStats(event).depth);
+
+	Finish();
+	shard.join();
+	pool.WaitIdle();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	EXPECT_TRUE(posted);
+	EXPECT_EQ(std::vector<std::string>({ "a", "b" }), ran);
+	EXPECT_EQ(0u, queues.GetStats(event).dropped);
+	EXPECT_EQ(0u, queues.GetStats(event).depth);
+}
+
+TEST_F(EventQueueTest, StopLetsBlockedShardsGo) {
+	const discpp::GatewayEvent event = discpp::GatewayEvent::MESSAGE_CREATE;
+	queues.SetLimit(event, { 1, discpp::OverflowPolicy::BLOCK });
+
+	Hold(event);
+	Post(event, 0, "a");
+
+	std::thread shard([&] { Post(event, 0, "b"); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+	queues.Stop();
+	shard.join();
+
+	EXPECT_EQ(std::vector<std::string>({ "a", "b" }), Finish());
+}
+
+TEST_F(EventQueueTest, DropOldestMakesRoom) {
+	const discpp::GatewayEvent event = discpp::GatewayEvent::TYPING_START;
+	queues.SetLimit(event, { 2, discpp::OverflowPolicy::DROP_OLDEST });
+
+	Hold(event);
+	EXPECT_TRUE(Post(event, 0, "a"));
+	EXPECT_TRUE(Post(event, 0, "b"));
+	EXPECT_TRUE(Post(event, 0, "c"));
+	EXPECT_TRUE(Post(event, 0, "d"));
+
+	discpp::EventQueueStats stats = queues.GetStats(event);
+	EXPECT_EQ(2u, stats.depth);
+	EXPECT_EQ(2u, stats.dropped);
+
+	EXPECT_EQ(std::vector<std::string>({ "c", "d" }), Finish());
+	EXPECT_EQ(0u, queues.GetStats(event).depth);
+}
+
+TEST_F(EventQueueTest, DropNewestRejectsEvent) {
+	const discpp::GatewayEvent event = discpp::GatewayEvent::TYPING_START;
+	queues.SetLimit(event, { 1, discpp::OverflowPolicy::DROP_NEWEST });
+
+	Hold(event);
+	EXPECT_TRUE(Post(event, 0, "a"));
+	EXPECT_FALSE(Post(event, 0, "b"));
+
+	EXPECT_EQ(1u, queues.GetStats(event).dropped);
+	EXPECT_EQ(std::vector<std::string>({ "a" }), Finish());
+}
+
+TEST_F(EventQueueTest, CoalesceReplacesQueuedEventOfSameObject) {
+	const discpp::GatewayEvent event = discpp::GatewayEvent::PRESENCE_UPDATE;
+	queues.SetLimit(event, { 2, discpp::OverflowPolicy::COALESCE });
+	ASSERT_TRUE(queues.Coalesces(event));
+
+	Hold(event);
+	EXPECT_TRUE(Post(event, 5, "user 5 online"));
+	EXPECT_TRUE(Post(event, 6, "user 6 online"));
+	EXPECT_TRUE(Post(event, 5, "user 5 idle"));
+
+	// A new object doesn't fit anymore, events without an object never coalesce.
+	EXPECT_FALSE(Post(event, 7, "user 7 online"));
+	EXPECT_FALSE(Post(event, 0, "no object"));
+
+	discpp::EventQueueStats stats = queues.GetStats(event);
+	EXPECT_EQ(1u, stats.coalesced);
+	EXPECT_EQ(2u, stats.dropped);
+	EXPECT_EQ(2u, stats.depth);
+
+	// The newer event keeps the place of the one it replaced.
+	EXPECT_EQ(std::vector<std::string>({ "user 5 idle", "user 6 online" }), Finish());
+}
+
+TEST_F(EventQueueTest, CoalesceAfterEventStartedQueuesAgain) {
+	const discpp::GatewayEvent event = discpp::GatewayEvent::PRESENCE_UPDATE;
+	queues.SetLimit(event, { 0, discpp::OverflowPolicy::COALESCE });
+
+	EXPECT_TRUE(Post(event, 5, "first"));
+	pool.WaitIdle();
+
+	EXPECT_TRUE(Post(event, 5, "second"));
+	EXPECT_EQ(0u, queues.GetStats(event).coalesced);
+	EXPECT_EQ(std::vector<std::string>({ "first", "second" }), Finish());
+}
@@ -0,0 +1,76 @@
+#include <discpp/gateway_codec.h>
+#include <discpp/exceptions.h>
+#include <discpp/utils.h>
+#include <gtest/gtest.h>
+#include <string>
+
+// {"op" => 0, "t" => :READY, "d" => {"id" => 150312037426135041 (small big), "ok" => true, "name" => <<"a">>, "x" => nil}}
+static const std::string etf_payload = std::string(
+	"\x83\x74\x00\x00\x00\x03"
+	"\x6d\x00\x00\x00\x02op" "\x61\x00"
+	"\x6d\x00\x00\x00\x01t" "\x77\x05READY"
+	"\x6d\x00\x00\x00\x01" "d" "\x74\x00\x00\x00\x04"
+		"\x6d\x00\x00\x00\x02id" "\x6e\x08\x00\x01\x00\x40\x6c\x00\x04\x16\x02"
+		"\x6d\x00\x00\x00\x02ok" "\x77\x04true"
+		"\x6d\x00\x00\x00\x04name" "\x6d\x00\x00\x00\x01" "a"
+		"\x77\x01x" "\x77\x03nil", 93);
+
+TEST(GatewayCodec, EtfDecode) {
+	discpp::EtfCodec codec;
+	std::unique_ptr<rapidjson::Document> document = codec.Decode(etf_payload);
+
+	EXPECT_EQ(0, (*document)["op"].GetInt());
+	EXPECT_EQ(std::string("READY"), (*document)["t"].GetString());
+	EXPECT_EQ(150312037426135041ULL, (*document)["d"]["id"].GetUint64());
+	EXPECT_EQ(discpp::Snowflake(150312037426135041ULL), discpp::GetSnowflake((*document)["d"]["id"]));
+	EXPECT_TRUE((*document)["d"]["ok"].GetBool());
+	EXPECT_EQ(std::string("a"), (*document)["d"]["name"].GetString());
+	EXPECT_TRUE((*document)["d"]["x"].IsNull());
+}
+
+TEST(GatewayCodec, EtfRoundTrip) {
+	discpp::JsonCodec json_codec;
+	discpp::EtfCodec etf_codec;
+
+	std::string json = R"({"op":2,"d":{"token":"abc","large_threshold":250,"shard":[1,2],"compress":false,"seq":null,"big":150312037426135041,"neg":-5,"f":1.5}})";
+	std::unique_ptr<rapidjson::Document> document = json_codec.Decode(json);
+	std::unique_ptr<rapidjson::Document> decoded = etf_codec.Decode(etf_codec.Encode(*document));
+
+	EXPECT_EQ(json, json_codec.Encode(*decoded));
+}
+
+TEST(GatewayCodec, EtfTruncated) {
+	discpp::EtfCodec codec;
+	EXPECT_THROW(codec.Decode(etf_payload.substr(0, 20)), discpp::exceptions::PayloadDecodeException);
+}
+
+TEST(GatewayCodec, EtfListLongerThanPayload) {
+	discpp::EtfCodec codec;
+
+	// A list and a tuple that claim about four billion elements, followed by a single one.
+	EXPECT_THROW(codec.Decode(std::string("\x83\x6c\xff\xff\xff\xff\x61\x00\x6a", 9)), discpp::exceptions::PayloadDecodeException);
+	EXPECT_THROW(codec.Decode(std::string("\x83\x69\xff\xff\xff\xff\x61\x00", 8)), discpp::exceptions::PayloadDecodeException);
+}
+
+TEST(GatewayCodec, JsonInvalid) {
+	discpp::JsonCodec codec;
+	EXPECT_THROW(codec.Decode("{not json"), discpp::exceptions::PayloadDecodeException);
+}
+
+TEST(GatewayCodec, JsonPeekHeader) {
+	discpp::JsonCodec codec;
+	discpp::PayloadHeader header;
+
+	// `d` comes first here so it has to be stepped over, including the brackets and quotes in its strings.
+	ASSERT_TRUE(codec.PeekHeader(R"({"d":{"content":"}]\" {","embeds":[{}]},"op":0,"s":42,"t":"PRESENCE_UPDATE"})", header));
+	EXPECT_EQ(0, header.op);
+	EXPECT_EQ(42, header.sequence);
+	EXPECT_EQ("PRESENCE_UPDATE", header.event_name);
+
+	ASSERT_TRUE(codec.PeekHeader(R"({"t":null,"s":null,"op":11,"d":null})", header));
+	EXPECT_EQ(11, header.op);
+	EXPECT_EQ(-1, header.sequence);
+	EXPECT_TRUE(header.event_name.empty());
+
+	EXPECT_FALSE(codec.PeekHeader(R"({"d":{"content":"cut off)", header));
+}
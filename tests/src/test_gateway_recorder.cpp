@@ -0,0 +1,52 @@
+#include <discpp/gateway_recorder.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static const char* recording_path = "test_gateway_recorder.dppgw";
+
+TEST(GatewayRecorder, RoundTrip) {
+	{
+		discpp::GatewayRecorder recorder(recording_path);
+		recorder.Record(0, 0, "{\"op\":10}");
+		recorder.Record(3, 1, std::string("\x78\x9c\x00", 3));
+		recorder.Flush();
+	}
+
+	discpp::GatewayRecordingReader reader(recording_path);
+	discpp::GatewayFrame frame;
+
+	ASSERT_TRUE(reader.Next(frame));
+	EXPECT_EQ(0, frame.shard_id);
+	EXPECT_EQ("{\"op\":10}", frame.data);
+
+	ASSERT_TRUE(reader.Next(frame));
+	EXPECT_EQ(3, frame.shard_id);
+	EXPECT_EQ(1, frame.flags);
+	EXPECT_EQ(std::string("\x78\x9c\x00", 3), frame.data);
+
+	EXPECT_FALSE(reader.Next(frame));
+	std::remove(recording_path);
+}
+
+TEST(GatewayRecorder, SizeLargerThanFileEndsLog) {
+	{
+		discpp::GatewayRecorder recorder(recording_path);
+		recorder.Record(0, 0, "{\"op\":10}");
+		recorder.Flush();
+	}
+
+	// A frame that claims to be about 2^63 bytes, followed by a few bytes of data.
+	{
+		std::ofstream file(recording_path, std::ios::out | std::ios::binary | std::ios::app);
+		file << std::string("\x00\x00\x00", 3) << std::string(9, '\xff') << '\x7f' << "abc";
+	}
+
+	discpp::GatewayRecordingReader reader(recording_path);
+	discpp::GatewayFrame frame;
+
+	ASSERT_TRUE(reader.Next(frame));
+	EXPECT_FALSE(reader.Next(frame));
+	std::remove(recording_path);
+}
@@ -0,0 +1,85 @@
+#include <discpp/gateway_send_queue.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Collects when every payload was sent, so the tests can look at the windows afterwards.
+class SentPayloads {
+public:
+	void Add(const std::string& payload) {
+		std::lock_guard<std::mutex> lock(mutex);
+		sent_at.push_back(std::chrono::steady_clock::now());
+		payloads.push_back(payload);
+		cv.notify_all();
+	}
+
+	bool WaitFor(size_t count, std::chrono::milliseconds timeout) {
+		std::unique_lock<std::mutex> lock(mutex);
+		return cv.wait_for(lock, timeout, [&] { return payloads.size() >= count; });
+	}
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::vector<std::chrono::steady_clock::time_point> sent_at;
+	std::vector<std::string> payloads;
+};
+
+// The window is shortened so the test doesn't take minutes, the limit is the one Discord uses.
+TEST(GatewaySendQueue, NoWindowExceedsLimit) {
+	const std::chrono::milliseconds window(200);
+	SentPayloads sent;
+	discpp::GatewaySendQueue queue([&](const std::string& payload) { sent.Add(payload); }, 120, window);
+
+	for (int i = 0; i < 300; i++) {
+		queue.Push(std::to_string(i));
+	}
+
+	ASSERT_TRUE(sent.WaitFor(300, std::chrono::seconds(10)));
+	queue.Stop();
+
+	std::lock_guard<std::mutex> lock(sent.mutex);
+	ASSERT_EQ(300u, sent.payloads.size());
+	for (size_t i = 0; i < 300; i++) {
+		EXPECT_EQ(std::to_string(i), sent.payloads[i]);
+	}
+
+	// The 121st command after any command has to be sent a whole window later.
+	for (size_t i = 0; i + 120 < sent.sent_at.size(); i++) {
+		EXPECT_GE(sent.sent_at[i + 120] - sent.sent_at[i], window) << "commands " << i << " to " << i + 120 << " fit in one window";
+	}
+}
+
+TEST(GatewaySendQueue, PriorityUsesReservedCommands) {
+	SentPayloads sent;
+	discpp::GatewaySendQueue queue([&](const std::string& payload) { sent.Add(payload); }, 10, std::chrono::seconds(60), 2);
+
+	for (int i = 0; i < 10; i++) {
+		queue.Push("normal");
+	}
+	ASSERT_TRUE(sent.WaitFor(8, std::chrono::seconds(5)));
+
+	queue.Push("heartbeat", discpp::GatewaySendLane::PRIORITY);
+	ASSERT_TRUE(sent.WaitFor(9, std::chrono::seconds(5)));
+
+	std::lock_guard<std::mutex> lock(sent.mutex);
+	EXPECT_EQ("heartbeat", sent.payloads[8]);
+	EXPECT_EQ(2u, queue.GetStats().depth);
+}
+
+TEST(GatewaySendQueue, CoalesceReplacesQueuedPayload) {
+	SentPayloads sent;
+	discpp::GatewaySendQueue queue([&](const std::string& payload) { sent.Add(payload); }, 1, std::chrono::seconds(60), 0);
+
+	queue.Push("first");
+	ASSERT_TRUE(sent.WaitFor(1, std::chrono::seconds(5)));
+
+	queue.Push("presence 1", discpp::GatewaySendLane::NORMAL, true);
+	queue.Push("presence 2", discpp::GatewaySendLane::NORMAL, true);
+
+	discpp::GatewaySendQueueStats stats = queue.GetStats();
+	EXPECT_EQ(1u, stats.depth);
+	EXPECT_EQ(1u, stats.coalesced);
+}
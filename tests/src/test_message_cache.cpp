@@ -0,0 +1,169 @@
+#include <discpp/message_cache.h>
+#include <discpp/message.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+static std::shared_ptr<discpp::Message> MakeMessage(uint64_t id, uint64_t channel_id, const std::string& content = "") {
+	auto message = std::make_shared<discpp::Message>();
+	message->id = discpp::Snowflake(id);
+	message->channel.id = discpp::Snowflake(channel_id);
+	message->content = content;
+
+	return message;
+}
+
+static std::vector<uint64_t> ChannelIds(const discpp::MessageCache& cache, uint64_t channel_id) {
+	std::vector<uint64_t> ids;
+	for (const auto& message : cache.GetChannelMessages(discpp::Snowflake(channel_id))) {
+		ids.push_back(static_cast<uint64_t>(message->id));
+	}
+
+	return ids;
+}
+
+TEST(MessageCache, ZeroCapacityCachesNothing) {
+	discpp::MessageCache cache(0);
+	cache.Insert(MakeMessage(1, 100));
+
+	EXPECT_EQ(0u, cache.Size());
+	EXPECT_EQ(nullptr, cache.Get(discpp::Snowflake(1)));
+}
+
+TEST(MessageCache, FullChannelDropsItsOldest) {
+	discpp::MessageCache cache(100, 3);
+	for (uint64_t id = 1; id <= 5; id++) {
+		cache.Insert(MakeMessage(id, 100));
+	}
+
+	EXPECT_EQ(3u, cache.Size());
+	EXPECT_FALSE(cache.Contains(discpp::Snowflake(1)));
+	EXPECT_FALSE(cache.Contains(discpp::Snowflake(2)));
+	EXPECT_EQ(std::vector<uint64_t>({ 3, 4, 5 }), ChannelIds(cache, 100));
+}
+
+TEST(MessageCache, FullCacheDropsFromLeastRecentChannel) {
+	discpp::MessageCache cache(4, 10);
+	cache.Insert(MakeMessage(1, 100));
+	cache.Insert(MakeMessage(2, 100));
+	cache.Insert(MakeMessage(3, 200));
+	cache.Insert(MakeMessage(4, 100));
+
+	// Channel 200 received a message longest ago, so it makes room even though channel 100 has older messages.
+	cache.Insert(MakeMessage(5, 300));
+
+	EXPECT_EQ(4u, cache.Size());
+	EXPECT_FALSE(cache.Contains(discpp::Snowflake(3)));
+	EXPECT_TRUE(cache.GetChannelMessages(discpp::Snowflake(200)).empty());
+	EXPECT_EQ(std::vector<uint64_t>({ 1, 2, 4 }), ChannelIds(cache, 100));
+
+	cache.Insert(MakeMessage(6, 300));
+	EXPECT_FALSE(cache.Contains(discpp::Snowflake(1)));
+	EXPECT_EQ(std::vector<uint64_t>({ 5, 6 }), ChannelIds(cache, 300));
+}
+
+TEST(MessageCache, InsertReplacesInPlace) {
+	discpp::MessageCache cache(10, 10);
+	cache.Insert(MakeMessage(1, 100, "old"));
+	cache.Insert(MakeMessage(2, 100));
+	cache.Insert(MakeMessage(1, 100, "new"));
+
+	EXPECT_EQ(2u, cache.Size());
+	EXPECT_EQ("new", cache.Get(discpp::Snowflake(1))->content);
+	EXPECT_EQ(std::vector<uint64_t>({ 1, 2 }), ChannelIds(cache, 100));
+}
+
+TEST(MessageCache, UpdateReplacesWithCopy) {
+	discpp::MessageCache cache(10, 10);
+	cache.Insert(MakeMessage(1, 100, "old"));
+	std::shared_ptr<discpp::Message> before = cache.Get(discpp::Snowflake(1));
+
+	std::shared_ptr<discpp::Message> after = cache.Update(discpp::Snowflake(1), [](discpp::Message& message) {
+		message.content = "edited";
+	});
+
+	ASSERT_NE(nullptr, after);
+	EXPECT_EQ("old", before->content);
+	EXPECT_EQ("edited", cache.Get(discpp::Snowflake(1))->content);
+	EXPECT_EQ(nullptr, cache.Update(discpp::Snowflake(2), [](discpp::Message&) {}));
+}
+
+TEST(MessageCache, EraseKeepsPositions) {
+	discpp::MessageCache cache(10, 10);
+	for (uint64_t id = 1; id <= 5; id++) {
+		cache.Insert(MakeMessage(id, 100));
+	}
+
+	EXPECT_NE(nullptr, cache.Erase(discpp::Snowflake(3)));
+	EXPECT_EQ(nullptr, cache.Erase(discpp::Snowflake(3)));
+	EXPECT_NE(nullptr, cache.Erase(discpp::Snowflake(1)));
+	EXPECT_NE(nullptr, cache.Erase(discpp::Snowflake(5)));
+
+	// The messages after a removed one can still be found.
+	EXPECT_EQ(2u, cache.Size());
+	EXPECT_TRUE(cache.Contains(discpp::Snowflake(2)));
+	EXPECT_TRUE(cache.Contains(discpp::Snowflake(4)));
+	EXPECT_EQ(std::vector<uint64_t>({ 2, 4 }), ChannelIds(cache, 100));
+
+	cache.Insert(MakeMessage(6, 100));
+	EXPECT_EQ(std::vector<uint64_t>({ 2, 4, 6 }), ChannelIds(cache, 100));
+
+	cache.Erase(discpp::Snowflake(2));
+	cache.Erase(discpp::Snowflake(4));
+	cache.Erase(discpp::Snowflake(6));
+	EXPECT_EQ(0u, cache.Size());
+	EXPECT_TRUE(cache.GetChannelMessages(discpp::Snowflake(100)).empty());
+}
+
+TEST(MessageCache, EraseThenEvict) {
+	discpp::MessageCache cache(3, 10);
+	cache.Insert(MakeMessage(1, 100));
+	cache.Insert(MakeMessage(2, 100));
+	cache.Insert(MakeMessage(3, 100));
+	cache.Erase(discpp::Snowflake(2));
+
+	cache.Insert(MakeMessage(4, 100));
+	cache.Insert(MakeMessage(5, 100));
+
+	EXPECT_EQ(3u, cache.Size());
+	EXPECT_EQ(std::vector<uint64_t>({ 3, 4, 5 }), ChannelIds(cache, 100));
+}
+
+TEST(MessageCache, SetCapacityShrinks) {
+	discpp::MessageCache cache(10, 10);
+	for (uint64_t id = 1; id <= 6; id++) {
+		cache.Insert(MakeMessage(id, 100));
+	}
+	for (uint64_t id = 7; id <= 9; id++) {
+		cache.Insert(MakeMessage(id, 200));
+	}
+
+	cache.SetCapacity(10, 4);
+	EXPECT_EQ(7u, cache.Size());
+	EXPECT_EQ(std::vector<uint64_t>({ 3, 4, 5, 6 }), ChannelIds(cache, 100));
+
+	// Channel 100 is the least recent one, so it's emptied first.
+	cache.SetCapacity(3, 4);
+	EXPECT_EQ(3u, cache.Size());
+	EXPECT_TRUE(cache.GetChannelMessages(discpp::Snowflake(100)).empty());
+	EXPECT_EQ(std::vector<uint64_t>({ 7, 8, 9 }), ChannelIds(cache, 200));
+
+	cache.SetCapacity(0, 4);
+	EXPECT_EQ(0u, cache.Size());
+	cache.Insert(MakeMessage(10, 100));
+	EXPECT_EQ(0u, cache.Size());
+}
+
+TEST(MessageCache, Clear) {
+	discpp::MessageCache cache(10, 10);
+	cache.Insert(MakeMessage(1, 100));
+	cache.Insert(MakeMessage(2, 200));
+	cache.Clear();
+
+	EXPECT_EQ(0u, cache.Size());
+	EXPECT_FALSE(cache.Contains(discpp::Snowflake(1)));
+
+	cache.Insert(MakeMessage(3, 100));
+	EXPECT_EQ(1u, cache.Size());
+}
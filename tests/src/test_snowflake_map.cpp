@@ -0,0 +1,183 @@
+#include <discpp/snowflake_map.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+using Value = std::shared_ptr<std::string>;
+using Reference = std::unordered_map<uint64_t, Value>;
+
+// Compares every entry both ways, and checks iterating visits each entry once.
+static void ExpectSame(const discpp::SnowflakeMap<Value>& map, const Reference& reference) {
+	ASSERT_EQ(reference.size(), map.size());
+
+	size_t visited = 0;
+	for (const auto& entry : map) {
+		auto it = reference.find(entry.first);
+		ASSERT_NE(reference.end(), it);
+		EXPECT_EQ(it->second, entry.second);
+		visited++;
+	}
+	EXPECT_EQ(reference.size(), visited);
+
+	for (const auto& entry : reference) {
+		auto it = map.find(discpp::Snowflake(entry.first));
+		ASSERT_NE(map.end(), it);
+		EXPECT_EQ(entry.second, it->second);
+	}
+}
+
+TEST(SnowflakeMap, Basics) {
+	discpp::SnowflakeMap<int> map;
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.end(), map.begin());
+	EXPECT_EQ(map.end(), map.find(5));
+
+	map[5] = 3;
+	EXPECT_EQ(3, map.at(5));
+	EXPECT_EQ(1u, map.count(5));
+	EXPECT_FALSE(map.contains(6));
+	EXPECT_THROW(map.at(6), std::out_of_range);
+
+	EXPECT_FALSE(map.insert({ 5, 4 }).second);
+	EXPECT_EQ(3, map.at(5));
+	EXPECT_FALSE(map.insert_or_assign(5, 4).second);
+	EXPECT_EQ(4, map.at(5));
+
+	map.clear();
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.end(), map.find(5));
+}
+
+TEST(SnowflakeMap, MatchesUnorderedMap) {
+	std::mt19937_64 rng(1);
+	discpp::SnowflakeMap<Value> map;
+	Reference reference;
+
+	// Keys are built like snowflakes, which mostly differ in their timestamp bits.
+	for (int step = 0; step < 200000; step++) {
+		uint64_t key = (rng() % 5000) << 22 | (rng() % 3);
+
+		switch (rng() % 5) {
+		case 0:
+		case 1: {
+			Value value = std::make_shared<std::string>(std::to_string(key));
+			ASSERT_EQ(reference.insert({ key, value }).second, map.insert({ key, value }).second);
+			break;
+		} case 2:
+			ASSERT_EQ(reference.erase(key), map.erase(key));
+			break;
+		case 3: {
+			auto it = map.find(key);
+			auto expected = reference.find(key);
+			ASSERT_EQ(expected == reference.end(), it == map.end());
+			if (it != map.end()) {
+				EXPECT_EQ(expected->second, it->second);
+			}
+			break;
+		} case 4: {
+			Value value = std::make_shared<std::string>("assigned");
+			map.insert_or_assign(key, value);
+			reference.insert_or_assign(key, value);
+			break;
+		}
+		}
+		ASSERT_EQ(reference.size(), map.size());
+
+		if (step % 20000 == 0) ExpectSame(map, reference);
+	}
+
+	ExpectSame(map, reference);
+}
+
+TEST(SnowflakeMap, EraseWhileIterating) {
+	std::mt19937_64 rng(2);
+	discpp::SnowflakeMap<Value> map;
+	Reference reference;
+
+	for (int i = 0; i < 20000; i++) {
+		uint64_t key = rng() % 100000 << 22;
+		Value value = std::make_shared<std::string>(std::to_string(key));
+		map.insert({ key, value });
+		reference.insert({ key, value });
+	}
+
+	// Every entry is still visited exactly once while the ones before it are removed.
+	const size_t size = map.size();
+	size_t visited = 0;
+	for (auto it = map.begin(); it != map.end();) {
+		visited++;
+		if (static_cast<uint64_t>(it->first) >> 22 & 1) {
+			it = map.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (auto it = reference.begin(); it != reference.end();) {
+		if (it->first >> 22 & 1) {
+			it = reference.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	EXPECT_EQ(size, visited);
+	ExpectSame(map, reference);
+
+	// Removing everything leaves a map that can be filled again.
+	for (auto it = map.begin(); it != map.end();) it = map.erase(it);
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.end(), map.begin());
+	map.insert({ 1, nullptr });
+	EXPECT_EQ(1u, map.size());
+}
+
+TEST(SnowflakeMap, CopyAndMove) {
+	std::mt19937_64 rng(3);
+	discpp::SnowflakeMap<Value> map;
+	Reference reference;
+
+	for (int i = 0; i < 5000; i++) {
+		uint64_t key = rng() % 10000 << 22;
+		Value value = std::make_shared<std::string>(std::to_string(key));
+		map.insert({ key, value });
+		reference.insert({ key, value });
+		if (i % 3 == 0) {
+			map.erase(key);
+			reference.erase(key);
+		}
+	}
+
+	discpp::SnowflakeMap<Value> copy = map;
+	ExpectSame(copy, reference);
+
+	// The copy is separate, changing it leaves the original as it was.
+	Reference copy_reference = reference;
+	for (auto it = copy.begin(); it != copy.end();) {
+		if (static_cast<uint64_t>(it->first) >> 22 & 1) {
+			copy_reference.erase(it->first);
+			it = copy.erase(it);
+		} else {
+			++it;
+		}
+	}
+	copy.insert({ 1, nullptr });
+	copy_reference.insert({ 1, nullptr });
+	ExpectSame(copy, copy_reference);
+	ExpectSame(map, reference);
+
+	map = copy;
+	ExpectSame(map, copy_reference);
+
+	discpp::SnowflakeMap<Value> moved = std::move(copy);
+	ExpectSame(moved, copy_reference);
+
+	discpp::SnowflakeMap<Value> empty;
+	map = empty;
+	EXPECT_TRUE(map.empty());
+	map = std::move(moved);
+	ExpectSame(map, copy_reference);
+}
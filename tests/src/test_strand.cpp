@@ -0,0 +1,85 @@
+#include <discpp/strand.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(StrandExecutor, RunsTasksOfAStrandInOrder) {
+	discpp::ThreadPool pool(4);
+	discpp::StrandExecutor strands(pool, 8);
+
+	const int strand_count = 8;
+	const int tasks_per_strand = 500;
+
+	std::vector<std::vector<int>> ran(strand_count);
+	std::vector<std::atomic<int>> running(strand_count);
+	std::atomic<int> overlaps { 0 };
+
+	// Interleave the strands, so every worker has tasks of several of them.
+	for (int i = 0; i < tasks_per_strand; i++) {
+		for (int key = 0; key < strand_count; key++) {
+			strands.Post(key, [&, key, i] {
+				if (running[key]++ != 0) overlaps++;
+				ran[key].push_back(i);
+				running[key]--;
+			});
+		}
+	}
+	pool.WaitIdle();
+
+	EXPECT_EQ(0, overlaps);
+	for (int key = 0; key < strand_count; key++) {
+		ASSERT_EQ(static_cast<size_t>(tasks_per_strand), ran[key].size());
+		for (int i = 0; i < tasks_per_strand; i++) {
+			EXPECT_EQ(i, ran[key][i]);
+		}
+	}
+	EXPECT_EQ(0u, strands.GetStrandCount());
+}
+
+TEST(StrandExecutor, StrandsRunInParallel) {
+	discpp::ThreadPool pool(2);
+	discpp::StrandExecutor strands(pool);
+
+	std::atomic<int> started { 0 };
+	std::atomic<bool> both_started { false };
+
+	// Each task waits for the other, which only works if they run at the same time.
+	for (uint64_t key = 1; key <= 2; key++) {
+		strands.Post(key, [&] {
+			started++;
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+			while (started < 2 && std::chrono::steady_clock::now() < deadline) {
+				std::this_thread::yield();
+			}
+			if (started == 2) both_started = true;
+		});
+	}
+	pool.WaitIdle();
+
+	EXPECT_TRUE(both_started);
+}
+
+TEST(StrandExecutor, TasksPostedFromAStrandRunAfterIt) {
+	discpp::ThreadPool pool(4);
+	discpp::StrandExecutor strands(pool, 1);
+
+	std::mutex mutex;
+	std::vector<int> ran;
+
+	strands.Post(7, [&] {
+		strands.Post(7, [&] {
+			std::lock_guard<std::mutex> lock(mutex);
+			ran.push_back(2);
+		});
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		std::lock_guard<std::mutex> lock(mutex);
+		ran.push_back(1);
+	});
+	pool.WaitIdle();
+
+	EXPECT_EQ(std::vector<int>({ 1, 2 }), ran);
+}
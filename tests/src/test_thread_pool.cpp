@@ -0,0 +1,111 @@
+#include <discpp/thread_pool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+// Spins until the condition holds or a second has passed.
+template<typename F>
+static bool WaitUntil(F&& condition) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	while (!condition()) {
+		if (std::chrono::steady_clock::now() > deadline) return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+TEST(ThreadPool, SubmitRunsEveryTask) {
+	discpp::ThreadPool pool(4);
+	std::atomic<int> ran { 0 };
+
+	for (int i = 0; i < 1000; i++) {
+		pool.Submit([&] { ran++; });
+	}
+	pool.WaitIdle();
+
+	EXPECT_EQ(1000, ran);
+	EXPECT_EQ(1000u, pool.GetStats().completed);
+	EXPECT_EQ(0u, pool.GetStats().queued);
+}
+
+TEST(ThreadPool, WaitIdleWaitsForNestedTasks) {
+	discpp::ThreadPool pool(2);
+	std::atomic<int> ran { 0 };
+
+	pool.Submit([&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		pool.Submit([&] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			ran++;
+		});
+		ran++;
+	});
+	pool.WaitIdle();
+
+	EXPECT_EQ(2, ran);
+}
+
+TEST(ThreadPool, IdleWorkerStealsTasks) {
+	discpp::ThreadPool pool(2);
+	std::atomic<int> ran { 0 };
+	std::atomic<bool> all_ran { false };
+
+	// Tasks submitted by a worker go on its own queue, so while it's busy only the other worker can run them.
+	pool.Submit([&] {
+		for (int i = 0; i < 10; i++) {
+			pool.Submit([&] { ran++; });
+		}
+		all_ran = WaitUntil([&] { return ran == 10; });
+	});
+	pool.WaitIdle();
+
+	EXPECT_TRUE(all_ran);
+	EXPECT_EQ(10u, pool.GetStats().stolen);
+}
+
+TEST(ThreadPool, StopRunsQueuedTasks) {
+	discpp::ThreadPool pool(1);
+	std::atomic<int> ran { 0 };
+
+	pool.Submit([] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+	for (int i = 0; i < 10; i++) {
+		pool.Submit([&] { ran++; });
+	}
+	pool.Stop();
+
+	EXPECT_EQ(10, ran);
+
+	// Stopped pools drop new tasks.
+	pool.Submit([&] { ran++; });
+	EXPECT_EQ(10, ran);
+	EXPECT_EQ(0u, pool.GetStats().queued);
+}
+
+TEST(ThreadPool, StopFromTask) {
+	std::atomic<int> ran { 0 };
+	{
+		discpp::ThreadPool pool(2);
+		pool.Submit([&] {
+			pool.Stop();
+			ran++;
+		});
+		ASSERT_TRUE(WaitUntil([&] { return ran == 1; }));
+	}
+
+	// The destructor joined the worker that stopped the pool, nothing is left running.
+	EXPECT_EQ(1, ran);
+}
+
+TEST(ThreadPool, ErrorHandlerGetsExceptions) {
+	std::atomic<int> errors { 0 };
+	discpp::ThreadPool pool(2, [&](std::exception_ptr) { errors++; });
+
+	pool.Submit([] { throw std::runtime_error("task failed"); });
+	pool.Submit([] {});
+	pool.WaitIdle();
+
+	EXPECT_EQ(1, errors);
+	EXPECT_EQ(2u, pool.GetStats().completed);
+}
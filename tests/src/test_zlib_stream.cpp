@@ -0,0 +1,59 @@
+#include <discpp/zlib_stream.h>
+#include <discpp/exceptions.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <string>
+
+class ZlibStreamTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		deflateInit(&deflate_stream, Z_DEFAULT_COMPRESSION);
+	}
+
+	void TearDown() override {
+		deflateEnd(&deflate_stream);
+	}
+
+	// Compresses a payload the same way the gateway does, ending it with a Z_SYNC_FLUSH.
+	std::string Compress(const std::string& payload) {
+		std::string out(deflateBound(&deflate_stream, payload.size()) + 16, '\0');
+		deflate_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(payload.data()));
+		deflate_stream.avail_in = static_cast<uInt>(payload.size());
+		deflate_stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+		deflate_stream.avail_out = static_cast<uInt>(out.size());
+		deflate(&deflate_stream, Z_SYNC_FLUSH);
+		out.resize(out.size() - deflate_stream.avail_out);
+		return out;
+	}
+
+	z_stream deflate_stream{};
+};
+
+TEST_F(ZlibStreamTest, InflatesSequentialMessages) {
+	discpp::ZlibStream stream;
+	std::string buffer;
+
+	EXPECT_TRUE(stream.Feed(Compress("{\"op\":10}"), buffer));
+	EXPECT_EQ("{\"op\":10}", buffer);
+	EXPECT_TRUE(stream.Feed(Compress("{\"op\":11}"), buffer));
+	EXPECT_EQ("{\"op\":11}", buffer);
+}
+
+TEST_F(ZlibStreamTest, WaitsForSyncFlushSuffix) {
+	discpp::ZlibStream stream;
+	std::string buffer;
+
+	std::string payload(100000, 'a');
+	std::string compressed = Compress(payload);
+
+	EXPECT_FALSE(stream.Feed(compressed.substr(0, compressed.size() / 2), buffer));
+	EXPECT_TRUE(stream.Feed(compressed.substr(compressed.size() / 2), buffer));
+	EXPECT_EQ(payload, buffer);
+}
+
+TEST_F(ZlibStreamTest, ThrowsOnCorruptData) {
+	discpp::ZlibStream stream;
+	std::string buffer;
+
+	EXPECT_THROW(stream.Feed(std::string("garbage\x00\x00\xff\xff", 11), buffer), discpp::exceptions::DecompressionException);
+}